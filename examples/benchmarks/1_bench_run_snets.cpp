@@ -0,0 +1,77 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.7
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: April 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <chrono>
+
+#include "eddl/apis/eddl.h"
+
+
+using namespace eddl;
+using namespace std::chrono;
+
+//////////////////////////////////
+// bench_run_snets.cpp:
+// Step latency of a small MLP
+// dispatching snets with one thread
+// per call vs. the worker pool
+//////////////////////////////////
+
+double time_steps(model net, Tensor *x, Tensor *y, int batch_size, int steps) {
+    vector<int> indices(batch_size);
+    for (int i = 0; i < batch_size; i++) indices[i] = i;
+
+    // Warm up
+    for (int i = 0; i < 10; i++) train_batch(net, {x}, {y}, indices);
+
+    high_resolution_clock::time_point t1 = high_resolution_clock::now();
+    for (int i = 0; i < steps; i++) train_batch(net, {x}, {y}, indices);
+    high_resolution_clock::time_point t2 = high_resolution_clock::now();
+
+    duration<double> span = t2 - t1;
+    return span.count() / steps;
+}
+
+int main(int argc, char **argv) {
+    int batch_size = 32;
+    int steps = 500;
+    if (argc > 1) steps = atoi(argv[1]);
+
+    // Small net: thread management is a visible part of the step
+    layer in = Input({64});
+    layer l = in;
+    l = ReLu(Dense(l, 64));
+    l = ReLu(Dense(l, 64));
+    layer out = Softmax(Dense(l, 10));
+    model net = Model({in}, {out});
+
+    compserv cs = CS_CPU();
+    build(net, sgd(0.01, 0.9), {"soft_cross_entropy"}, {"categorical_accuracy"}, cs);
+
+    Tensor *x = Tensor::randn({batch_size, 64});
+    Tensor *y = Tensor::zeros({batch_size, 10});
+    for (int i = 0; i < batch_size; i++) y->ptr[i * 10 + (i % 10)] = 1.0f;
+
+    cs->persistent_workers = false;
+    double t_spawn = time_steps(net, x, y, batch_size, steps);
+
+    cs->persistent_workers = true;
+    double t_pool = time_steps(net, x, y, batch_size, steps);
+
+    fprintf(stdout, "\n%d steps, batch %d\n", steps, batch_size);
+    fprintf(stdout, "pthread per call: %8.1f us/step\n", t_spawn * 1e6);
+    fprintf(stdout, "worker pool:      %8.1f us/step\n", t_pool * 1e6);
+    fprintf(stdout, "speedup:          %8.2fx\n", t_spawn / t_pool);
+
+    delete x;
+    delete y;
+    delete net;
+}
@@ -0,0 +1,114 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.7
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: April 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <cstring>
+#include <chrono>
+
+#include "eddl/tensor/tensor.h"
+#include "eddl/tensor/nn/tensor_nn.h"
+#include "eddl/descriptors/descriptors.h"
+
+
+using namespace std::chrono;
+
+//////////////////////////////////
+// bench_conv_algos.cpp:
+// Forward time of each CPU conv
+// algorithm on the shapes of the
+// cifar10 VGG/ResNet examples and
+// MobileNet-like depthwise layers.
+// Usage: bench_conv_algos [reps] [out.csv]
+//////////////////////////////////
+
+struct conv_shape {
+    int channels, rows, cols, filters, kernel;
+    int groups;
+};
+
+const char *algo_name(int algo) {
+    if (algo == CONV_ALGO_GEMM1X1) return "gemm1x1";
+    if (algo == CONV_ALGO_WINOGRAD) return "winograd";
+    if (algo == CONV_ALGO_DEPTHWISE) return "depthwise";
+    return "im2col";
+}
+
+double time_algo(ConvolDescriptor *cd, int algo, int reps) {
+    cd->algo = algo;
+    tensorNN::Conv2D(cd);  // Warm up (workspace, transformed kernels)
+
+    high_resolution_clock::time_point t1 = high_resolution_clock::now();
+    for (int i = 0; i < reps; i++) tensorNN::Conv2D(cd);
+    high_resolution_clock::time_point t2 = high_resolution_clock::now();
+
+    duration<double> span = t2 - t1;
+    return span.count() / reps;
+}
+
+int main(int argc, char **argv) {
+    int batch = 32;
+    int reps = 10;
+    if (argc > 1) reps = atoi(argv[1]);
+
+    FILE *fcsv = nullptr;
+    if (argc > 2) {
+        fcsv = fopen(argv[2], "wt");
+        if (fcsv == nullptr) { fprintf(stderr, "cannot open %s\n", argv[2]); return 1; }
+        fprintf(fcsv, "channels,rows,cols,filters,kernel,groups,im2col_ms,direct_ms,direct,best\n");
+    }
+
+    vector<conv_shape> shapes = {
+            {3,   32, 32, 64,  3, 1},
+            {64,  32, 32, 64,  3, 1},
+            {128, 16, 16, 128, 3, 1},
+            {256, 8,  8,  256, 3, 1},
+            {512, 4,  4,  512, 3, 1},
+            {64,  32, 32, 256, 1, 1},
+            {256, 32, 32, 64,  1, 1},
+            {128, 16, 16, 512, 1, 1},
+            {32,  56, 56, 32,  3, 32},
+            {144, 28, 28, 144, 3, 144},
+            {512, 7,  7,  512, 3, 512},
+    };
+
+    fprintf(stdout, "\nbatch %d, %d reps\n", batch, reps);
+    fprintf(stdout, "%-22s %12s %12s %-10s %s\n", "shape (CxHxW->F,k)", "im2col (ms)", "direct (ms)", "direct", "best");
+
+    for (auto &s : shapes) {
+        Tensor *x = Tensor::randn({batch, s.channels, s.rows, s.cols});
+        auto *cd = new ConvolDescriptor(s.filters, {s.kernel, s.kernel}, {1, 1}, "same", true, s.groups, {1, 1});
+        cd->build(x);
+        cd->K->rand_normal(0.0f, 0.1f);
+        cd->bias->fill_(0.0f);
+
+        // Specialized path for the shape regardless of the channel heuristic
+        int direct = CONV_ALGO_WINOGRAD;
+        if (s.groups > 1) direct = CONV_ALGO_DEPTHWISE;
+        else if (s.kernel == 1) direct = CONV_ALGO_GEMM1X1;
+        int selected = cd->algo;
+
+        double t_im2col = time_algo(cd, CONV_ALGO_IM2COL, reps);
+        double t_direct = time_algo(cd, direct, reps);
+        const char *best = (t_direct < t_im2col) ? algo_name(direct) : algo_name(CONV_ALGO_IM2COL);
+
+        char name[64];
+        snprintf(name, sizeof(name), "%dx%dx%d->%d,%d%s", s.channels, s.rows, s.cols, s.filters, s.kernel, (s.groups > 1) ? ",dw" : "");
+        fprintf(stdout, "%-22s %12.3f %12.3f %-10s %s%s\n", name, t_im2col * 1e3, t_direct * 1e3,
+                algo_name(direct), best, (strcmp(best, algo_name(selected)) != 0) ? " (not selected)" : "");
+        if (fcsv != nullptr)
+            fprintf(fcsv, "%d,%d,%d,%d,%d,%d,%f,%f,%s,%s\n", s.channels, s.rows, s.cols, s.filters, s.kernel, s.groups,
+                    t_im2col * 1e3, t_direct * 1e3, algo_name(direct), best);
+
+        delete x;
+    }
+
+    if (fcsv != nullptr) fclose(fcsv);
+}
@@ -0,0 +1,141 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.7
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: April 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <chrono>
+
+#include "eddl/apis/eddl.h"
+#include "eddl/hardware/cpu/cpu_allocator.h"
+
+
+using namespace eddl;
+using namespace std::chrono;
+
+//////////////////////////////////
+// bench_frozen_inference.cpp:
+// Forward latency and memory of the
+// mnist and cifar10 example models,
+// built for training vs. frozen
+// for inference.
+// Usage: bench_frozen_inference [reps]
+//////////////////////////////////
+
+layer ResBlock(layer l, int filters, int half) {
+    layer in = l;
+    l = ReLu(BatchNormalization(Conv(l, filters, {3, 3}, {half ? 2 : 1, half ? 2 : 1})));
+    l = ReLu(BatchNormalization(Conv(l, filters, {3, 3}, {1, 1})));
+    if (half) return Sum(BatchNormalization(Conv(in, filters, {1, 1}, {2, 2})), l);
+    return Sum(l, in);
+}
+
+model mnist_mlp() {
+    layer in = Input({784});
+    layer l = in;
+    l = LeakyReLu(Dense(l, 1024));
+    l = LeakyReLu(Dense(l, 1024));
+    l = LeakyReLu(Dense(l, 1024));
+    layer out = Softmax(Dense(l, 10));
+    return Model({in}, {out});
+}
+
+model mnist_conv() {
+    layer in = Input({784});
+    layer l = Reshape(in, {1, 28, 28});
+    l = MaxPool(ReLu(Conv(l, 32, {3, 3}, {1, 1})), {3, 3}, {1, 1}, "same");
+    l = MaxPool(ReLu(Conv(l, 64, {3, 3}, {1, 1})), {2, 2}, {2, 2}, "same");
+    l = MaxPool(ReLu(Conv(l, 128, {3, 3}, {1, 1})), {3, 3}, {2, 2}, "none");
+    l = MaxPool(ReLu(Conv(l, 256, {3, 3}, {1, 1})), {2, 2}, {2, 2}, "none");
+    l = Reshape(l, {-1});
+    layer out = Activation(Dense(l, 10), "softmax");
+    return Model({in}, {out});
+}
+
+model cifar_conv() {
+    layer in = Input({3, 32, 32});
+    layer l = ReLu(Conv(in, 32, {3, 3}, {1, 1}));
+    l = Flatten(l);
+    l = Activation(Dense(l, 128), "relu");
+    layer out = Activation(Dense(l, 10), "softmax");
+    return Model({in}, {out});
+}
+
+model cifar_resnet_bn() {
+    layer in = Input({3, 32, 32});
+    layer l = ReLu(BatchNormalization(Conv(in, 64, {3, 3}, {1, 1})));
+    l = ResBlock(l, 64, 1);
+    l = ResBlock(l, 64, 0);
+    l = ResBlock(l, 128, 1);
+    l = ResBlock(l, 128, 0);
+    l = ResBlock(l, 256, 1);
+    l = ResBlock(l, 256, 0);
+    l = Reshape(l, {-1});
+    l = Activation(Dense(l, 512), "relu");
+    layer out = Activation(Dense(l, 10), "softmax");
+    return Model({in}, {out});
+}
+
+double time_forward(model net, Tensor *x, int reps) {
+    forward(net, {x});  // Warm up (resize, workspaces)
+
+    high_resolution_clock::time_point t1 = high_resolution_clock::now();
+    for (int i = 0; i < reps; i++) forward(net, {x});
+    high_resolution_clock::time_point t2 = high_resolution_clock::now();
+
+    duration<double> span = t2 - t1;
+    return span.count() / reps;
+}
+
+int main(int argc, char **argv) {
+    int reps = 20;
+    if (argc > 1) reps = atoi(argv[1]);
+
+    struct {
+        const char *name;
+        model (*create)();
+        vector<int> shape;
+    } models[] = {
+            {"mnist_mlp",       mnist_mlp,       {784}},
+            {"mnist_conv",      mnist_conv,      {784}},
+            {"cifar_conv",      cifar_conv,      {3, 32, 32}},
+            {"cifar_resnet_bn", cifar_resnet_bn, {3, 32, 32}},
+    };
+
+    fprintf(stdout, "\n%d reps, one thread\n", reps);
+    fprintf(stdout, "%-16s %6s %12s %12s %8s %12s %12s\n", "model", "batch", "train (ms)", "frozen (ms)", "speedup",
+            "train mem", "frozen mem");
+
+    for (auto &m : models) {
+        for (int batch : {1, 32}) {
+            model net = m.create();
+            build(net, adam(0.001), {"soft_cross_entropy"}, {"categorical_accuracy"}, CS_CPU(1, "low_mem"));
+            set_mode(net, TSMODE);
+
+            vector<int> shape = m.shape;
+            shape.insert(shape.begin(), batch);
+            Tensor *x = Tensor::randn(shape);
+
+            double t_train = time_forward(net, x, reps);
+            long mem_train = fmem_stats().bytes_in_use;
+
+            freeze(net);
+            double t_frozen = time_forward(net, x, reps);
+            long mem_frozen = fmem_stats().bytes_in_use;
+
+            fprintf(stdout, "%-16s %6d %12.3f %12.3f %7.2fx %12s %12s\n", m.name, batch, t_train * 1e3,
+                    t_frozen * 1e3, t_train / t_frozen, bytes2human(mem_train).c_str(),
+                    bytes2human(mem_frozen).c_str());
+
+            delete x;
+            delete net;
+            fmem_trim();
+        }
+    }
+}
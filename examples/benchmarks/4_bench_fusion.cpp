@@ -0,0 +1,106 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.7
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: April 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <chrono>
+
+#include "eddl/apis/eddl.h"
+
+
+using namespace eddl;
+using namespace std::chrono;
+
+//////////////////////////////////
+// bench_fusion.cpp:
+// Training step and frozen forward
+// of conv nets with the activations
+// (and, frozen, the batchnorms)
+// computed by their Conv/Dense
+// layer or as layers of their own.
+// Usage: bench_fusion [reps] [threads]
+//////////////////////////////////
+
+model conv_relu() {
+    layer in = Input({3, 32, 32});
+    layer l = in;
+    for (int f : {32, 64, 128}) {
+        l = ReLu(Conv(l, f, {3, 3}, {1, 1}));
+        l = MaxPool(ReLu(Conv(l, f, {3, 3}, {1, 1})), {2, 2});
+    }
+    l = Reshape(l, {-1});
+    l = ReLu(Dense(l, 256));
+    layer out = Softmax(Dense(l, 10));
+    return Model({in}, {out});
+}
+
+model conv_bn_relu() {
+    layer in = Input({3, 32, 32});
+    layer l = in;
+    for (int f : {32, 64, 128}) {
+        l = ReLu(BatchNormalization(Conv(l, f, {3, 3}, {1, 1}, "same", false)));
+        l = MaxPool(ReLu(BatchNormalization(Conv(l, f, {3, 3}, {1, 1}, "same", false))), {2, 2});
+    }
+    l = Reshape(l, {-1});
+    l = ReLu(BatchNormalization(Dense(l, 256)));
+    layer out = Softmax(Dense(l, 10));
+    return Model({in}, {out});
+}
+
+int main(int argc, char **argv) {
+    int reps = 10;
+    int threads = 1;
+    if (argc > 1) reps = atoi(argv[1]);
+    if (argc > 2) threads = atoi(argv[2]);
+
+    struct {
+        const char *name;
+        model (*create)();
+    } models[] = {
+            {"conv_relu",    conv_relu},
+            {"conv_bn_relu", conv_bn_relu},
+    };
+
+    int batch = 32;
+    Tensor *x = Tensor::randn({batch, 3, 32, 32});
+    Tensor *y = Tensor::zeros({batch, 10});
+    for (int i = 0; i < batch; i++) y->ptr[i * 10 + i % 10] = 1.0f;
+
+    fprintf(stdout, "\n%d reps, batch %d, %d threads\n", reps, batch, threads);
+    fprintf(stdout, "%-14s %-8s %12s %12s\n", "model", "fusion", "train (ms)", "frozen (ms)");
+
+    for (auto &m : models) {
+        for (bool fusion : {false, true}) {
+            model net = m.create();
+            net->fusion = fusion;
+            build(net, sgd(0.01f), {"soft_cross_entropy"}, {"categorical_accuracy"}, CS_CPU(threads));
+
+            train_batch(net, {x}, {y});  // Warm up (deltas, workspaces)
+            high_resolution_clock::time_point t1 = high_resolution_clock::now();
+            for (int i = 0; i < reps; i++) train_batch(net, {x}, {y});
+            high_resolution_clock::time_point t2 = high_resolution_clock::now();
+            duration<double> train = t2 - t1;
+
+            freeze(net);
+            forward(net, {x});
+            t1 = high_resolution_clock::now();
+            for (int i = 0; i < reps; i++) forward(net, {x});
+            t2 = high_resolution_clock::now();
+            duration<double> frozen = t2 - t1;
+
+            fprintf(stdout, "%-14s %-8s %12.3f %12.3f\n", m.name, fusion ? "on" : "off",
+                    train.count() * 1e3 / reps, frozen.count() * 1e3 / reps);
+            delete net;
+        }
+    }
+
+    delete x;
+    delete y;
+}
@@ -81,6 +81,17 @@ typedef NetLoss * metric;
     */
     void build(model net, optimizer o, const vector<string> &lo, const vector<string> &me, CompServ *cs=nullptr, bool init_weights=true);
 
+    /**
+      *  @brief Turn a built model into an inference-only one. Gradients, deltas and the optimizer are released,
+      *  the forward runs on the calling thread and the activations share one buffer. Batch normalizations after
+      *  a convolution or dense layer are folded into its weights, so the model can no longer be saved or exported.
+      *  Training is no longer possible. Only for non-recurrent models on CPU.
+      *
+      *  @param net  Model
+      *  @return     (void)
+    */
+    void freeze(model net);
+
     // Computing services
     /**
       *  @brief Assign model operations to the GPU.
@@ -244,6 +255,15 @@ typedef NetLoss * metric;
       *  @return     (void) Outputs log to the given file.
     */
     void setlogfile(model net,string fname);
+    /**
+      *  @brief  Bounds the unrolled versions of a recurrent model kept alive between batches.
+      *
+      *  @param net  Recurrent model
+      *  @param size  Maximum number of unrolled nets cached (least recently used ones are released)
+      *  @param bucket  Input sequences are zero-padded at the front up to a multiple of this length (1: no padding)
+      *  @return     (void)
+    */
+    void set_rnet_cache(model net, int size, int bucket=1);
     /**
       *  @brief  Prints a summary representation of your model.
       *
@@ -251,6 +271,28 @@ typedef NetLoss * metric;
       *  @return     (void) Prints the model
     */
     void summary(model m);
+    /**
+      *  @brief  Starts a new recording of the forward, backward and update of every layer, and of the CPU kernels they
+      *  run (time, thread and bytes allocated), or stops it. Disabled by default.
+      *
+      *  @param enable  Whether to record
+      *  @return     (void)
+    */
+    void set_profiling(bool enable);
+    /**
+      *  @brief  Prints the time and memory spent by each layer of the model while profiling.
+      *
+      *  @param m  Model
+      *  @return     (void) Prints the table
+    */
+    void profile_summary(model m);
+    /**
+      *  @brief  Saves the events recorded while profiling in the Chrome trace format (chrome://tracing, Perfetto).
+      *
+      *  @param fname  JSON file
+      *  @return     (void)
+    */
+    void save_profile(const string& fname);
     /**
       *  @brief  Plots a representation of your model.
       *
@@ -423,15 +465,45 @@ typedef NetLoss * metric;
       *  @return     (void) Evaluates the model
     */
     void evaluate(model m, const vector<Tensor *> &in, const vector<Tensor *> &out);
+    /**
+      *  @brief Sets how fit draws the batches of each epoch.
+      *
+      *  @param m  Model
+      *  @param stratified  Keep the class ratios of the first output in every batch (one-hot targets)
+      *  @param drop_last  Skip the last batch of the epoch when it is incomplete
+      *  @param prefetch  Batches assembled in advance by a background thread (0: inline)
+      *  @return     (void)
+    */
+    void set_sampling(model m, bool stratified, bool drop_last, int prefetch=2);
+    /**
+      *  @brief Seeds the random generators (weight initializers, dropout, data augmentation and the batch order of fit). Calling it before build, or setting the seed of the computing service, makes runs reproducible.
+      *
+      *  @param m  Model
+      *  @param seed  Non-negative seed
+      *  @return     (void)
+    */
+    void set_seed(model m, int seed);
 
     /**
       *  @brief Performs a prediction with input data
       *
       *  @param m  Model
       *  @param in  Input data (features)
+      *  @param batch  Number of samples forwarded at once, by default the largest of the batch of the model and PREDICT_BATCH
       *  @return    vector of output tensors.
     */
-    vector<Tensor *>  predict(model m, const vector<Tensor *> &in);
+    vector<Tensor *>  predict(model m, const vector<Tensor *> &in, int batch=0);
+    /**
+      *  @brief Performs a prediction in chunks of samples, without resizing the model to the whole input
+      *
+      *  @param m  Model
+      *  @param in  Input data (features)
+      *  @param batch  Number of samples forwarded at once
+      *  @param F  Function called with the outputs of each chunk and the index of its first sample
+      *  @param arg  User data passed to F
+      *  @return    (void)
+    */
+    void predict(model m, const vector<Tensor *> &in, int batch, predict_callback F, void *arg=nullptr);
 
 
     // Finer methods
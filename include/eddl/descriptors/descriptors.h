@@ -23,9 +23,26 @@
 
 using namespace std;
 
+// Reduction modes (ReduceDescriptor::m, cpu_reduce)
+#define REDUCE_MEAN 0
+#define REDUCE_SUM 1
+#define REDUCE_MAX 2
+#define REDUCE_MIN 3
+#define REDUCE_VAR 4
+
+// Accumulation ops of cpu_reduce_op: B op= reduction of A
+#define REDUCE_OP_SUM 0
+#define REDUCE_OP_DIFF 1
+#define REDUCE_OP_MULT 2
+#define REDUCE_OP_DIV 3
+
+int reduce_mode(const string &mode);
+int reduce_op_mode(const string &op);
+
 class MapReduceDescriptor {
 public:
-   int *ind;
+   vector<int> axis;
+   int *ind;  // element to output map, only built for GPU tensors
    int *gind;
 
 
@@ -58,6 +75,19 @@ public:
 
 };
 
+// CPU convolution algorithms (see ConvolDescriptor::build)
+#define CONV_ALGO_IM2COL 0
+#define CONV_ALGO_GEMM1X1 1
+#define CONV_ALGO_WINOGRAD 2
+#define CONV_ALGO_DEPTHWISE 3
+
+// Pointwise activations fused after the bias of Conv and Dense (see Net::fuse_layers)
+#define EPI_NONE 0
+#define EPI_RELU 1
+#define EPI_LEAKY_RELU 2
+#define EPI_SIGMOID 3
+#define EPI_TANH 4
+
 class ConvolDescriptor {
 public:
     vector<int> ksize;
@@ -73,6 +103,8 @@ public:
     int padcl,padcr;
     int size;
     bool use_bias;
+    int groups=1; // kz=iz/groups input channels and nk/groups filters per group
+    int dr=1, dc=1; // dilation rate (rows, cols)
     int mem_level; // see CS
 
     Tensor *I= nullptr; // Input map
@@ -87,7 +119,16 @@ public:
     Tensor *O= nullptr; // Outputmap
 
     // CPU implementation
-    float *ptrI;
+    float *ptrI=nullptr; // only kept for the FPGA emulation, CPU lowers into a shared workspace
+    float *ptrgKt=nullptr; // per-thread partial gradients of the kernels
+    int size_gKt=0;
+    int algo=CONV_ALGO_IM2COL; // forward algorithm, chosen from the shape in build
+    int act=EPI_NONE; // activation applied along with the bias
+    float act_param=0.0f;
+    float *ptrU=nullptr; // Winograd transformed kernels
+    int size_U=0;
+    bool keep_U=false; // inference: ptrU is reused while K does not change
+    bool valid_U=false; // ptrU holds the transform of the current K
     Eigen::MatrixXf matI; // input
     Eigen::MatrixXf matK; // kernels
     Eigen::MatrixXf matO; // output
@@ -113,8 +154,13 @@ public:
 
     ConvolDescriptor(int filters, const vector<int> &ks, const vector<int> &st, const string& p, bool use_bias, int mem=0);
 
+    ConvolDescriptor(int filters, const vector<int> &ks, const vector<int> &st, const string& p, bool use_bias,
+                     int groups, const vector<int> &dilation_rate, int mem=0);
+
     ConvolDescriptor(const vector<int> &ks, const vector<int> &st, const vector<int> &p, int mem=0);
 
+    ~ConvolDescriptor();
+
     void build(Tensor *A);
     void resize(int b);
 	void enable_distributed();
@@ -0,0 +1,60 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.7
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: April 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#ifndef EDDL_CPU_ALLOCATOR_H
+#define EDDL_CPU_ALLOCATOR_H
+
+#include <cstddef>
+
+// Alignment of every block (a cache line, AVX-512 loads)
+#define FMEM_ALIGN 64
+
+// Blocks from this size on may be backed by huge pages
+#define FMEM_HUGE_PAGE (2UL << 20)
+
+// Caching allocator of CPU tensor storage. Requests are rounded up to size
+// classes (4 per power of two) and freed blocks are kept in a per-thread free
+// list, backed by a shared one, so allocations of recurring shapes do not
+// reach the system. The system (and the free memory check) is only used to
+// refill a class with no cached block.
+
+struct FmemStats {
+    unsigned long long allocs;             // blocks handed out
+    unsigned long long frees;              // blocks given back
+    unsigned long long hits;               // allocations served from a cache
+    unsigned long long refills;            // allocations served by the system
+    unsigned long long releases;           // blocks returned to the system
+    unsigned long long bytes_in_use;       // live blocks (class sizes)
+    unsigned long long peak_bytes_in_use;
+    unsigned long long bytes_cached;       // free blocks kept in the caches
+    unsigned long long huge_blocks;        // blocks advised to use huge pages
+};
+
+// Returns a FMEM_ALIGN aligned block of (at least) size floats, or nullptr
+// when the system cannot provide it
+float *fmem_alloc(size_t size);
+
+// Gives back a block of fmem_alloc. Returns false if ptr does not come from it.
+bool fmem_free(float *ptr);
+
+// Returns all the cached blocks to the system
+void fmem_trim();
+
+FmemStats fmem_stats();
+
+// Bytes (class sizes) handed out to the calling thread so far
+unsigned long long fmem_thread_allocated();
+
+// Huge pages for blocks of at least FMEM_HUGE_PAGE bytes (Linux, off by default)
+void fmem_set_huge_pages(bool enable);
+
+// Maximum bytes of free blocks kept in the shared cache
+void fmem_set_cache_limit(size_t bytes);
+
+#endif //EDDL_CPU_ALLOCATOR_H
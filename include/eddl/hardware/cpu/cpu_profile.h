@@ -148,9 +148,25 @@
 #define _CPU_REPEAT_NN             144
 #define _CPU_D_REPEAT_NN           145
 #define _CPU_FLIP                  146
+#define _CPU_SGD_UPDATE            147
+#define _CPU_ADAM_UPDATE           148
+#define _CPU_RMSPROP_UPDATE        149
+#define _CPU_BATCHNORM_FORWARD     150
+#define _CPU_BATCHNORM_BACKWARD    151
+#define _CPU_SOFTMAX_CENT          152
+#define _CPU_DROPOUT_FORWARD       153
+#define _CPU_DROPOUT_BACKWARD      154
+#define _CPU_SGD_UPDATE_ROWS       155
+#define _CPU_ADAM_UPDATE_ROWS      156
+#define _CPU_SPARSE_CENT           157
+#define _CPU_SPARSE_ACCURACY       158
+#define _CPU_LSTM_FORWARD          159
+#define _CPU_LSTM_BACKWARD         160
+#define _CPU_PERMUTE               161
+#define _CPU_BIAS_ACT              162
+#define _CPU_D_ACT                 163
 
-#define _NUM_CPU_FUNCS       147
-extern int num_instances[_NUM_CPU_FUNCS];
+#define _NUM_CPU_FUNCS       164
 void _profile(int f_id, int end);
 void _profile_add_tensor(long size);
 
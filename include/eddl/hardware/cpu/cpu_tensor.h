@@ -37,6 +37,8 @@ void cpu_select_back(Tensor *A, Tensor *B, SelDescriptor *sd);
 void cpu_set_select(Tensor *A, Tensor *B, SelDescriptor *sd);
 void cpu_set_select_back(Tensor *A, Tensor *B, SelDescriptor *sd);
 
+void cpu_permute(Tensor *A, Tensor *B, const vector<int> &dims);
+
 void cpu_select(Tensor *A, Tensor *B, vector<int> sind, int ini, int end,bool mask_zeros=false); // TODO: Legacy
 void cpu_deselect(Tensor *A, Tensor *B, vector<int> sind, int ini, int end,int inc=0,bool mask_zeros=false); // TODO: Legacy
 
@@ -168,10 +170,8 @@ int cpu_mode(float *ptr, int size, int *map);
 
 
 // CPU: Reduction
-void cpu_reduce(Tensor *A, Tensor *B,string mode,int* map);
-void cpu_reduce_op(Tensor *A, Tensor *B,string op,int* map);
-void cpu_reduce(Tensor *A, Tensor *B,string mode,MapReduceDescriptor *MD);
-void cpu_reduce_op(Tensor *A, Tensor *B,string op,MapReduceDescriptor *MD);
+void cpu_reduce(Tensor *A, Tensor *B, const vector<int> &axis, int mode);
+void cpu_reduce_op(Tensor *A, Tensor *B, const vector<int> &axis, int op);
 
 void cpu_reduce_sum2D(Tensor *A, Tensor *B, int axis, int incB);
 void cpu_reduction(ReduceDescriptor *RD);
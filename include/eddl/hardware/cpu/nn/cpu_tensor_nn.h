@@ -57,13 +57,21 @@ void cpu_d_softmax(Tensor *D, Tensor *I, Tensor *PD);
 void cpu_linear(Tensor *A, Tensor *B, float param);
 void cpu_d_linear(Tensor *D, Tensor *I, Tensor *PD, float param);
 
+// Bias and activation epilogue of Conv/Dense (act: EPI_*), bias per channel (dim 1)
+void cpu_epilogue(float *ptr, long int n, float bias, int act, float param);
+void cpu_bias_act(Tensor *O, Tensor *bias, int act, float param);
+void cpu_d_act(Tensor *D, Tensor *O, int act, float param);
+
 // Losses
 void cpu_cent(Tensor *A, Tensor *B, Tensor *C);
+float cpu_softmax_cent(Tensor *T, Tensor *Y, Tensor *D);
+float cpu_sparse_cent(Tensor *T, Tensor *Y, Tensor *D, bool softmax);
 void cpu_bin_cent(Tensor *A, Tensor *B, Tensor *C);
 
 // Metrics
 int cpu_accuracy(Tensor *A, Tensor *B);
 int cpu_bin_accuracy(Tensor *A, Tensor *B);
+int cpu_sparse_accuracy(Tensor *T, Tensor *Y);
 
 
 // Conv
@@ -71,6 +79,10 @@ void cpu_conv2D(ConvolDescriptor *D);
 void cpu_conv2D_grad(ConvolDescriptor *D);
 void cpu_conv2D_back(ConvolDescriptor *D);
 
+// Conv workspace (im2col tiles), upper bound in bytes
+void cpu_set_conv_workspace(long int bytes);
+long int cpu_get_conv_workspace();
+
 // MaxPool
 void cpu_mpool2D(PoolDescriptor*D);
 void cpu_mpool2D_back(PoolDescriptor *D);
@@ -79,6 +91,16 @@ void cpu_mpool2D_back(PoolDescriptor *D);
 void cpu_avgpool2D(PoolDescriptor*D);
 void cpu_avgpool2D_back(PoolDescriptor *D);
 
+// Dropout (bit-packed masks)
+void cpu_dropout_forward(Tensor *A, Tensor *B, unsigned int *mask, float keep, float scale);
+void cpu_dropout_backward(Tensor *D, Tensor *PD, unsigned int *mask, float scale);
+
+// LSTM
+void cpu_lstm_forward(Tensor *X, Tensor *G, Tensor *bias, Tensor *hprev, Tensor *cprev,
+                      Tensor *mask, Tensor *sh, Tensor *h, Tensor *c);
+void cpu_lstm_backward(Tensor *G, Tensor *cprev, Tensor *sh, Tensor *mask, Tensor *dh, Tensor *dc,
+                       Tensor *DG, Tensor *dhprev, Tensor *dcprev);
+
 // Tensor (special functions that deal with 4D tensors)
 void cpu_repeat_nn(Tensor *A, Tensor *B, vector<int> size);
 void cpu_d_repeat_nn(Tensor *D, Tensor *A, vector<int> size);
@@ -88,9 +110,18 @@ void cpu_select_back_nn(Tensor *A, Tensor *B, SelDescriptor *sd);
 void cpu_set_select_nn(Tensor *A, Tensor *B, SelDescriptor *sd);
 void cpu_set_select_back_nn(Tensor *A, Tensor *B, SelDescriptor *sd);
 
+// Optimizers
+void cpu_sgd_update(Tensor *P, Tensor *G, Tensor *M, float lr, float mu, float weight_decay, bool nesterov);
+void cpu_adam_update(Tensor *P, Tensor *G, Tensor *M, Tensor *V, float step, float beta_1, float beta_2, float inv_bc2, float epsilon, float weight_decay);
+void cpu_sgd_update_rows(Tensor *P, Tensor *G, Tensor *M, const vector<int> &rows, float lr, float mu, float weight_decay, bool nesterov);
+void cpu_adam_update_rows(Tensor *P, Tensor *G, Tensor *M, Tensor *V, const vector<int> &rows, float step, float beta_1, float beta_2, float inv_bc2, float epsilon, float weight_decay);
+void cpu_rmsprop_update(Tensor *P, Tensor *G, Tensor *G1, float lr, float rho, float epsilon, float weight_decay);
+
 // BN
 void cpu_permute_channels_first(Tensor *A,Tensor *B);
 void cpu_permute_channels_last(Tensor *A,Tensor *B);
 void cpu_permute_batch_first(Tensor *A,Tensor *B);
 void cpu_permute_batch_last(Tensor *A,Tensor *B);
+void cpu_batchnorm_forward(Tensor *input, Tensor *output, Tensor *opa, Tensor *global_mean, Tensor *global_variance, Tensor *affine_g, Tensor *affine_b, Tensor *mean, Tensor *variance, bool trmode, float epsilon, float momentum);
+void cpu_batchnorm_backward(Tensor *delta, Tensor *opa, Tensor *pdelta, Tensor *variance, Tensor *affine_g, Tensor *gaffine_g, Tensor *gaffine_b, Tensor *mdelta, Tensor *mdelta_opa);
 #endif //EDDL_CPU_TENSOR_NN_H
@@ -103,6 +103,10 @@ void fpga_copy_memory_from_fpga(cl::Buffer *ptr_fpga, void *ptr_cpu, long int si
 void fpga_copy_fpga(Tensor *A, Tensor *B);
 void fpga_copy_to_fpga(float *nptr, Tensor *A);
 void fpga_copy_from_fpga(Tensor *A,float *nptr);
+void fpga_sync(Tensor *A);
+cl::Buffer *fpga_kernel_in(Tensor *A);
+cl::Buffer *fpga_kernel_out(Tensor *A);
+extern DeviceMemory *fpga_memory;
 void fpga_copy_addresses_from_fpga(SelDescriptor *SD, int size, int *nptr);
 
 
@@ -263,10 +267,8 @@ float fpga_sum(Tensor *A);
 float fpga_sum_abs(Tensor *A);
 
 // CPU: Reduction
-void fpga_reduce(Tensor *A, Tensor *B,string mode,int* map);
-void fpga_reduce_op(Tensor *A, Tensor *B,string op,int* map);
-void fpga_reduce(Tensor *A, Tensor *B,string mode,MapReduceDescriptor *MD);
-void fpga_reduce_op(Tensor *A, Tensor *B,string op,MapReduceDescriptor *MD);
+void fpga_reduce(Tensor *A, Tensor *B, int mode, const vector<int> &axis);
+void fpga_reduce_op(Tensor *A, Tensor *B, int op, const vector<int> &axis);
 
 void fpga_reduce_sum2D(Tensor *A, Tensor *B, int axis, int incB);
 void fpga_reduction(ReduceDescriptor *RD);
@@ -157,8 +157,11 @@
 #define _FPGA_FLIP                  146
 
 #define _FPGA_SUM_2                 147
+#define _FPGA_SGD_UPDATE            148
+#define _FPGA_ADAM_UPDATE           149
+#define _FPGA_RMSPROP_UPDATE        150
 
-#define _NUM_FPGA_FUNCS       148
+#define _NUM_FPGA_FUNCS       151
 extern int num_instances_fpga[_NUM_FPGA_FUNCS];
 void _profile_fpga(int f_id, int end);
 void _profile_fpga_tensor(Tensor *T);
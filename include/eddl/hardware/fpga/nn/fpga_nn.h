@@ -82,6 +82,11 @@ void fpga_select_back_nn(Tensor *A, Tensor *B, SelDescriptor *sd);
 void fpga_set_select_nn(Tensor *A, Tensor *B, SelDescriptor *sd);
 void fpga_set_select_back_nn(Tensor *A, Tensor *B, SelDescriptor *sd);
 
+// Optimizers
+void fpga_sgd_update(Tensor *P, Tensor *G, Tensor *M, float lr, float mu, float weight_decay, bool nesterov);
+void fpga_adam_update(Tensor *P, Tensor *G, Tensor *M, Tensor *V, float step, float beta_1, float beta_2, float inv_bc2, float epsilon, float weight_decay);
+void fpga_rmsprop_update(Tensor *P, Tensor *G, Tensor *G1, float lr, float rho, float epsilon, float weight_decay);
+
 // BN
 void fpga_permute_channels_first(Tensor *A,Tensor *B);
 void fpga_permute_channels_last(Tensor *A,Tensor *B);
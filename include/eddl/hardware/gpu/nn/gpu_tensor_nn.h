@@ -88,6 +88,11 @@ void gpu_select_back_nn(Tensor *A, Tensor *B, SelDescriptor *sd);
 void gpu_set_select_nn(Tensor *A, Tensor *B, SelDescriptor *sd);
 void gpu_set_select_back_nn(Tensor *A, Tensor *B, SelDescriptor *sd);
 
+// Optimizers
+void gpu_sgd_update(Tensor *P, Tensor *G, Tensor *M, float lr, float mu, float weight_decay, bool nesterov);
+void gpu_adam_update(Tensor *P, Tensor *G, Tensor *M, Tensor *V, float step, float beta_1, float beta_2, float inv_bc2, float epsilon, float weight_decay);
+void gpu_rmsprop_update(Tensor *P, Tensor *G, Tensor *G1, float lr, float rho, float epsilon, float weight_decay);
+
 // BN
 void gpu_permute_channels_first(Tensor *A,Tensor *B);
 void gpu_permute_channels_last(Tensor *A,Tensor *B);
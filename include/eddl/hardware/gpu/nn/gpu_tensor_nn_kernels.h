@@ -92,6 +92,11 @@ __global__ void gpu_set_select_nn(float *A, float* B, long int size, int* indice
 __global__ void gpu_set_select_back_nn(float *A, float* B, long int size, int* indices, int A_batch_str, int B_batch_str);
 
 // BN
+// GPU: Optimizers
+__global__ void sgd_update(float *p, float *g, float *m, float lr, float mu, float weight_decay, bool nesterov, long int size);
+__global__ void adam_update(float *p, float *g, float *m, float *v, float step, float beta_1, float beta_2, float inv_bc2, float epsilon, float weight_decay, long int size);
+__global__ void rmsprop_update(float *p, float *g, float *g1, float lr, float rho, float epsilon, float weight_decay, long int size);
+
 __global__ void bn_permute_channels_first(float *src, float *dest,int b,int z,int r,int c,long int size);
 __global__ void bn_permute_channels_last(float *src, float *dest,int b,int z,int r,int c,long int size);
 __global__ void bn_permute_batch_first(float *src, float *dest,int b,int z,int r,int c,long int size);
@@ -0,0 +1,73 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.7
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: April 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#ifndef EDDL_HOST_MIRROR_H
+#define EDDL_HOST_MIRROR_H
+
+#include <vector>
+
+using namespace std;
+
+// Coherence state of a device buffer and its host copy
+#define MIRROR_SHARED 0  // both copies hold the same data
+#define MIRROR_DEVICE 1  // the device copy is newer
+#define MIRROR_HOST   2  // the host copy is newer (dirty)
+
+// Raw transfers between device buffers and host memory. Every transfer is
+// counted, so backends can be compared by the traffic they generate.
+class DeviceMemory {
+public:
+    long reads;          // device -> host transfers
+    long writes;         // host -> device transfers
+    long bytes_read;
+    long bytes_written;
+
+    DeviceMemory();
+    virtual ~DeviceMemory() {}
+
+    virtual void read(void *buf, float *host, long size) = 0;
+    virtual void write(void *buf, const float *host, long size) = 0;
+
+    void reset_counters();
+};
+
+// Device memory kept in host RAM, to run the coherence protocol without hardware
+class MockDeviceMemory : public DeviceMemory {
+public:
+    void *create(long size);
+    void destroy(void *buf);
+
+    void read(void *buf, float *host, long size) override;
+    void write(void *buf, const float *host, long size) override;
+};
+
+// Host copy of a device buffer. Host fallbacks read and write the host copy and
+// only mark it, so chains of them do not move the data; the transfer happens
+// when the device (or a different host buffer) needs the newest data.
+class HostMirror {
+public:
+    int state;
+
+    HostMirror();
+
+    // Makes the host copy valid before reading it. When dst is given (and is
+    // not the host copy), the data are also copied there.
+    void host_read(DeviceMemory *mem, void *buf, float *host, long size, float *dst=nullptr);
+
+    // The host copy has been overwritten, or is overwritten with src
+    void host_write(float *host, long size, const float *src=nullptr);
+
+    // Makes the device copy valid before a device kernel or copy reads it
+    void device_read(DeviceMemory *mem, void *buf, float *host, long size);
+
+    // A device kernel or copy has written the buffer
+    void device_write();
+};
+
+#endif //EDDL_HOST_MIRROR_H
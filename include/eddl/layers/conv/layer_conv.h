@@ -41,6 +41,12 @@ public:
 
     LConv(Layer *parent, ConvolDescriptor *cd, string name, int dev, int mem);
 
+    ~LConv() override;
+
+    void copy(Layer *l2) override;
+
+    void load(std::ifstream &ifs, string format="") override;
+
     Layer *share(int c, int bs, vector<Layer *> p) override;
 
     Layer *clone(int c, int bs, vector<Layer *> p, int todev) override;
@@ -80,6 +80,18 @@ public:
 };
 
 /// EMBEDDING Layer
+// Unique rows of a table with a non-zero gradient
+class SparseRows {
+public:
+    vector<int> rows;
+    vector<bool> in;
+    bool all;  // every row may be non-zero (before the first zeroing)
+
+    explicit SparseRows(int n);
+    void add(const vector<int> &ind);
+    void clear();
+};
+
 class LEmbedding : public LinLayer {
 public:
     int dim;
@@ -88,10 +100,12 @@ public:
     bool mask_zeros;
     Tensor *E;
     Tensor *gE;
+    SparseRows *grows;  // rows of gE touched by backward, shared with the shared layers
     vector<int> sind;
     static int total_layers;
 
     LEmbedding(Layer *parent, int vocsize, int lenght, int dim, bool mask_zeros, string name, int dev, int mem);
+    ~LEmbedding() override;
 
     Layer *share(int c, int bs, vector<Layer *> p) override;
 
@@ -101,6 +115,10 @@ public:
 
     void backward() override;
 
+    void zeroGrads() override;
+
+    vector<int> *sparse_rows(int j) override;
+
     string plot(int c) override;
 
 };
@@ -112,6 +130,8 @@ public:
     int ndim;
     bool use_bias;  // TODO: Implement
 	bool distributed_training;
+    int act;  // activation fused after the bias (EPI_*, see Net::fuse_layers)
+    float act_param;
 
     LDense(Layer *parent, int ndim, bool use_bias, string name, int dev, int mem);
 
@@ -156,8 +176,11 @@ public:
     string act;
     static int total_layers;
     vector<float> params;
+    bool fused;    // computed in the epilogue of its Conv or Dense parent (Net::fuse_layers)
+    bool inplace;  // overwrites the output of its parent (frozen nets)
 
     LActivation(Layer *parent, string act, vector<float> params, string name, int dev, int mem);
+    ~LActivation() override;
 
     Layer *share(int c, int bs, vector<Layer *> p) override;
 
@@ -166,6 +189,11 @@ public:
     void save(std::ofstream &ofs, string format) override;
     void load(std::ifstream &ifs, string format) override;
 
+    void mem_delta() override;
+    void free_delta() override;
+
+    void resize(int batch) override;
+
     void forward() override;
 
     void backward() override;
@@ -239,7 +267,8 @@ public:
     Layer *clone(int c, int bs, vector<Layer *> p, int todev) override;
 
     float df;
-    Tensor *mask;
+    Tensor *mask;             // GPU/FPGA mask
+    unsigned int *mask_bits;  // CPU mask, 1 bit per element
 
     // implementation
     void forward() override;
@@ -248,6 +277,8 @@ public:
     void resize(int batch) override;
     string plot(int c) override;
 
+private:
+    void alloc_mask();
 };
 
 
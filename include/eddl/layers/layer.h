@@ -78,7 +78,7 @@ public:
     virtual void info();
 
     void setmode(int m);
-    void check_target();
+    void check_target(const vector<int> &shape);
     void detach(Layer *l);
     vector<int> getShape();
 
@@ -110,6 +110,8 @@ public:
     virtual void reset();
     virtual int get_trainable_params_count();
     virtual void zeroGrads();
+    // Rows of gradients[j] written since the last zeroGrads, nullptr if any row may be non-zero
+    virtual vector<int> *sparse_rows(int j) { return nullptr; }
     virtual string plot(int c) { return ""; }
 
     virtual void addchild(Layer *l) {}
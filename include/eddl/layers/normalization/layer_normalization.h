@@ -46,14 +46,18 @@ public:
     Tensor *gbn_g;
     Tensor *gbn_b;
     Tensor *opa; //output pre-affine
+    Tensor *bn_dmean; // per channel mean(delta), CPU backward
+    Tensor *bn_dopa;  // per channel mean(delta*opa), CPU backward
 
     bool init;
     vector<int> shape;
+    bool folded;  // folded into the weights of its parent (frozen nets)
 
     static int total_layers;
     vector<Layer *> layers;
 
     LBatchNorm(Layer *parent, float momentum, float epsilon, bool affine, string name, int dev, int mem);
+    ~LBatchNorm() override;
 
     Layer *share(int c, int bs, vector<Layer *> p) override;
 
@@ -95,30 +95,20 @@ public:
     Tensor *delta_h;
     Tensor *delta_c;
 
-    Tensor *Wih,*Wix;
-    Tensor *Wfh,*Wfx;
-    Tensor *Woh,*Wox;
-    Tensor *Wch,*Wcx;
-
-    Tensor *gWih,*gWix;
-    Tensor *gWfh,*gWfx;
-    Tensor *gWoh,*gWox;
-    Tensor *gWch,*gWcx;
-
-    Tensor *in,*fn,*on,*cn;
-    Tensor *inbias,*fnbias,*onbias,*cnbias;
-    Tensor *ginbias,*gfnbias,*gonbias,*gcnbias;
-
-    Tensor *incn,*cn1fn;
-    Tensor *sh;
-
-    Tensor *mask;
-    Tensor *psh;
-    Tensor *psc;
-
-
+    // Gates packed as [i|f|o|c] along the columns
+    Tensor *Wx;   // {input, 4*units}
+    Tensor *Wh;   // {units, 4*units}
+    Tensor *bias; // {4*units}
+    Tensor *gWx,*gWh,*gbias;
+
+    // Per step buffers, kept across batches
+    Tensor *gates;  // activated gates
+    Tensor *dgates; // delta of the gate pre-activations
+    Tensor *sh;     // tanh(state_c)
+    Tensor *mask;   // 1 for the samples with a non-zero input
 
     LLSTM(vector<Layer *> in, int units,  bool mask_zeros, bool bidirectional, string name, int dev, int mem);
+    ~LLSTM() override;
 
     Layer *share(int c, int bs, vector<Layer *> p) override;
 
@@ -27,6 +27,10 @@ public:
 
     virtual void delta(Tensor *T, Tensor *Y, Tensor *D);
     virtual float value(Tensor *T, Tensor *Y);
+    // value and delta in one call, losses with a fused kernel override it
+    virtual float value_delta(Tensor *T, Tensor *Y, Tensor *D);
+    // shape of the targets for an output of shape oshape
+    virtual vector<int> target_shape(const vector<int> &oshape);
     virtual Loss* clone();
 };
 
@@ -106,6 +110,31 @@ public:
 
     void delta(Tensor *T, Tensor *Y, Tensor *D) override;
     float value(Tensor *T, Tensor *Y) override;
+    // value and delta of a softmax output in one pass, the delta is wrt the softmax input
+    float value_delta(Tensor *T, Tensor *Y, Tensor *D) override;
+    Loss* clone() override;
+};
+
+// Sparse versions take the class indices (batch x 1) as targets instead of one-hot rows
+
+class LSparseCrossEntropy : public Loss {
+public:
+    LSparseCrossEntropy();
+
+    void delta(Tensor *T, Tensor *Y, Tensor *D) override;
+    float value(Tensor *T, Tensor *Y) override;
+    vector<int> target_shape(const vector<int> &oshape) override;
+    Loss* clone() override;
+};
+
+class LSparseSoftCrossEntropy : public Loss {
+public:
+    LSparseSoftCrossEntropy();
+
+    void delta(Tensor *T, Tensor *Y, Tensor *D) override;
+    float value(Tensor *T, Tensor *Y) override;
+    float value_delta(Tensor *T, Tensor *Y, Tensor *D) override;
+    vector<int> target_shape(const vector<int> &oshape) override;
     Loss* clone() override;
 };
 
@@ -129,7 +158,6 @@ public:
 //void categorical_hinge(Tensor *T, Tensor *Y, Tensor *D);
 //void logcosh(Tensor *T, Tensor *Y, Tensor *D);
 //void categorical_crossentropy(Tensor *T, Tensor *Y, Tensor *D);
-//void sparse_categorical_crossentropy(Tensor *T, Tensor *Y, Tensor *D);
 //void binary_crossentropy(Tensor *T, Tensor *Y, Tensor *D);
 //void kullback_leibler_divergence(Tensor *T, Tensor *Y, Tensor *D);
 //void poisson(Tensor *T, Tensor *Y, Tensor *D);
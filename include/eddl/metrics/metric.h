@@ -73,6 +73,15 @@ public:
     Metric* clone() override;
 };
 
+// Targets are the class indices (batch x 1)
+class MSparseCategoricalAccuracy : public Metric {
+public:
+    MSparseCategoricalAccuracy();
+
+    float value(Tensor *T, Tensor *Y) override;
+    Metric* clone() override;
+};
+
 class MBinAccuracy : public Metric {
 public:
     MBinAccuracy();
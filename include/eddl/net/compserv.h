@@ -36,6 +36,18 @@ public:
     // 2: low memory. save memory as much as possible
     int mem_level;
 
+    // snets dispatch: persistent worker pool (default) or one pthread per snet and call
+    bool persistent_workers = true;
+    // bind pool worker i to core i (Linux only). Off by default: the OpenMP
+    // teams started by a pinned worker inherit its single-core mask, and the
+    // cores may be shared with other processes. Set it before build()
+    bool pin_workers = false;
+
+    // upper bound (MB) of the CPU im2col workspace shared by the convolutions
+    int conv_workspace_mb = 256;
+
+    // random seed applied when a net is built with this service, -1 keeps the current one
+    int seed = -1;
 
 
     CompServ();
@@ -0,0 +1,47 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.7
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: April 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#ifndef EDDL_MEM_PLAN_H
+#define EDDL_MEM_PLAN_H
+
+#include <climits>
+#include <vector>
+
+using namespace std;
+
+// End of the buffers that must outlive the schedule
+#define MEM_KEEP INT_MAX
+
+// Buffer alive in the steps [start, end] of a schedule
+struct MemBlock {
+    long size;     // floats
+    int start;
+    int end;
+    long offset;   // floats from the start of the arena
+};
+
+// Static placement of buffers with known lifetimes in one arena. Buffers whose
+// lifetimes overlap never overlap in memory; the rest may share storage.
+class MemPlan {
+public:
+    vector<MemBlock> blocks;
+    long naive;    // floats with one allocation per buffer
+    long peak;     // floats of the arena
+
+    MemPlan();
+
+    // Returns the index of the block
+    int add(long size, int start, int end);
+
+    // Greedy by size: the largest buffers are placed first, each one in the
+    // smallest gap left by the placed buffers alive at the same time
+    void place();
+};
+
+#endif //EDDL_MEM_PLAN_H
@@ -19,6 +19,8 @@
 #include "eddl/losses/loss.h"
 #include "eddl/metrics/metric.h"
 #include "eddl/net/compserv.h"
+#include "eddl/net/workers.h"
+#include "eddl/net/mem_plan.h"
 
 using namespace std;
 
@@ -31,6 +33,9 @@ typedef vector<int> vind;
 typedef vector<Loss *> vloss;
 typedef vector<Metric *> vmetrics;
 
+// Receives the outputs of the samples [start, start+out[0]->shape[0]) of a chunked predict
+typedef void (*predict_callback)(int start, vtensor &out, void *arg);
+
 
 /////////////////////////////////////////
 int isIn(Layer *l, vlayer vl, int &ind);
@@ -38,6 +43,10 @@ int isInorig(Layer *l, vlayer vl, int &ind);
 
 #define MAX_THREADS 1024
 
+// Samples per forward of predict when no batch is given, unless the batch of
+// the net is larger
+#define PREDICT_BATCH 256
+
 class Net {
 private:
 	void build(Optimizer *opt, vloss lo, vmetrics me, bool initialize=true);
@@ -50,12 +59,15 @@ public:
 	int batch_size;
 	int tr_batches;
 	int inferenced_samples;
+	int inferenced_steps; // samples times outputs per sample, for the totals of the unrolls
 	int trmode;
 	int mem_level; // see Computing Service
 	unsigned int verbosity_level = 0;
 	bool onnx_pretrained;
   bool isrecurrent;
   bool isbuild;
+	bool isfrozen;  // inference only, see freeze()
+	bool isfolded;  // batchnorms folded into the weights, see fold_batchnorm()
 	bool isdecoder;
 	bool isencoder;
   int decsize;
@@ -73,6 +85,8 @@ public:
 
 	vloss losses;
 	vmetrics metrics;
+	vector<bool> softmax_cent; // output is a Softmax trained with (sparse_)soft_cross_entropy: fused loss and delta
+	vector<bool> delta_ready;  // delta of the output already computed along with the loss
 	verr fiterr;
 	verr total_loss;
 	verr total_metric;
@@ -83,6 +97,29 @@ public:
 	vector<Net *> snets;
 	vector<Net *> mnets;
 	Net* rnet;
+	vector<Net *> rnets; // unrolled nets, most recently used first
+	int rnet_cache_size; // max number of unrolled nets kept alive
+	int rnet_bucket; // sequence lengths are padded up to a multiple of it
+	int rinl, routl; // sequence lengths this net was unrolled for
+	WorkerPool *workers;
+
+	// fit sampling: stratify batches by the classes of the first output,
+	// drop the incomplete last batch, batches gathered ahead by the loader thread
+	bool fit_stratified = false;
+	bool fit_drop_last = true;
+	int fit_prefetch = 2;
+	// activations computed by their Conv/Dense parent, set before build (CPU)
+	bool fusion = true;
+
+	// Activation memory plan, see plan_memory()
+	MemPlan output_plan;          // outputs, forward schedule
+	MemPlan delta_plan;           // deltas, training schedule
+	vector<vlayer> delta_groups;  // layers sharing each delta buffer
+	vector<double> delta_ratio;   // delta size / output size of the first layer of each group
+	vector<vtensor> delta_zero;   // deltas cleared before each backward step
+	float *delta_arena;           // storage of the deltas when the plan is applied
+	vector<vlayer> output_groups; // layers sharing each output buffer moved to the arena (frozen nets)
+	float *output_arena;          // storage of those outputs
 
 	vtensor Xs[MAX_THREADS];
 	vtensor Ys[MAX_THREADS];
@@ -105,6 +142,9 @@ public:
 	Net *unroll_enc_dec(int inl, int outl);
 	Net *unroll_dec(int inl, int outl);
 	void build_rnet(int inl,int outl);
+	void set_rnet_cache(int size, int bucket=1);
+	int bucket_length(int l);
+	vector<int> target_shape(int i);
 	Layer* getLayer(vlayer in);
 
 	int inNet(Layer *l);
@@ -114,9 +154,17 @@ public:
 
 	void resize(int batch);
 
+	void plan_memory();
+	void release_memory_plan();
+	string memory_summary();
+	void freeze();
+	void fuse_layers();
+	void fold_batchnorm();
+
 	void enable_distributed();
 
 	string summary();
+	string profile_summary();
 	void plot(string fname,string mode);
 
 	void setmode(int m);
@@ -144,6 +192,7 @@ public:
 
 	// API
 	void run_snets(void *(*F)(void *t));
+	void run_snets_spawn(void *(*F)(void *t));
 	void forward(vector<Layer *> in);
 	void forward(vector<Tensor*> in);
 	void forward();
@@ -151,6 +200,8 @@ public:
 	void reset_loss();
     float get_metric( const string  layer_name, const string  metric_name );
 	void print_loss(int b);
+	void collect_loss(Net *r);
+	void print_totals(int b, int steps);
 	void backward(vector<Tensor *> target);
 	void backward(Layer* (*f)(Layer *),Layer *out);
 	void backward();
@@ -169,10 +220,15 @@ public:
 
 	void fit_recurrent(vtensor tin, vtensor tout, int batch_size, int epochs);
 	void train_batch(vtensor X, vtensor Y, vind sind, int eval = 0);
+	void gather_batch(vtensor X, vtensor Y, vind sind, vtensor *xs, vtensor *ys);
+	void run_batch(vtensor *xs, vtensor *ys, int eval = 0);
+	void set_sampling(bool stratified, bool drop_last, int prefetch=2);
+	void set_seed(int seed);
 	void evaluate(vtensor tin, vtensor tout);
 	void evaluate_recurrent(vtensor tin, vtensor tout);
 	vtensor predict_recurrent(vtensor tin);
-	vtensor predict(vtensor tin);
+	vtensor predict(vtensor tin, int batch=0);
+	void predict(vtensor tin, int batch, predict_callback F, void *arg=nullptr);
 
 
 };
@@ -0,0 +1,95 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.7
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: April 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#ifndef EDDL_SAMPLER_H
+#define EDDL_SAMPLER_H
+
+#include <exception>
+#include <random>
+#include <vector>
+#include <pthread.h>
+
+#include "eddl/tensor/tensor.h"
+
+using namespace std;
+
+class Net;
+
+// Epoch iterator: every sample is visited exactly once per epoch, in a new
+// random order each time.
+class Sampler {
+private:
+    vector<int> labels;  // class of each sample, empty when not stratified
+    int nclasses;
+    mt19937 gen;
+
+public:
+    int n;
+    int batch;
+    bool drop_last;
+
+    // If drop_last is false the n % batch remaining samples form a last batch,
+    // completed with samples of the earlier batches so all batches have the same size
+    Sampler(int n, int batch, bool drop_last=true, unsigned int seed=0);
+
+    // Spreads the classes of the targets Y, one-hot or class indices, evenly over the batches
+    void stratify(Tensor *Y);
+
+    int num_batches();
+
+    // Sample indices of the batches of a new epoch
+    vector<vector<int>> epoch();
+};
+
+
+// Assembled inputs and targets of one batch, one list per snet
+struct BatchSlot {
+    vector<vector<Tensor *>> xs;
+    vector<vector<Tensor *>> ys;
+};
+
+// Gathers the rows of upcoming batches into a ring of slots from a
+// background thread, so batch assembly overlaps with the forward/backward
+// of the previous batch. With 0 slots ahead batches are gathered inline.
+class BatchLoader {
+private:
+    Net *net;
+    vector<Tensor *> X;
+    vector<Tensor *> Y;
+    vector<vector<int>> batches;
+    int nbatches;
+    int ahead;      // Batches gathered in advance (0: no thread)
+    vector<BatchSlot> slots;
+
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond_ready;
+    pthread_cond_t cond_free;
+    int gathered;   // Batches [0, gathered) are ready
+    int released;   // Batches [0, released) have been consumed
+    bool stopping;
+    exception_ptr error;
+
+    static void *loader_main(void *t);
+    void loader_loop();
+    void gather(int b);
+
+public:
+    // Assembles the batches in order, all of them of the current net batch size
+    BatchLoader(Net *net, const vector<Tensor *> &X, const vector<Tensor *> &Y,
+                const vector<vector<int>> &batches, int ahead=2);
+    ~BatchLoader();
+
+    // Blocks until batch b is ready. Batches must be requested in order.
+    BatchSlot *wait(int b);
+    // The slot of batch b can be reused
+    void release(int b);
+};
+
+#endif  //EDDL_SAMPLER_H
@@ -0,0 +1,60 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.7
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: April 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#ifndef EDDL_WORKERS_H
+#define EDDL_WORKERS_H
+
+#include <exception>
+#include <vector>
+#include <pthread.h>
+
+using namespace std;
+
+// Persistent pool used by Net::run_snets.
+// Task 0 runs on the calling thread and tasks 1..n-1 on parked workers, so a
+// single-device net (the CPU case) never leaves the caller's thread and the
+// OpenMP/Eigen thread teams it owns are reused from step to step.
+class WorkerPool {
+private:
+    int nworkers;
+    bool pinned;
+    vector<pthread_t> threads;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t cond_start;
+    pthread_cond_t cond_done;
+
+    unsigned long generation;  // Incremented on every dispatch
+    int pending;               // Workers that have not finished the current dispatch
+    bool stopping;
+
+    void *(*task)(void *);
+    void **args;
+    int ntasks;
+    exception_ptr error;
+
+    static void *worker_main(void *t);
+    void worker_loop(int id);
+    void run_task(int id);
+
+public:
+    // Creates a pool able to run n tasks at once (n-1 background threads)
+    // If pin is true, worker i is bound to core i (Linux only)
+    explicit WorkerPool(int n, bool pin=false);
+    ~WorkerPool();
+
+    int size() { return nworkers; }
+    bool ispinned() { return pinned; }
+
+    // Runs F(args[i]) for i in [0, n) and blocks until all of them have returned.
+    // The first exception thrown by a task is rethrown here.
+    void run(void *(*F)(void *), void **args, int n);
+};
+
+#endif  //EDDL_WORKERS_H
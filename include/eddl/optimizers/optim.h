@@ -33,6 +33,7 @@ public:
     Optimizer *orig;
 
     Optimizer();
+    virtual ~Optimizer() {}
 
     void set_clip_val(float v);
     void clip();
@@ -83,8 +84,6 @@ public:
 
     vtensor mT;
     vtensor vT;
-    vtensor mCap;
-    vtensor vCap;
 
     explicit Adam(float lr=0.01f, float beta_1=0.9f, float beta_2=0.999f, float epsilon=1e-8f, float weight_decay=0.0f, bool amsgrad=false);
     ~Adam();
@@ -193,7 +192,6 @@ public:
     float epsilon;
     float weight_decay;
 
-    vtensor gT;
     vtensor gT1;
 
     explicit RMSProp(float lr=0.01f, float rho=0.9f, float epsilon=1e-8f, float weight_decay=0.0f);
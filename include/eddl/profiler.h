@@ -0,0 +1,84 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.7
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: April 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#ifndef EDDL_PROFILER_H
+#define EDDL_PROFILER_H
+
+#include <atomic>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#define PROF_FORWARD  0
+#define PROF_BACKWARD 1
+#define PROF_UPDATE   2
+#define PROF_KERNEL   3
+
+// Profiler of the layers and of the kernels they run. Every thread records
+// its own events, so the forward of the per-snet threads and nested kernels
+// are timed without locks. When disabled each probe is a relaxed load.
+// The events are read (summaries, trace) while the nets are idle.
+
+struct ProfEvent {
+    string name;       // layer, or kernel
+    string layer;      // layer running the kernel (kernels only)
+    int phase;         // PROF_*
+    int tid;           // thread, in order of their first event
+    long long start;   // ns since the recording started
+    long long dur;
+    long long bytes;   // allocated by the thread during the event
+};
+
+struct ProfStats {
+    long long calls[3];  // forward, backward, update
+    long long ns[3];
+    long long bytes;
+};
+
+extern std::atomic<bool> prof_on;
+
+inline bool prof_enabled() { return prof_on.load(std::memory_order_relaxed); }
+
+// Starts a new recording (the events of the last one are dropped), or stops it
+void prof_enable(bool enable);
+
+// Scopes of the calling thread: a layer call, or a kernel (a static name)
+void prof_begin(const string &layer, int phase);
+void prof_end();
+void prof_kernel_begin(const char *kernel);
+void prof_kernel_end(const char *kernel);
+
+// Events of all the threads, by start time
+vector<ProfEvent> prof_events();
+
+// Layer calls by layer name
+map<string, ProfStats> prof_layer_stats();
+
+// Time and calls of each kernel
+string prof_kernel_summary();
+
+// Chrome trace event format (chrome://tracing, Perfetto)
+void prof_save_trace(const string &fname);
+
+// Times a layer call when the profiler is enabled
+class ProfScope {
+public:
+    ProfScope(const string &layer, int phase) {
+        on = prof_enabled();
+        if (on) prof_begin(layer, phase);
+    }
+    ~ProfScope() { if (on) prof_end(); }
+
+private:
+    bool on;
+};
+
+#endif //EDDL_PROFILER_H
@@ -10,14 +10,56 @@
 #ifndef EDDL_RANDOM_H
 #define EDDL_RANDOM_H
 
+#include <cstdint>
+
+// Counter-based generator (Philox4x32-10, Salmon et al. 2011).
+// Every draw is a pure function of the seed and of its counter, so kernels
+// reserve a range of counters and fill it from any number of threads with
+// the same result.
+void set_rand_seed(uint64_t seed);
+uint64_t get_rand_seed();
+// First counter of n consecutive fresh draws
+uint64_t reserve_rand(uint64_t n);
+
+// 4 random 32-bit words of block ctr
+inline void philox4x32(uint64_t ctr, uint64_t key, uint32_t out[4]) {
+    uint32_t c0 = (uint32_t) ctr, c1 = (uint32_t) (ctr >> 32), c2 = 0, c3 = 0;
+    uint32_t k0 = (uint32_t) key, k1 = (uint32_t) (key >> 32);
+
+    for (int r = 0; r < 10; r++) {
+        uint64_t p0 = (uint64_t) 0xD2511F53u * c0;
+        uint64_t p1 = (uint64_t) 0xCD9E8D57u * c2;
+        uint32_t n0 = (uint32_t) (p1 >> 32) ^ c1 ^ k0;
+        uint32_t n2 = (uint32_t) (p0 >> 32) ^ c3 ^ k1;
+        c1 = (uint32_t) p1;
+        c3 = (uint32_t) p0;
+        c0 = n0;
+        c2 = n2;
+        k0 += 0x9E3779B9u;
+        k1 += 0xBB67AE85u;
+    }
+    out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+}
+
+// [0,1) float from the 24 high bits of a word
+inline float rand_word_to_float(uint32_t x) {
+    return (x >> 8) * (1.0f / 16777216.0f);
+}
+
+// Draw number ctr of the stream
+float uniform_at(uint64_t ctr, float min=0.0f, float max=1.0f);
+
+// Bulk generation of n values, parallel over blocks of 4 draws
+void fill_uniform(float *p, long int n, float min, float max);
+void fill_binary(float *p, long int n, float v);
+void fill_normal(float *p, long int n, float mean, float sd);
+
 float gaussgen();
-void build_randn_table();
 
 float uniform(float min=0.0f, float max=1.0f);
 float signed_uniform();
 
 float slow_randn(float mean, float sd);
-float fast_randn(float mean, float sd, int seed);
 
 
 #endif //EDDL_RANDOM_H
@@ -17,10 +17,13 @@ namespace tensorNN{
 
 // ***** Losses *****************************
     void cent(Tensor *A, Tensor *B, Tensor *C);
+    float softmax_cent(Tensor *T, Tensor *Y, Tensor *D);
+    float sparse_cent(Tensor *T, Tensor *Y, Tensor *D, bool softmax);
 
 // ***** Metrics *****************************
 int accuracy(Tensor *A, Tensor *B);
 int bin_accuracy(Tensor *A, Tensor *B);
+int sparse_accuracy(Tensor *T, Tensor *Y);
 
 
 // ***** Activations *****************************
@@ -71,6 +74,11 @@ int bin_accuracy(Tensor *A, Tensor *B);
     void Linear(Tensor *A, Tensor *B, float param);
     void D_Linear(Tensor *D, Tensor *I, Tensor *PD, float param);
 
+// Bias + activation epilogue of Conv and Dense (CPU): O = act(O + bias), and
+// D *= act'(.) computed from the output O
+    void bias_act(Tensor *O, Tensor *bias, int act, float param);
+    void d_act(Tensor *D, Tensor *O, int act, float param);
+
 // ***** Deep Learning *****************************
 // Conv2D
     void Conv2D(ConvolDescriptor *D);
@@ -86,6 +94,21 @@ int bin_accuracy(Tensor *A, Tensor *B);
     void AvgPool2D(PoolDescriptor *D);
     void AvgPool2D_back(PoolDescriptor *D);
 
+// ***** Dropout *****************************
+    void dropout_forward(Tensor *A, Tensor *B, unsigned int *mask, float keep, float scale);
+    void dropout_backward(Tensor *D, Tensor *PD, unsigned int *mask, float scale);
+
+// ***** LSTM *****************************
+    void lstm_forward(Tensor *X, Tensor *G, Tensor *bias, Tensor *hprev, Tensor *cprev,
+                      Tensor *mask, Tensor *sh, Tensor *h, Tensor *c);
+    void lstm_backward(Tensor *G, Tensor *cprev, Tensor *sh, Tensor *mask, Tensor *dh, Tensor *dc,
+                       Tensor *DG, Tensor *dhprev, Tensor *dcprev);
+    // Generic tensor operations, run by the devices without a fused kernel (GPU)
+    void lstm_forward_unfused(Tensor *X, Tensor *G, Tensor *bias, Tensor *hprev, Tensor *cprev,
+                              Tensor *mask, Tensor *sh, Tensor *h, Tensor *c);
+    void lstm_backward_unfused(Tensor *G, Tensor *cprev, Tensor *sh, Tensor *mask, Tensor *dh, Tensor *dc,
+                               Tensor *DG, Tensor *dhprev, Tensor *dcprev);
+
 // ***** Tensor operations *****************************
     void repeat_nn(Tensor *A, Tensor *B, vector<int> size);
     void d_repeat_nn(Tensor *D, Tensor *P, vector<int> size);
@@ -95,12 +118,23 @@ int bin_accuracy(Tensor *A, Tensor *B);
     void set_select(Tensor *A, Tensor *B, SelDescriptor *sd);
     void set_select_back(Tensor *A, Tensor* B, SelDescriptor *sd);
 
+// ***** Optimizers (fused single-pass updates) ********************
+    void sgd_update(Tensor *P, Tensor *G, Tensor *M, float lr, float mu, float weight_decay, bool nesterov);
+    void adam_update(Tensor *P, Tensor *G, Tensor *M, Tensor *V, float lr, float beta_1, float beta_2, float epsilon, float weight_decay, int t);
+    void sgd_update_rows(Tensor *P, Tensor *G, Tensor *M, const vector<int> &rows, float lr, float mu, float weight_decay, bool nesterov);
+    void adam_update_rows(Tensor *P, Tensor *G, Tensor *M, Tensor *V, const vector<int> &rows, float lr, float beta_1, float beta_2, float epsilon, float weight_decay, int t);
+    void rmsprop_update(Tensor *P, Tensor *G, Tensor *G1, float lr, float rho, float epsilon, float weight_decay);
+
 // ***** Permutations for BatchNorm ********************
     void permute_channels_last(Tensor *A,Tensor *B);
     void permute_channels_first(Tensor *A,Tensor *B);
     void permute_batch_last(Tensor *A,Tensor *B);
     void permute_batch_first(Tensor *A,Tensor *B);
 
+// ***** Fused BatchNorm (NCHW, CPU) *******************
+    void batchnorm_forward(Tensor *input, Tensor *output, Tensor *opa, Tensor *global_mean, Tensor *global_variance, Tensor *affine_g, Tensor *affine_b, Tensor *mean, Tensor *variance, bool trmode, float epsilon, float momentum);
+    void batchnorm_backward(Tensor *delta, Tensor *opa, Tensor *pdelta, Tensor *variance, Tensor *affine_g, Tensor *gaffine_g, Tensor *gaffine_b, Tensor *mdelta, Tensor *mdelta_opa);
+
 }
 
 #endif //EDDL_TENSOR_NN_H
@@ -19,6 +19,7 @@
 
 #ifdef cFPGA
 #include "eddl/hardware/fpga/xcl2.hpp"
+#include "eddl/hardware/host_mirror.h"
 #endif
 
 #include "Eigen/Dense"
@@ -93,12 +94,17 @@ public:
     int gpu_device;
     mutex *tsem;  // Multithreading. Tensor semaphore
 
+    // File mapping backing ptr (see load_mmap)
+    void *mmap_base = nullptr;
+    size_t mmap_length = 0;
+
 #ifdef cFPGA
     // fpga-related information
     int fpga_device;         // fpga device
     cl::Buffer *fpga_ptr;     // open-cl buffer pointer to data
     int fpga_tensor_id;      // for debuging and tracking tensors
     long int fpga_size;      // buffer size (in elements)
+    HostMirror *fpga_mirror; // coherence of ptr and fpga_ptr, shared by every alias of the buffer
 #endif
 
     // Constructors
@@ -158,7 +164,7 @@ public:
     void updateShape(const vector<int> &new_shape);
     void updateSize();
     void updateStrides();
-    void updateData(float* ptr, void *ptr2=NULL);
+    void updateData(float* ptr, void *ptr2=NULL, void *ptr3=NULL);
     void deleteData();
 
     /**
@@ -254,6 +260,19 @@ public:
     static Tensor* load(const string& filename, string format="");
     template<typename T> static Tensor* load(const string& filename, string format="");
 
+    /**
+      *  @brief Map a "bin" file into memory instead of reading it.
+      *
+      *  The tensor data points into the mapping: no copy is made, the pages are loaded on demand and
+      *  shared through the page cache by every process mapping the same file. Writes to the tensor
+      *  are private (copy-on-write) and never reach the file.
+      *  Falls back to Tensor::load on systems without mmap.
+      *
+      *  @param filename  Name of the file to map.
+      *  @return    Tensor (CPU)
+    */
+    static Tensor* load_mmap(const string& filename);
+
     /**
       *  @brief Load data from a text file
       *
@@ -2568,7 +2587,7 @@ public:
       *
       *  @return
     */
-    void resize(int b, float *fptr=nullptr, void *fptr2=nullptr);
+    void resize(int b, float *fptr=nullptr, void *fptr2=nullptr, void *fptr3=nullptr);
 
 
     // ***********************************************************
@@ -20,6 +20,8 @@ void msg(const string& text, const string& title="");
 
 float *get_fmem(unsigned long int size, const string &str);
 
+void free_fmem(float *ptr);
+
 string bytes2human(unsigned long long int bytes, int decimals=2);
 
 unsigned long get_free_mem();
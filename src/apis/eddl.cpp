@@ -15,6 +15,7 @@
 #include <stdexcept>
 
 #include "eddl/apis/eddl.h"
+#include "eddl/profiler.h"
 
 
 using namespace std;
@@ -91,6 +92,10 @@ namespace eddl {
         net->build(o, l, m, cs, init_weights);
     }
 
+    void freeze(model net){
+        net->freeze();
+    }
+
     // Computing services
 
     // GPU
@@ -197,9 +202,22 @@ namespace eddl {
     {
         net->setlogfile(fname);
     }
+    void set_rnet_cache(model net, int size, int bucket)
+    {
+        net->set_rnet_cache(size, bucket);
+    }
     void summary(model m){
         cout<<m->summary()<<"\n";
     }
+    void set_profiling(bool enable){
+        prof_enable(enable);
+    }
+    void profile_summary(model m){
+        cout<<m->profile_summary()<<"\n";
+    }
+    void save_profile(const string& fname){
+        prof_save_trace(fname);
+    }
     void plot(model m, string fname,string mode){
         m->plot(fname,mode);
     }
@@ -260,9 +278,19 @@ namespace eddl {
     void evaluate(model net, const vector<Tensor *> &in, const vector<Tensor *> &out){
         net->evaluate(in, out);
     }
-    vector<Tensor *>  predict(model m, const vector<Tensor *> &in)
+    void set_sampling(model m, bool stratified, bool drop_last, int prefetch){
+        m->set_sampling(stratified, drop_last, prefetch);
+    }
+    void set_seed(model m, int seed){
+        m->set_seed(seed);
+    }
+    vector<Tensor *>  predict(model m, const vector<Tensor *> &in, int batch)
     {
-      return m->predict(in);
+      return m->predict(in, batch);
+    }
+    void predict(model m, const vector<Tensor *> &in, int batch, predict_callback F, void *arg)
+    {
+      m->predict(in, batch, F, arg);
     }
 
     // Finer methods
@@ -407,6 +435,10 @@ namespace eddl {
             return new LCrossEntropy();
         } else if (type == "soft_cross_entropy"){
             return new LSoftCrossEntropy();
+        } else if (type == "sparse_categorical_cross_entropy"){
+            return new LSparseCrossEntropy();
+        } else if (type == "sparse_soft_cross_entropy"){
+            return new LSparseSoftCrossEntropy();
         }
         else if (type == "dice"){
             return new LDice();
@@ -431,6 +463,9 @@ namespace eddl {
         } else if (type == "categorical_accuracy" || type == "accuracy"){
             return new MCategoricalAccuracy();
         }
+        else if (type == "sparse_categorical_accuracy"){
+            return new MSparseCategoricalAccuracy();
+        }
         else if (type == "binary_accuracy"){
             return new MBinAccuracy();
         }
@@ -568,6 +603,7 @@ namespace eddl {
 
         kernel_size.push_back(1);
         strides.push_back(1);
+        dilation_rate.push_back(1);
         LConv *lc=new LConv(l, filters, kernel_size, strides, padding, groups, dilation_rate, use_bias, name, DEV_CPU, 0);
 
         vector<int> shape2=lc->output->getShape();
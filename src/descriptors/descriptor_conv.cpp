@@ -57,6 +57,24 @@ ConvolDescriptor::ConvolDescriptor(int filters, const vector<int> &ks, const vec
 
 }
 
+ConvolDescriptor::ConvolDescriptor(int filters, const vector<int> &ks, const vector<int> &st, const string& p, bool ub,
+                                   int groups, const vector<int> &dilation_rate, int mem) : ConvolDescriptor(filters, ks, st, p, ub, mem) {
+    if (dilation_rate.size() != 2) { msg("Dilation rates must have 2 dimensions", "ConvolDescriptor::ConvolDescriptor"); }
+    if (groups < 1) { msg("Groups must be > 0", "ConvolDescriptor::ConvolDescriptor"); }
+    if (dilation_rate[0] < 1 || dilation_rate[1] < 1) { msg("Dilation rates must be > 0", "ConvolDescriptor::ConvolDescriptor"); }
+    if (filters % groups) { msg("The number of filters must be divisible by groups", "ConvolDescriptor::ConvolDescriptor"); }
+
+    this->groups = groups;
+    dr = dilation_rate[0];
+    dc = dilation_rate[1];
+}
+
+
+ConvolDescriptor::~ConvolDescriptor() {
+    // Tensors belong to the layer, only the CPU work buffers are ours
+    free_fmem(ptrgKt);
+    free_fmem(ptrU);
+}
 
 void ConvolDescriptor::build(Tensor *A) {
 
@@ -67,7 +85,11 @@ void ConvolDescriptor::build(Tensor *A) {
     nk = ksize[0];
     kr = ksize[1];
     kc = ksize[2];
-    kz = A->shape[1];
+    if (A->shape[1] % groups) msg("The input channels must be divisible by groups", "ConvolDescriptor::build");
+    if (nk % groups) msg("The number of filters must be divisible by groups", "ConvolDescriptor::build");
+    if (!A->isCPU() && (groups > 1 || dr > 1 || dc > 1))
+        msg("Grouped and dilated convolutions are only implemented on CPU", "ConvolDescriptor::build");
+    kz = A->shape[1] / groups;
 
     sr = stride[0];
     sc = stride[1];
@@ -80,26 +102,26 @@ void ConvolDescriptor::build(Tensor *A) {
         // Compute output
         z = nk;
         vector<int>pr; pr.push_back(pad[0]);pr.push_back(pad[1]);
-        r = compute_output(pr, ir, kr, sr);
+        r = compute_output(pr, ir, kr, sr, dr);
 
         vector<int>pc; pc.push_back(pad[2]);pc.push_back(pad[3]);
-        c = compute_output(pc, ic, kc, sc);
+        c = compute_output(pc, ic, kc, sc, dc);
 
     }else{  // Common padding (same/zeros)
         // Compute output
         z = nk;
 
-        if (padding=="same,none") r = compute_output("same", ir, kr, sr);
-        else if (padding=="none,same")  r = compute_output("none", ir, kr, sr);
-        else r = compute_output(this->padding, ir, kr, sr);
+        if (padding=="same,none") r = compute_output("same", ir, kr, sr, dr);
+        else if (padding=="none,same")  r = compute_output("none", ir, kr, sr, dr);
+        else r = compute_output(this->padding, ir, kr, sr, dr);
 
-        if (padding=="same,none") c = compute_output("none", ic, kc, sc);
-        else if (padding=="none,same")  c = compute_output("same", ic, kc, sc);
-        else c = compute_output(this->padding, ic, kc, sc);
+        if (padding=="same,none") c = compute_output("none", ic, kc, sc, dc);
+        else if (padding=="none,same")  c = compute_output("same", ic, kc, sc, dc);
+        else c = compute_output(this->padding, ic, kc, sc, dc);
 
-        // Compute padding
-        vector<int> padr = compute_padding(r, ir, kr, sr, this->padding,true);  // Order: [top, bottom]
-        vector<int> padc = compute_padding(c, ic, kc, sc, this->padding,false);  // Order: [left, right]
+        // Compute padding (with the dilated extent of the kernel)
+        vector<int> padr = compute_padding(r, ir, (kr-1)*dr+1, sr, this->padding,true);  // Order: [top, bottom]
+        vector<int> padc = compute_padding(c, ic, (kc-1)*dc+1, sc, this->padding,false);  // Order: [left, right]
 
         // Set padding
         pad = {padr[0], padr[1], padc[0], padc[1]};  // top, bottom, left, right
@@ -123,16 +145,23 @@ void ConvolDescriptor::build(Tensor *A) {
     gK = new Tensor(vector<int>{nk, kz, kr, kc}, I->device);
     gbias = new Tensor(vector<int>{nk}, I->device);
 
-    if (I->isCPU()) {
-        // mem for ptr, lowering im2col
-        ptrI=get_fmem(A->shape[0] * r * c * kr * kc * kz,"ConvolDescriptor::build");
-	 _profile_add_tensor(A->shape[0] * r * c * kr * kc * kz);
-        new(&matK) Eigen::Map<Eigen::MatrixXf>(K->ptr, kr * kc * kz, nk);
-        new(&matgK) Eigen::Map<Eigen::MatrixXf>(gK->ptr, kr * kc * kz, nk);
-        // convolution: matC=matA*matK
-    }
+    // CPU algorithm: 1x1 kernels are a plain GEMM over the input planes,
+    // 3x3 stride 1 kernels with enough channels use Winograd F(2x2,3x3) and
+    // one input channel per group (depthwise) is computed directly
+    bool dense=(groups==1)&&(dr==1)&&(dc==1);
+    if (dense&&(kr==1)&&(kc==1)&&(sr==1)&&(sc==1)&&(padrt==0)&&(padrb==0)&&(padcl==0)&&(padcr==0))
+        algo=CONV_ALGO_GEMM1X1;
+    else if (dense&&(kr==3)&&(kc==3)&&(sr==1)&&(sc==1)&&(kz>=8)&&(nk>=8))
+        algo=CONV_ALGO_WINOGRAD;
+    else if ((groups>1)&&(kz==1))
+        algo=CONV_ALGO_DEPTHWISE;
+    else
+        algo=CONV_ALGO_IM2COL;
+
+    // CPU: im2col is done in tiles on a workspace shared by all the
+    // convolutions (see cpu_set_conv_workspace), nothing to allocate here
 #ifdef cGPU
-    else if (I->isGPU()) {
+    if (I->isGPU()) {
 
         if (mem_level>1) {
             // Lowering
@@ -185,13 +214,8 @@ void ConvolDescriptor::resize(int b)
     O->resize(b);
 //    if (!mem_level) D->resize(b);
 
-    if (I->isCPU()) {
-        delete ptrI;
-        ptrI=get_fmem(b * r * c * kr * kc * kz, "ConvolDescriptor::build");
-	 _profile_add_tensor(b * r * c * kr * kc * kz);
-    }
 #ifdef cGPU
-    else if (I->isGPU()) {
+    if (I->isGPU()) {
         if (mem_level<2)
             gpuIB->resize(b*r*c);
         if (mem_level==0) {
@@ -202,13 +226,13 @@ void ConvolDescriptor::resize(int b)
 #endif
 
 #ifdef cFPGA
-    else if (I->isFPGA()) {
+    if (I->isFPGA()) {
         // We reallocate memory on the FGPA for the im2col buffer
 	fpga_destroy_memory(fpga_ptrI);
 	fpga_sizeI = b * r * c * kr * kc * kz * sizeof(float);
         fpga_ptrI = fpga_create_memory(fpga_sizeI);
         // We do the same on the CPU side (for smooth cpuemu)
-	delete ptrI;
+	free_fmem(ptrI);
         ptrI=get_fmem(b * r * c * kr * kc * kz, "ConvolDescriptor::build");
     }
 #endif
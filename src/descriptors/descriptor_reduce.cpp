@@ -19,9 +19,33 @@
 #endif
 
 
+int reduce_mode(const string &mode)
+{
+  if (mode=="mean") return REDUCE_MEAN;
+  else if (mode=="sum") return REDUCE_SUM;
+  else if (mode=="max") return REDUCE_MAX;
+  else if (mode=="min") return REDUCE_MIN;
+  else if (mode=="variance") return REDUCE_VAR;
+  msg("Incorrect reduction mode " + mode, "reduce_mode");
+  return -1;
+}
+
+int reduce_op_mode(const string &op)
+{
+  if (op=="sum") return REDUCE_OP_SUM;
+  else if (op=="diff") return REDUCE_OP_DIFF;
+  else if (op=="mult") return REDUCE_OP_MULT;
+  else if (op=="div") return REDUCE_OP_DIV;
+  msg("Incorrect reduction op " + op, "reduce_op_mode");
+  return -1;
+}
+
+
 MapReduceDescriptor::MapReduceDescriptor(Tensor *A,vector<int> axis)
 {
-  ind=get_reduction_map(A,axis);
+  this->axis=axis;
+  // The CPU kernels work from the strides
+  ind=A->isGPU() ? get_reduction_map(A,axis) : nullptr;
   gind=nullptr;
 }
 
@@ -49,12 +73,8 @@ ReduceDescriptor::ReduceDescriptor(Tensor *A, vector<int> axis, string mode, boo
 
 
 
-  // Select mode (TODO: enumerations are preferred)
-  if (mode=="mean") m=0;
-  else if (mode=="sum") m=1;
-  else if (mode=="max") m=2;
-  else if (mode=="min") m=3;
-  else
+  m=reduce_mode(mode);
+  if (m==REDUCE_VAR)
       msg("Incorrect reduction mode", "ReduceDescriptor");
 
 
@@ -78,7 +98,7 @@ ReduceDescriptor::ReduceDescriptor(Tensor *A, vector<int> axis, string mode, boo
   O=new Tensor(os,dev);
 //  D=new Tensor(os,dev);
 
-  if ((m==2)||(m==3))
+  if ((m==REDUCE_MAX)||(m==REDUCE_MIN))
    S=new Tensor(os,dev);
   else S=nullptr;
 
@@ -91,6 +111,9 @@ void ReduceDescriptor::build_index() {
   // get indexes for reduction
   index.clear();
 
+  // Only the GPU kernels use them, CPU and FPGA work from the strides
+  if (!I->isGPU()) return;
+
   vector<int> ind;
   ind.push_back(0);
   for(int i=0;i<I->ndim;i++) {
@@ -146,7 +169,7 @@ void ReduceDescriptor::resize(int b)
   if ((keepdims)||(i==axis.size())) {
     O->resize(b);
 //    D->resize(b);
-    if ((m==2)||(m==3))
+    if ((m==REDUCE_MAX)||(m==REDUCE_MIN))
       S->resize(b);
   }
   ind=nullptr;
@@ -0,0 +1,312 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.7
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: April 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <cstdlib>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <unordered_map>
+
+#include "eddl/system_info.h"
+#include "eddl/utils.h"
+#include "eddl/hardware/cpu/cpu_allocator.h"
+
+#ifdef EDDL_LINUX
+#include <sys/mman.h>
+#endif
+#ifdef EDDL_WINDOWS
+#include <malloc.h>
+#endif
+
+using namespace std;
+
+#define FMEM_CLASSES 169                 // blocks up to 2^48 bytes
+#define FMEM_SHARDS 64
+#define FMEM_THREAD_CACHE (32UL << 20)   // free bytes kept by each thread
+#define FMEM_THREAD_BLOCK (4UL << 20)    // larger blocks go to the shared cache
+#define FMEM_CACHE_LIMIT (512UL << 20)   // default limit of the shared cache
+
+
+// Class of a request of bytes (> 0), and the bytes of its blocks.
+// Up to 64 bytes: one class. Then 4 classes per power of two: (2^e, 2^(e+1)]
+// is split in steps of 2^(e-2), so at most 25% of a block is wasted.
+static int size_class(size_t bytes, size_t &cbytes) {
+    if (bytes <= FMEM_ALIGN) {
+        cbytes = FMEM_ALIGN;
+        return 0;
+    }
+    int e = 0;
+    for (size_t v = bytes - 1; v >>= 1;) e++;
+    size_t q = (bytes + ((size_t) 1 << (e - 2)) - 1) >> (e - 2);  // 5..8
+    cbytes = q << (e - 2);
+    return 1 + (e - 6) * 4 + (int) (q - 5);
+}
+
+static size_t class_bytes(int cls) {
+    if (cls == 0) return FMEM_ALIGN;
+    int e = 6 + (cls - 1) / 4;
+    return (size_t) (5 + (cls - 1) % 4) << (e - 2);
+}
+
+
+struct FmemState {
+    // Every block of the allocator (live or cached) and its class
+    mutex shard_mutex[FMEM_SHARDS];
+    unordered_map<float *, int> blocks[FMEM_SHARDS];
+
+    // Shared free lists
+    mutex cache_mutex;
+    vector<float *> cache[FMEM_CLASSES];
+    size_t cache_bytes = 0;
+    size_t cache_limit = FMEM_CACHE_LIMIT;
+
+    atomic<bool> huge_pages{false};
+
+    atomic<unsigned long long> allocs{0}, frees{0}, hits{0}, refills{0}, releases{0};
+    atomic<unsigned long long> in_use{0}, peak{0}, cached{0}, huge_blocks{0};
+};
+
+// Never destroyed: tensors may be freed by static destructors
+static FmemState &fmem() {
+    static FmemState *s = new FmemState();
+    return *s;
+}
+
+static int shard_of(float *ptr) {
+    return (int) (((uintptr_t) ptr / FMEM_ALIGN) % FMEM_SHARDS);
+}
+
+
+static float *system_alloc(size_t bytes) {
+    void *p = nullptr;
+#ifdef EDDL_WINDOWS
+    p = _aligned_malloc(bytes, FMEM_ALIGN);
+#else
+    bool huge = fmem().huge_pages && bytes >= FMEM_HUGE_PAGE;
+    if (posix_memalign(&p, huge ? FMEM_HUGE_PAGE : FMEM_ALIGN, bytes) != 0) p = nullptr;
+#if defined(EDDL_LINUX) && defined(MADV_HUGEPAGE)
+    if (p != nullptr && huge && madvise(p, bytes, MADV_HUGEPAGE) == 0) fmem().huge_blocks++;
+#endif
+#endif
+    return (float *) p;
+}
+
+static void system_free(float *ptr) {
+#ifdef EDDL_WINDOWS
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+// Unregisters a free block and gives it back to the system
+static void release(float *ptr) {
+    FmemState &s = fmem();
+    int sh = shard_of(ptr);
+    {
+        lock_guard<mutex> lock(s.shard_mutex[sh]);
+        s.blocks[sh].erase(ptr);
+    }
+    system_free(ptr);
+    s.releases++;
+}
+
+// Into the shared cache, or back to the system when it is full
+static void cache_push(float *ptr, int cls, size_t cbytes) {
+    FmemState &s = fmem();
+    {
+        lock_guard<mutex> lock(s.cache_mutex);
+        if (s.cache_bytes + cbytes <= s.cache_limit) {
+            s.cache[cls].push_back(ptr);
+            s.cache_bytes += cbytes;
+            s.cached += cbytes;
+            return;
+        }
+    }
+    release(ptr);
+}
+
+
+struct ThreadCache {
+    vector<float *> lists[FMEM_CLASSES];
+    size_t bytes = 0;
+
+    ~ThreadCache();
+};
+
+// Trivially destructible, so it can be checked while thread_local objects die
+static thread_local bool tcache_dead = false;
+static thread_local ThreadCache tcache;
+
+ThreadCache::~ThreadCache() {
+    tcache_dead = true;
+    for (int c = 0; c < FMEM_CLASSES; c++) {
+        size_t cb = class_bytes(c);
+        for (float *p : lists[c]) {
+            fmem().cached -= cb;
+            cache_push(p, c, cb);
+        }
+        lists[c].clear();
+    }
+    bytes = 0;
+}
+
+
+// Bytes handed out to the calling thread (profiler)
+static thread_local unsigned long long tallocated = 0;
+
+static void count_alloc(size_t cbytes) {
+    FmemState &s = fmem();
+    s.allocs++;
+    tallocated += cbytes;
+    unsigned long long now = (s.in_use += cbytes);
+    unsigned long long peak = s.peak;
+    while (now > peak && !s.peak.compare_exchange_weak(peak, now));
+}
+
+float *fmem_alloc(size_t size) {
+    FmemState &s = fmem();
+    size_t cbytes;
+    int cls = size_class((size > 0 ? size : 1) * sizeof(float), cbytes);
+    if (cls >= FMEM_CLASSES) return nullptr;
+
+    // Thread free list
+    if (!tcache_dead && !tcache.lists[cls].empty()) {
+        float *p = tcache.lists[cls].back();
+        tcache.lists[cls].pop_back();
+        tcache.bytes -= cbytes;
+        s.cached -= cbytes;
+        s.hits++;
+        count_alloc(cbytes);
+        return p;
+    }
+
+    // Shared free list
+    {
+        lock_guard<mutex> lock(s.cache_mutex);
+        if (!s.cache[cls].empty()) {
+            float *p = s.cache[cls].back();
+            s.cache[cls].pop_back();
+            s.cache_bytes -= cbytes;
+            s.cached -= cbytes;
+            s.hits++;
+            count_alloc(cbytes);
+            return p;
+        }
+    }
+
+    // Refill from the system. Cached blocks are returned first when the
+    // request does not fit in the free memory.
+    float *p = nullptr;
+    if (get_free_mem() >= cbytes) p = system_alloc(cbytes);
+    if (p == nullptr) {
+        fmem_trim();
+        if (get_free_mem() >= cbytes) p = system_alloc(cbytes);
+        if (p == nullptr) return nullptr;
+    }
+    int sh = shard_of(p);
+    {
+        lock_guard<mutex> lock(s.shard_mutex[sh]);
+        s.blocks[sh][p] = cls;
+    }
+    s.refills++;
+    count_alloc(cbytes);
+    return p;
+}
+
+bool fmem_free(float *ptr) {
+    if (ptr == nullptr) return false;
+    FmemState &s = fmem();
+    int cls;
+    int sh = shard_of(ptr);
+    {
+        lock_guard<mutex> lock(s.shard_mutex[sh]);
+        auto it = s.blocks[sh].find(ptr);
+        if (it == s.blocks[sh].end()) return false;
+        cls = it->second;
+    }
+    size_t cbytes = class_bytes(cls);
+    s.frees++;
+    s.in_use -= cbytes;
+
+    if (!tcache_dead && cbytes <= FMEM_THREAD_BLOCK && tcache.bytes + cbytes <= FMEM_THREAD_CACHE) {
+        tcache.lists[cls].push_back(ptr);
+        tcache.bytes += cbytes;
+        s.cached += cbytes;
+    } else {
+        cache_push(ptr, cls, cbytes);
+    }
+    return true;
+}
+
+void fmem_trim() {
+    FmemState &s = fmem();
+    vector<float *> freed;
+    if (!tcache_dead) {
+        for (int c = 0; c < FMEM_CLASSES; c++) {
+            s.cached -= class_bytes(c) * tcache.lists[c].size();
+            freed.insert(freed.end(), tcache.lists[c].begin(), tcache.lists[c].end());
+            tcache.lists[c].clear();
+        }
+        tcache.bytes = 0;
+    }
+    {
+        lock_guard<mutex> lock(s.cache_mutex);
+        for (int c = 0; c < FMEM_CLASSES; c++) {
+            freed.insert(freed.end(), s.cache[c].begin(), s.cache[c].end());
+            s.cache[c].clear();
+        }
+        s.cached -= s.cache_bytes;
+        s.cache_bytes = 0;
+    }
+    for (float *p : freed) release(p);
+}
+
+FmemStats fmem_stats() {
+    FmemState &s = fmem();
+    FmemStats st;
+    st.allocs = s.allocs;
+    st.frees = s.frees;
+    st.hits = s.hits;
+    st.refills = s.refills;
+    st.releases = s.releases;
+    st.bytes_in_use = s.in_use;
+    st.peak_bytes_in_use = s.peak;
+    st.bytes_cached = s.cached;
+    st.huge_blocks = s.huge_blocks;
+    return st;
+}
+
+unsigned long long fmem_thread_allocated() {
+    return tallocated;
+}
+
+void fmem_set_huge_pages(bool enable) {
+    fmem().huge_pages = enable;
+}
+
+void fmem_set_cache_limit(size_t bytes) {
+    FmemState &s = fmem();
+    vector<float *> freed;
+    {
+        lock_guard<mutex> lock(s.cache_mutex);
+        s.cache_limit = bytes;
+        for (int c = FMEM_CLASSES - 1; c >= 0 && s.cache_bytes > s.cache_limit; c--) {
+            size_t cb = class_bytes(c);
+            while (!s.cache[c].empty() && s.cache_bytes > s.cache_limit) {
+                freed.push_back(s.cache[c].back());
+                s.cache[c].pop_back();
+                s.cache_bytes -= cb;
+                s.cached -= cb;
+            }
+        }
+    }
+    for (float *p : freed) release(p);
+}
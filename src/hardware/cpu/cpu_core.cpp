@@ -8,6 +8,7 @@
 */
 
 #include "eddl/hardware/cpu/cpu_tensor.h"
+#include "eddl/profiler.h"
 #include <algorithm>
 #include <numeric>
 
@@ -31,7 +32,6 @@
     #include <sys/time.h>
 #endif
 
-int num_instances[_NUM_CPU_FUNCS];
 float mb_memory_needed;
 
 void _profile_funcname(int i, char *name) {
@@ -182,36 +182,51 @@ case _CPU_AVGPOOL2D              : strcpy(name, "avgpool2d"); break;
 case _CPU_AVGPOOL2D_BACK         : strcpy(name, "avgpool2d_back"); break;
 case _CPU_REPEAT_NN              : strcpy(name, "repeat_nn"); break;
 case _CPU_D_REPEAT_NN            : strcpy(name, "d_repeat_nn"); break;
+case _CPU_SGD_UPDATE             : strcpy(name, "sgd_update"); break;
+case _CPU_ADAM_UPDATE            : strcpy(name, "adam_update"); break;
+case _CPU_RMSPROP_UPDATE         : strcpy(name, "rmsprop_update"); break;
+case _CPU_BATCHNORM_FORWARD      : strcpy(name, "batchnorm_forward"); break;
+case _CPU_BATCHNORM_BACKWARD     : strcpy(name, "batchnorm_backward"); break;
+case _CPU_SOFTMAX_CENT           : strcpy(name, "softmax_cent"); break;
+case _CPU_DROPOUT_FORWARD        : strcpy(name, "dropout_forward"); break;
+case _CPU_DROPOUT_BACKWARD       : strcpy(name, "dropout_backward"); break;
+case _CPU_SGD_UPDATE_ROWS        : strcpy(name, "sgd_update_rows"); break;
+case _CPU_ADAM_UPDATE_ROWS       : strcpy(name, "adam_update_rows"); break;
+case _CPU_SPARSE_CENT            : strcpy(name, "sparse_cent"); break;
+case _CPU_SPARSE_ACCURACY        : strcpy(name, "sparse_accuracy"); break;
+case _CPU_LSTM_FORWARD           : strcpy(name, "lstm_forward"); break;
+case _CPU_LSTM_BACKWARD          : strcpy(name, "lstm_backward"); break;
+case _CPU_PERMUTE                : strcpy(name, "permute"); break;
+case _CPU_BIAS_ACT               : strcpy(name, "bias_act"); break;
+case _CPU_D_ACT                  : strcpy(name, "d_act"); break;
 default                          : strcpy(name, "?????"); break;
 }
 }
 
-struct timeval time_ini[_NUM_CPU_FUNCS];
-unsigned long long acc_time[_NUM_CPU_FUNCS];
+// Names of the kernels, built once
+static const char *kernel_name(int f_id) {
+  static vector<string> names = []() {
+    vector<string> v(_NUM_CPU_FUNCS);
+    char name[50];
+    for (int i=0; i<_NUM_CPU_FUNCS; i++) {
+      _profile_funcname(i, name);
+      v[i] = name;
+    }
+    return v;
+  }();
+  return names[f_id].c_str();
+}
 
+// Kernel probes, recorded by the profiler of the calling thread (profiler.h)
 void _profile(int f_id, int end) {
-  num_instances[f_id]++;
-  if (!end) gettimeofday(&time_ini[f_id], NULL);
-  else {
-      timeval t1;
-      gettimeofday(&t1, NULL);
-      acc_time[f_id] += ((t1.tv_sec - time_ini[f_id].tv_sec) * 1000000) +
-                        (t1.tv_usec - time_ini[f_id].tv_usec);
-  }
+  if (!prof_enabled()) return;
+  if (!end) prof_kernel_begin(kernel_name(f_id));
+  else prof_kernel_end(kernel_name(f_id));
 }
 
 void _show_profile() {
-  #ifdef CPU_DEBUG
   printf("\nCPU functions called:\n");
-  for (int i=0; i<_NUM_CPU_FUNCS; i++) {
-    if (num_instances[i] != 0) {
-      char func_name[50];
-      _profile_funcname(i, func_name);
-      printf("%-50s: %d instances, %llu us\n", func_name, num_instances[i], acc_time[i]);
-    }
-  }
-  printf("Memory: %f MB\n", mb_memory_needed);
-  #endif
+  printf("%s", prof_kernel_summary().c_str());
 }
 
 void _profile_add_tensor(long size) {
@@ -312,6 +327,132 @@ void cpu_set_select_back(Tensor *A, Tensor *B, SelDescriptor *sd){
     _profile(_CPU_SET_SELECT_BACK, 1);
 }
 
+// B = A with its axes permuted by dims, straight from the strides. Unit axes are
+// dropped and input axes that stay adjacent in the output are merged, so only
+// the real moves remain. When the innermost axis moves, it is swapped with the
+// innermost output axis by cache tiles of 8x8 blocks.
+void cpu_permute(Tensor *A, Tensor *B, const vector<int> &dims){
+    _profile(_CPU_PERMUTE, 0);
+    int nd = A->ndim;
+
+    // Non-unit input axes, renumbered, in output order
+    vector<int> rank(nd, -1);
+    vector<long> rs;
+    for (int i = 0; i < nd; i++)
+        if (A->shape[i] > 1) { rank[i] = rs.size(); rs.push_back(A->shape[i]); }
+    vector<int> seq;
+    for (int d : dims) if (rank[d] >= 0) seq.push_back(rank[d]);
+
+    // Merge the runs of consecutive axes: gfirst[k] is the first axis of output group k
+    vector<int> gfirst;
+    vector<long> glen;
+    for (int k = 0; k < seq.size(); k++) {
+        if ((k > 0) && (seq[k] == seq[k - 1] + 1)) glen.back() *= rs[seq[k]];
+        else { gfirst.push_back(seq[k]); glen.push_back(rs[seq[k]]); }
+    }
+    int n = gfirst.size();
+
+    // Groups in input order: q[k] is the input group at output position k
+    vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int x, int y) { return gfirst[x] < gfirst[y]; });
+    vector<int> q(n);
+    vector<long> gs(n);
+    for (int g = 0; g < n; g++) {
+        q[order[g]] = g;
+        gs[g] = glen[order[g]];
+    }
+
+    bool identity = true;
+    for (int k = 0; k < n; k++) identity &= (q[k] == k);
+    if (identity) {
+        std::copy(A->ptr, A->ptr + A->size, B->ptr);
+        _profile(_CPU_PERMUTE, 1);
+        return;
+    }
+
+    vector<long> is(n), os(n);  // input and output strides of every group
+    long st = 1;
+    for (int g = n - 1; g >= 0; g--) { is[g] = st; st *= gs[g]; }
+    st = 1;
+    for (int k = n - 1; k >= 0; k--) { os[q[k]] = st; st *= gs[q[k]]; }
+
+    float *a = A->ptr;
+    float *b = B->ptr;
+    int last = n - 1;   // contiguous in the input
+    int inner = q[n - 1];  // contiguous in the output
+
+    // Remaining groups, walked in output order
+    vector<int> outer;
+    long nouter = 1;
+    for (int k = 0; k < n; k++)
+        if ((q[k] != last) && (q[k] != inner)) { outer.push_back(q[k]); nouter *= gs[q[k]]; }
+
+    if (inner == last) {
+        // The innermost axis stays in place: move whole rows
+        long nl = gs[last];
+        #pragma omp parallel for
+        for (long m = 0; m < nouter; m++) {
+            long r = m, ioff = 0, ooff = 0;
+            for (int k = outer.size() - 1; k >= 0; k--) {
+                int g = outer[k];
+                long x = r % gs[g];
+                r /= gs[g];
+                ioff += x * is[g];
+                ooff += x * os[g];
+            }
+            std::copy(a + ioff, a + ioff + nl, b + ooff);
+        }
+        _profile(_CPU_PERMUTE, 1);
+        return;
+    }
+
+    const int T = 64;
+    long na = gs[inner], nl = gs[last];
+    long ta = (na + T - 1) / T, tl = (nl + T - 1) / T;
+    long sa = is[inner], sl = os[last];
+
+    #pragma omp parallel for
+    for (long t = 0; t < nouter * ta * tl; t++) {
+        long m = t / (ta * tl);
+        long i0 = ((t / tl) % ta) * T;
+        long j0 = (t % tl) * T;
+
+        long ioff = 0, ooff = 0;
+        for (int k = outer.size() - 1; k >= 0; k--) {
+            int g = outer[k];
+            long x = m % gs[g];
+            m /= gs[g];
+            ioff += x * is[g];
+            ooff += x * os[g];
+        }
+
+        // b[ooff + i + j*sl] = a[ioff + i*sa + j]
+        long ie = std::min(i0 + T, na), je = std::min(j0 + T, nl);
+        for (long i = i0; i < ie; i += 8) {
+            for (long j = j0; j < je; j += 8) {
+                if ((i + 8 <= ie) && (j + 8 <= je)) {
+                    float blk[8][8];
+                    for (int r = 0; r < 8; r++) {
+                        const float *src = a + ioff + (i + r) * sa + j;
+                        for (int c = 0; c < 8; c++) blk[c][r] = src[c];
+                    }
+                    for (int c = 0; c < 8; c++) {
+                        float *dst = b + ooff + (j + c) * sl + i;
+                        for (int r = 0; r < 8; r++) dst[r] = blk[c][r];
+                    }
+                }
+                else {
+                    for (long r = i; r < std::min(i + 8, ie); r++)
+                        for (long c = j; c < std::min(j + 8, je); c++)
+                            b[ooff + c * sl + r] = a[ioff + r * sa + c];
+                }
+            }
+        }
+    }
+    _profile(_CPU_PERMUTE, 1);
+}
+
 
 void cpu_select(Tensor * A, Tensor * B, vector<int> sind, int ini, int end,bool mask_zeros){
     _profile(_CPU_SELECT2, 0);
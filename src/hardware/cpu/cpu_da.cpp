@@ -280,10 +280,11 @@ void cpu_shift_random(Tensor *A, Tensor *B, vector<float> factor_x, vector<float
     // https://docs.scipy.org/doc/scipy/reference/generated/scipy.ndimage.shift.html
 
     _profile(_CPU_SHIFT_RANDOM, 0);
+    uint64_t ctr = reserve_rand((uint64_t)2 * B->shape[0]);  // draws of sample b start at ctr + 2*b
 #pragma omp parallel for
     for(int b=0; b<B->shape[0]; b++) {
-        int shift_y = (int)(A->shape[2] * uniform(factor_y[0], factor_y[1]));
-        int shift_x = (int)(A->shape[3] * uniform(factor_x[0], factor_x[1]));
+        int shift_y = (int)(A->shape[2] * uniform_at(ctr + 2*b, factor_y[0], factor_y[1]));
+        int shift_x = (int)(A->shape[3] * uniform_at(ctr + 2*b + 1, factor_x[0], factor_x[1]));
 
         cpu_single_shift(b, A, B, {shift_y, shift_x}, mode, constant);
     }
@@ -293,9 +294,10 @@ void cpu_shift_random(Tensor *A, Tensor *B, vector<float> factor_x, vector<float
 void cpu_rotate_random(Tensor *A, Tensor *B, vector<float> factor, vector<int> offset_center, int mode, float constant){
     // https://docs.scipy.org/doc/scipy/reference/generated/scipy.ndimage.rotate.html
     _profile(_CPU_ROTATE_RANDOM, 0);
+    uint64_t ctr = reserve_rand(B->shape[0]);  // draw of sample b is ctr + b
 #pragma omp parallel for
     for(int b=0; b<B->shape[0]; b++) {
-        float angle =  uniform(factor[0], factor[1]);
+        float angle =  uniform_at(ctr + b, factor[0], factor[1]);
         cpu_single_rotate(b, A, B, angle, offset_center, mode, constant);
     }
     _profile(_CPU_ROTATE_RANDOM, 1);
@@ -307,9 +309,10 @@ void cpu_scale_random(Tensor *A, Tensor *B, vector<float> factor, int mode, floa
     // If the factor is less than 1.0f, performs a downscale with padding
 
     _profile(_CPU_SCALE_RANDOM, 0);
+    uint64_t ctr = reserve_rand(B->shape[0]);  // draw of sample b is ctr + b
 #pragma omp parallel for
     for(int b=0; b<B->shape[0]; b++) {
-        float scale = uniform(factor[0], factor[1]);
+        float scale = uniform_at(ctr + b, factor[0], factor[1]);
         int new_shape_y = (int)(A->shape[2] * scale);
         int new_shape_x = (int)(A->shape[3] * scale);
 
@@ -328,9 +331,10 @@ void cpu_flip_random(Tensor *A, Tensor *B, int axis){
 
 
     _profile(_CPU_FLIP_RANDOM, 0);
+    uint64_t ctr = reserve_rand(B->shape[0]);  // draw of sample b is ctr + b
 #pragma omp parallel for
     for(int b=0; b<B->shape[0]; b++) {
-        bool apply = uniform(0.0f, 1.0f) >= 0.5f;
+        bool apply = uniform_at(ctr + b, 0.0f, 1.0f) >= 0.5f;
         cpu_single_flip(b, apply, A, B, axis);
     }
     _profile(_CPU_FLIP_RANDOM, 1);
@@ -341,14 +345,15 @@ void cpu_crop_random(Tensor *A, Tensor *B){
     // Performs a crop with padding (Keeps the original size)
 
     _profile(_CPU_CROP_RANDOM, 0);
+    uint64_t ctr = reserve_rand((uint64_t)2 * B->shape[0]);  // draws of sample b start at ctr + 2*b
 #pragma omp parallel for
     for(int b=0; b<B->shape[0]; b++) {
 
         // Compute random coordinates
         int w = B->shape[3];
         int h = B->shape[2];
-        int x = (int)((A->shape[3]-w) * uniform(0.0f, 1.0f));
-        int y = (int)((A->shape[2]-h) * uniform(0.0f, 1.0f));
+        int x = (int)((A->shape[3]-w) * uniform_at(ctr + 2*b, 0.0f, 1.0f));
+        int y = (int)((A->shape[2]-h) * uniform_at(ctr + 2*b + 1, 0.0f, 1.0f));
 
         int coords_from_x = x;
         int coords_to_x = x+w;
@@ -367,15 +372,16 @@ void cpu_crop_random(Tensor *A, Tensor *B){
 void cpu_crop_scale_random(Tensor *A, Tensor *B, vector<float> factor, int mode, float constant){
 
     _profile(_CPU_CROP_SCALE_RANDOM, 0);
+    uint64_t ctr = reserve_rand((uint64_t)3 * B->shape[0]);  // draws of sample b start at ctr + 3*b
 #pragma omp parallel for
     for(int b=0; b<B->shape[0]; b++) {
 
         // Compute random coordinates
-        float scale = uniform(factor[0], factor[1]);
+        float scale = uniform_at(ctr + 3*b, factor[0], factor[1]);
         int h = (int)(A->shape[2] * scale);
         int w = (int)(A->shape[3] * scale);
-        int y = (int)((A->shape[2]-h) * uniform(0.0f, 1.0f));
-        int x = (int)((A->shape[3]-w) * uniform(0.0f, 1.0f));
+        int y = (int)((A->shape[2]-h) * uniform_at(ctr + 3*b + 1, 0.0f, 1.0f));
+        int x = (int)((A->shape[3]-w) * uniform_at(ctr + 3*b + 2, 0.0f, 1.0f));
 
         int coords_from_x = x;
         int coords_to_x = x+w;
@@ -392,14 +398,15 @@ void cpu_cutout_random(Tensor *A, Tensor *B, vector<float> factor_x, vector<floa
     // Performs a crop with padding (Keeps the original size)
 
     _profile(_CPU_CUTOUT_RANDOM, 0);
+    uint64_t ctr = reserve_rand((uint64_t)4 * B->shape[0]);  // draws of sample b start at ctr + 4*b
 #pragma omp parallel for
     for(int b=0; b<B->shape[0]; b++) {
 
         // Compute random coordinates
-        int h = (int)(A->shape[2] * uniform(factor_y[0], factor_y[1]));
-        int w = (int)(A->shape[3] * uniform(factor_x[0], factor_x[1]));
-        int y = (int)((A->shape[2]-h) * uniform(0.0f, 1.0f));
-        int x = (int)((A->shape[3]-w) * uniform(0.0f, 1.0f));
+        int h = (int)(A->shape[2] * uniform_at(ctr + 4*b, factor_y[0], factor_y[1]));
+        int w = (int)(A->shape[3] * uniform_at(ctr + 4*b + 1, factor_x[0], factor_x[1]));
+        int y = (int)((A->shape[2]-h) * uniform_at(ctr + 4*b + 2, 0.0f, 1.0f));
+        int x = (int)((A->shape[3]-w) * uniform_at(ctr + 4*b + 3, 0.0f, 1.0f));
 
         int coords_from_x = x;
         int coords_to_x = x+w;
@@ -14,37 +14,27 @@
 void cpu_rand_uniform(Tensor * A, float v)
 {
     _profile(_CPU_RAND_UNIFORM, 0);
-#pragma omp parallel for
-    for (int i = 0; i < A->size; ++i) A->ptr[i] = uniform() * v;
+    fill_uniform(A->ptr, A->size, 0.0f, v);
     _profile(_CPU_RAND_UNIFORM, 1);
 }
 
 void cpu_rand_signed_uniform(Tensor * A, float v)
 {
     _profile(_CPU_RAND_SIGNED_UNIFORM, 0);
-    #pragma omp parallel for
-    for (int i = 0; i < A->size; ++i) A->ptr[i] = signed_uniform() * v;
+    fill_uniform(A->ptr, A->size, -v, v);
     _profile(_CPU_RAND_SIGNED_UNIFORM, 1);
 }
 
 void cpu_rand_binary(Tensor * A, float v)
 {
     _profile(_CPU_BINARY, 0);
-    #pragma omp parallel for
-    for (int i = 0; i < A->size; ++i)
-        if (uniform() < v) A->ptr[i] = 1.0;
-        else A->ptr[i] = 0.0;
+    fill_binary(A->ptr, A->size, v);
     _profile(_CPU_BINARY, 1);
 }
 
 void cpu_rand_normal(Tensor * A, float m, float s, bool fast_math) {
     _profile(_CPU_RAND_NORMAL, 0);
-    int r = rand();
-
-    if (fast_math) {
-        for (int i = 0; i < A->size; ++i) A->ptr[i] = fast_randn(m, s, r++);
-    } else  {
-        for (int i = 0; i < A->size; ++i) A->ptr[i] = slow_randn(m, s);
-    }
-    _profile(_CPU_RAND_NORMAL, 0);
+    // Counter-based Box-Muller is both fast and exact, fast_math is kept for the API
+    fill_normal(A->ptr, A->size, m, s);
+    _profile(_CPU_RAND_NORMAL, 1);
 }
@@ -8,83 +8,362 @@
 */
 
 #include <stdexcept>
+#include <algorithm>
 
 #include "eddl/hardware/cpu/cpu_tensor.h"
 
-void cpu_reduce(Tensor *A, Tensor *B,string mode,int* map)
-{
-  _profile(_CPU_REDUCE, 0);
-  int i,j,min,max,sum;
-  int s=A->size/B->size;
-
-  if (mode=="mean") {
-    B->fill_(0.0);
-    for(i=0;i<A->size;i++)
-      B->ptr[map[i]]+=A->ptr[i];
-    B->div_(s);
-  }
-  else if (mode=="variance") {
-    Tensor *C=B->clone();
-    C->fill_(0.0);
-    for(i=0;i<A->size;i++)
-      C->ptr[map[i]]+=A->ptr[i];
-    C->div_(s);
-
-    B->fill_(0.0);
-    for(i=0;i<A->size;i++) {
-      float fv=A->ptr[i]-C->ptr[map[i]];
-      B->ptr[map[i]]+=fv*fv;
-    }
-    B->div_(s);
-
-    delete C;
-  }
-  else {
-    throw std::invalid_argument("mode: " + mode + " not yet implemented");
-  }
-    _profile(_CPU_REDUCE, 1);
+
+// Axis pattern of a reduction. Unit axes are dropped and neighbouring axes of
+// the same kind are merged, so the input is seen as alternating groups of kept
+// and reduced axes. The innermost group is contiguous: when it is reduced
+// (inner) every output sums runs of "len" floats, otherwise (outer) "len"
+// consecutive outputs are accumulated together, one input row at a time.
+struct RedPlan {
+    vector<long> kshape, kstride;  // kept groups (without the innermost one)
+    vector<long> rshape, rstride;  // reduced groups (without the innermost one)
+    bool inner;
+    long len;
+    long nout, nred, nrows;
+};
+
+static void red_plan(Tensor *A, const vector<int> &axis, RedPlan &p) {
+    int prev = -1;
+    for (int i = 0; i < A->ndim; i++) {
+        if (A->shape[i] == 1) continue;
+        int red = (find(axis.begin(), axis.end(), i) != axis.end());
+        vector<long> &sh = red ? p.rshape : p.kshape;
+        vector<long> &st = red ? p.rstride : p.kstride;
+        if (red == prev) {
+            sh.back() *= A->shape[i];
+            st.back() = A->stride[i];
+        }
+        else {
+            sh.push_back(A->shape[i]);
+            st.push_back(A->stride[i]);
+        }
+        prev = red;
+    }
+
+    p.inner = (prev == 1);
+    p.len = 1;
+    vector<long> &last = p.inner ? p.rshape : p.kshape;
+    vector<long> &lasts = p.inner ? p.rstride : p.kstride;
+    if (!last.empty()) {
+        p.len = last.back();
+        last.pop_back();
+        lasts.pop_back();
+    }
+
+    p.nout = 1;
+    for (auto d : p.kshape) p.nout *= d;
+    p.nrows = 1;
+    for (auto d : p.rshape) p.nrows *= d;
+    if (p.inner) p.nred = p.nrows * p.len;
+    else {
+        p.nred = p.nrows;
+        p.nout *= p.len;
+    }
 }
-void cpu_reduce(Tensor *A, Tensor *B,string mode,MapReduceDescriptor *MD)
-{
-    cpu_reduce(A,B,mode,MD->ind);
+
+static inline long red_offset(long i, const vector<long> &shape, const vector<long> &stride) {
+    long off = 0;
+    for (int k = shape.size() - 1; k >= 0; k--) {
+        off += (i % shape[k]) * stride[k];
+        i /= shape[k];
+    }
+    return off;
 }
 
+// Input offset of the first element reduced into output o
+static inline long red_base(long o, const RedPlan &p) {
+    if (p.inner) return red_offset(o, p.kshape, p.kstride);
+    return red_offset(o / p.len, p.kshape, p.kstride) + (o % p.len);
+}
 
-void cpu_reduce_op(Tensor *A, Tensor *B,string op,int* map)
-{
-    _profile(_CPU_REDUCE_OP, 0);
-  int i,j,min,max,sum;
-  int s=A->size/B->size;
+static float pairwise_sum(const float *x, long n) {
+    if (n <= 256) {
+        float s = 0.0f;
+#if OpenMP_VERSION_MAJOR >= 4
+        #pragma omp simd reduction(+:s)
+#endif
+        for (long j = 0; j < n; j++) s += x[j];
+        return s;
+    }
+    long h = (n / 2) & ~7L;
+    return pairwise_sum(x, h) + pairwise_sum(x + h, n - h);
+}
+
+static float rows_sum(const float *a, const RedPlan &p, long r0, long r1) {
+    if (r1 - r0 == 1) return pairwise_sum(a + red_offset(r0, p.rshape, p.rstride), p.len);
+    long h = (r0 + r1) / 2;
+    return rows_sum(a, p, r0, h) + rows_sum(a, p, h, r1);
+}
+
+#define RED_COLS 256
+#define RED_ROWS 64
+
+// out[o] = sum of the elements reduced into o
+static void red_sum(const float *a, const RedPlan &p, float *out) {
+    if (p.inner) {
+        #pragma omp parallel for
+        for (long o = 0; o < p.nout; o++) out[o] = rows_sum(a + red_base(o, p), p, 0, p.nrows);
+        return;
+    }
+
+    long nblk = p.nout / p.len;
+    long nchk = (p.len + RED_COLS - 1) / RED_COLS;
+    #pragma omp parallel for
+    for (long t = 0; t < nblk * nchk; t++) {
+        long b = t / nchk, c0 = (t % nchk) * RED_COLS;
+        long nc = std::min((long) RED_COLS, p.len - c0);
+        const float *ab = a + red_offset(b, p.kshape, p.kstride) + c0;
+        float tot[RED_COLS], blk[RED_COLS];
+        std::fill(tot, tot + nc, 0.0f);
+
+        // Rows are summed in blocks to bound the rounding error
+        for (long r0 = 0; r0 < p.nrows; r0 += RED_ROWS) {
+            std::fill(blk, blk + nc, 0.0f);
+            for (long r = r0; r < std::min(r0 + RED_ROWS, p.nrows); r++) {
+                const float *row = ab + red_offset(r, p.rshape, p.rstride);
+#if OpenMP_VERSION_MAJOR >= 4
+                #pragma omp simd
+#endif
+                for (long k = 0; k < nc; k++) blk[k] += row[k];
+            }
+            for (long k = 0; k < nc; k++) tot[k] += blk[k];
+        }
+        std::copy(tot, tot + nc, out + b * p.len + c0);
+    }
+}
+
+// out[o] = product of the elements reduced into o
+static void red_prod(const float *a, const RedPlan &p, float *out) {
+    long nrun = p.inner ? p.len : 1;
+    long nblk = p.inner ? p.nout : p.nout / p.len;
+    long ncol = p.inner ? 1 : p.len;
 
-  if (op=="sum") {
     #pragma omp parallel for
-    for(i=0;i<A->size;i++)
-      B->ptr[map[i]]+=A->ptr[i];
-  }
-  else if (op=="diff"){
+    for (long b = 0; b < nblk; b++) {
+        float *ob = out + b * ncol;
+        std::fill(ob, ob + ncol, 1.0f);
+        const float *ab = a + red_offset(b, p.kshape, p.kstride);
+        for (long r = 0; r < p.nrows; r++) {
+            const float *row = ab + red_offset(r, p.rshape, p.rstride);
+            if (p.inner) for (long j = 0; j < nrun; j++) ob[0] *= row[j];
+            else for (long k = 0; k < ncol; k++) ob[k] *= row[k];
+        }
+    }
+}
+
+// out[o] = max (or min) of the elements reduced into o, idx[o] its input offset
+static void red_arg(const float *a, const RedPlan &p, float *out, float *idx, bool is_max) {
+    if (p.inner) {
+        #pragma omp parallel for
+        for (long o = 0; o < p.nout; o++) {
+            long base = red_base(o, p);
+            float v = a[base];
+            long iv = base;
+            for (long r = 0; r < p.nrows; r++) {
+                long off = base + red_offset(r, p.rshape, p.rstride);
+                for (long j = 0; j < p.len; j++) {
+                    float x = a[off + j];
+                    if (is_max ? (x > v) : (x < v)) { v = x; iv = off + j; }
+                }
+            }
+            out[o] = v;
+            if (idx != nullptr) idx[o] = (float) iv;
+        }
+        return;
+    }
+
+    long nblk = p.nout / p.len;
     #pragma omp parallel for
-    for(i=0;i<A->size;i++)
-      B->ptr[map[i]]-=A->ptr[i];
-  }
-  else if (op=="mult"){
+    for (long b = 0; b < nblk; b++) {
+        long base = red_offset(b, p.kshape, p.kstride);
+        float *ob = out + b * p.len;
+        std::copy(a + base, a + base + p.len, ob);
+        vector<long> ib(p.len, 0);
+        for (long r = 1; r < p.nrows; r++) {
+            long roff = red_offset(r, p.rshape, p.rstride);
+            const float *row = a + base + roff;
+            for (long k = 0; k < p.len; k++) {
+                bool better = is_max ? (row[k] > ob[k]) : (row[k] < ob[k]);
+                ob[k] = better ? row[k] : ob[k];
+                ib[k] = better ? roff : ib[k];
+            }
+        }
+        if (idx != nullptr)
+            for (long k = 0; k < p.len; k++) idx[b * p.len + k] = (float) (base + ib[k] + k);
+    }
+}
+
+// Welford mean and (biased) variance of the elements reduced into o
+static void red_var(const float *a, const RedPlan &p, float *mean, float *var) {
+    if (p.inner) {
+        #pragma omp parallel for
+        for (long o = 0; o < p.nout; o++) {
+            long base = red_base(o, p);
+            long l8 = p.len & ~7L;
+
+            // 8 lanes over the runs, plus the tail elements, merged at the end
+            float lm[8] = {0}, lm2[8] = {0};
+            long lc = 0;
+            float tm = 0.0f, tm2 = 0.0f;
+            long tc = 0;
+            for (long r = 0; r < p.nrows; r++) {
+                const float *row = a + base + red_offset(r, p.rshape, p.rstride);
+                for (long j = 0; j < l8; j += 8) {
+                    float inv = 1.0f / (float) (++lc);
+                    for (int l = 0; l < 8; l++) {
+                        float d = row[j + l] - lm[l];
+                        lm[l] += d * inv;
+                        lm2[l] += d * (row[j + l] - lm[l]);
+                    }
+                }
+                for (long j = l8; j < p.len; j++) {
+                    float d = row[j] - tm;
+                    tm += d / (float) (++tc);
+                    tm2 += d * (row[j] - tm);
+                }
+            }
+
+            double n = 0.0, m = 0.0, m2 = 0.0;
+            for (int l = 0; l < 9; l++) {
+                double nb = (l < 8) ? lc : tc;
+                if (nb == 0) continue;
+                double mb = (l < 8) ? lm[l] : tm;
+                double m2b = (l < 8) ? lm2[l] : tm2;
+                double d = mb - m;
+                double nn = n + nb;
+                m += d * nb / nn;
+                m2 += m2b + d * d * n * nb / nn;
+                n = nn;
+            }
+            if (mean != nullptr) mean[o] = (float) m;
+            var[o] = (float) (m2 / n);
+        }
+        return;
+    }
+
+    long nblk = p.nout / p.len;
+    long nchk = (p.len + RED_COLS - 1) / RED_COLS;
     #pragma omp parallel for
-    for(i=0;i<A->size;i++)
-      B->ptr[map[i]]*=A->ptr[i];
-  }
-  else if (op=="div"){
+    for (long t = 0; t < nblk * nchk; t++) {
+        long b = t / nchk, c0 = (t % nchk) * RED_COLS;
+        long nc = std::min((long) RED_COLS, p.len - c0);
+        const float *ab = a + red_offset(b, p.kshape, p.kstride) + c0;
+        float m[RED_COLS], m2[RED_COLS];
+        std::fill(m, m + nc, 0.0f);
+        std::fill(m2, m2 + nc, 0.0f);
+        for (long r = 0; r < p.nrows; r++) {
+            const float *row = ab + red_offset(r, p.rshape, p.rstride);
+            float inv = 1.0f / (float) (r + 1);
+#if OpenMP_VERSION_MAJOR >= 4
+            #pragma omp simd
+#endif
+            for (long k = 0; k < nc; k++) {
+                float d = row[k] - m[k];
+                m[k] += d * inv;
+                m2[k] += d * (row[k] - m[k]);
+            }
+        }
+        long o = b * p.len + c0;
+        if (mean != nullptr) std::copy(m, m + nc, mean + o);
+        for (long k = 0; k < nc; k++) var[o + k] = m2[k] / (float) p.nrows;
+    }
+}
+
+// Sets (or adds) v[o] to every element reduced into o
+static void red_fill(float *x, const RedPlan &p, const float *v, bool add) {
+    if (p.inner) {
+        #pragma omp parallel for
+        for (long o = 0; o < p.nout; o++) {
+            long base = red_base(o, p);
+            float vo = v[o];
+            for (long r = 0; r < p.nrows; r++) {
+                float *row = x + base + red_offset(r, p.rshape, p.rstride);
+                if (add) {
+#if OpenMP_VERSION_MAJOR >= 4
+                    #pragma omp simd
+#endif
+                    for (long j = 0; j < p.len; j++) row[j] += vo;
+                }
+                else std::fill(row, row + p.len, vo);
+            }
+        }
+        return;
+    }
+
+    long nblk = p.nout / p.len;
     #pragma omp parallel for
-    for(i=0;i<A->size;i++)
-      B->ptr[map[i]]/=A->ptr[i];
-  }
-  else {
-    throw std::invalid_argument("op: " + op + " not yet implemented");
-  }
-    _profile(_CPU_REDUCE_OP, 1);
+    for (long b = 0; b < nblk; b++) {
+        float *xb = x + red_offset(b, p.kshape, p.kstride);
+        const float *vb = v + b * p.len;
+        for (long r = 0; r < p.nrows; r++) {
+            float *row = xb + red_offset(r, p.rshape, p.rstride);
+            if (add) {
+#if OpenMP_VERSION_MAJOR >= 4
+                #pragma omp simd
+#endif
+                for (long k = 0; k < p.len; k++) row[k] += vb[k];
+            }
+            else std::copy(vb, vb + p.len, row);
+        }
+    }
+}
+
+
+void cpu_reduce(Tensor *A, Tensor *B, const vector<int> &axis, int mode)
+{
+    _profile(_CPU_REDUCE, 0);
+    RedPlan p;
+    red_plan(A, axis, p);
+
+    switch (mode) {
+        case REDUCE_MEAN:
+        case REDUCE_SUM:
+            red_sum(A->ptr, p, B->ptr);
+            if (mode == REDUCE_MEAN) {
+                float inv = 1.0f / (float) p.nred;
+                for (long o = 0; o < p.nout; o++) B->ptr[o] *= inv;
+            }
+            break;
+        case REDUCE_VAR:
+            red_var(A->ptr, p, nullptr, B->ptr);
+            break;
+        case REDUCE_MAX:
+        case REDUCE_MIN:
+            red_arg(A->ptr, p, B->ptr, nullptr, mode == REDUCE_MAX);
+            break;
+        default:
+            msg("Reduction mode not yet implemented", "cpu_reduce");
+    }
+    _profile(_CPU_REDUCE, 1);
 }
 
-void cpu_reduce_op(Tensor *A, Tensor *B,string op,MapReduceDescriptor *MD)
+
+void cpu_reduce_op(Tensor *A, Tensor *B, const vector<int> &axis, int op)
 {
-  cpu_reduce_op(A,B,op,MD->ind);
+    _profile(_CPU_REDUCE_OP, 0);
+    RedPlan p;
+    red_plan(A, axis, p);
+
+    vector<float> r(p.nout);
+    if ((op == REDUCE_OP_SUM) || (op == REDUCE_OP_DIFF)) red_sum(A->ptr, p, r.data());
+    else if ((op == REDUCE_OP_MULT) || (op == REDUCE_OP_DIV)) red_prod(A->ptr, p, r.data());
+    else msg("Reduction op not yet implemented", "cpu_reduce_op");
+
+    float *b = B->ptr;
+    #pragma omp parallel for
+    for (long o = 0; o < p.nout; o++) {
+        switch (op) {
+            case REDUCE_OP_SUM:  b[o] += r[o]; break;
+            case REDUCE_OP_DIFF: b[o] -= r[o]; break;
+            case REDUCE_OP_MULT: b[o] *= r[o]; break;
+            default:             b[o] /= r[o]; break;
+        }
+    }
+    _profile(_CPU_REDUCE_OP, 1);
 }
 
 
@@ -113,109 +392,69 @@ void cpu_reduce_sum2D(Tensor *A, Tensor *B, int axis, int incB) {
 
 
 void cpu_reduction(ReduceDescriptor *RD){
-
     _profile(_CPU_REDUCTION, 0);
+    RedPlan p;
+    red_plan(RD->I, RD->axis, p);
+
+    // keepdims results are computed compact and then broadcast
+    vector<float> val, ind;
+    float *o = RD->O->ptr;
+    float *s = (RD->S != nullptr) ? RD->S->ptr : nullptr;
+    if (RD->keepdims) {
+        val.resize(p.nout);
+        o = val.data();
+        if (s != nullptr) {
+            ind.resize(p.nout);
+            s = ind.data();
+        }
+    }
 
-      float val,sum;
-      int ind;
-      int d;
-      int i,j,k,l,s;
-
-      // [MEAN]: Compute items to be reduced
-      if (RD->m==0) {
-          d=1;
-          for(i=0;i<RD->axis.size();i++){
-              d *= RD->I->shape[RD->axis[i]];
-          }
-      }
-
-      //reduce
-      for(i=0;i<RD->index.size();i++)
-      {
-          sum=0;
-
-          for(j=0;j<RD->index[i].size();j++) {
-
-              float v=RD->I->ptr[RD->index[i][j]];
-              if (RD->m==2) {
-                  if (j==0) {val=v;ind=RD->index[i][j];}
-                  else if (v>val) {
-                      val=v;
-                      ind=RD->index[i][j];
-                  }
-              }
-              else if (RD->m==3) {
-                if (j==0) {val=v;ind=RD->index[i][j];}
-                else if (v<val) {
-                    val=v;
-                    ind=RD->index[i][j];
-                }
-              }
-              else sum+=v;
-          }
-
-          // set in Output
-          if (RD->m<2) { // mean or sum
-              if (RD->m==0) sum/=d;
-              if (RD->keepdims) {
-                  for(j=0;j<RD->index[i].size();j++) {
-                      RD->O->ptr[RD->index[i][j]]=sum;
-                    }
-              }
-              else RD->O->ptr[i]=sum;
-          }
-          else { // max or min
-              if (RD->keepdims) {
-                  for(j=0;j<RD->index[i].size();j++) {
-                      RD->O->ptr[RD->index[i][j]]=val;
-                      RD->S->ptr[RD->index[i][j]]=ind;
-                  }
-              }
-              else {
-                  RD->O->ptr[i]=val;
-                  RD->S->ptr[i]=ind;
-              }
-          }
-
-      }// i
-      _profile(_CPU_REDUCTION, 1);
-  }
-
-  void cpu_reduction_back(ReduceDescriptor *RD){
-
-  _profile(_CPU_REDUCTION_BACK, 0);
-
-      float val,sum;
-      int ind;
-      int d;
-      int i,j,k,l,s;
-
-      if (RD->m==0) {
-          d=1;
-          for(i=0;i<RD->axis.size();i++){
-              d *= RD->I->shape[RD->axis[i]];
-          }
-      }
-
-      for(i=0;i<RD->index.size();i++)
-        {
-            if (RD->m>=2) {
-                int p=RD->S->ptr[i];
-                RD->ID->ptr[p]+=RD->D->ptr[i];
-            }
-            else {
-              val=0;
-              if(RD->keepdims) {
-                for(j=0;j<RD->index[i].size();j++)
-                  val+=RD->D->ptr[RD->index[i][j]];
-              }
-              else val=RD->D->ptr[i];
-
-              if (RD->m==0) val/=d;
-              for(j=0;j<RD->index[i].size();j++)
-                RD->ID->ptr[RD->index[i][j]]+=val;
-            }
-        }//i
+    if (RD->m < 2) {  // mean or sum
+        red_sum(RD->I->ptr, p, o);
+        if (RD->m == 0) {
+            float inv = 1.0f / (float) p.nred;
+            for (long i = 0; i < p.nout; i++) o[i] *= inv;
+        }
+    }
+    else red_arg(RD->I->ptr, p, o, s, RD->m == 2);  // max or min
+
+    if (RD->keepdims) {
+        red_fill(RD->O->ptr, p, o, false);
+        if (s != nullptr) red_fill(RD->S->ptr, p, s, false);
+    }
+    _profile(_CPU_REDUCTION, 1);
+}
 
-        _profile(_CPU_REDUCTION_BACK, 1);
+void cpu_reduction_back(ReduceDescriptor *RD){
+    _profile(_CPU_REDUCTION_BACK, 0);
+    RedPlan p;
+    red_plan(RD->I, RD->axis, p);
+
+    // Incoming delta per output (summed over the broadcast copies with keepdims)
+    vector<float> val;
+    const float *d = RD->D->ptr;
+    if (RD->keepdims || (RD->m == 0)) {
+        val.resize(p.nout);
+        if (RD->keepdims) red_sum(RD->D->ptr, p, val.data());
+        else std::copy(d, d + p.nout, val.begin());
+        d = val.data();
     }
+
+    if (RD->m >= 2) {  // max or min
+        float *id = RD->ID->ptr;
+        const float *s = RD->S->ptr;
+        #pragma omp parallel for
+        for (long i = 0; i < p.nout; i++) {
+            long k = RD->keepdims ? red_base(i, p) : i;
+            id[(long) s[k]] += d[i];
+        }
+    }
+    else {
+        if (RD->m == 0) {
+            float inv = 1.0f / (float) p.nred;
+            for (long i = 0; i < p.nout; i++) val[i] *= inv;
+        }
+        red_fill(RD->ID->ptr, p, d, true);
+    }
+    _profile(_CPU_REDUCTION_BACK, 1);
+}
@@ -11,6 +11,7 @@
 #include <cstdio>      /* printf, scanf, NULL */
 #include <cstdlib>     /* malloc, free, rand */
 #include <iostream>
+#include <cmath>
 
 #include "eddl/hardware/cpu/nn/cpu_tensor_nn.h"
 
@@ -224,29 +225,130 @@ void cpu_d_tanh(Tensor *D, Tensor *I, Tensor *PD){
 
 void cpu_softmax(Tensor *A, Tensor *B) {
   _profile(_CPU_SOFTMAX, 0);
-  float max, sum;
+  int n = A->shape[1];
 
-  //#pragma omp parallel for
+  #pragma omp parallel for
   for (int i = 0; i < A->shape[0]; i++) {
-    max = (*A->ptr2).col(i).maxCoeff();
-    for (int j = 0; j < A->shape[1]; j++)
-    (*B->ptr2)(j, i) = std::exp((*A->ptr2)(j, i) - max);
+    float *a = A->ptr + (long)i * n;
+    float *b = B->ptr + (long)i * n;
+
+    // exp(x - logsumexp(x)), shifted by the row max
+    float max = a[0];
+    for (int j = 1; j < n; j++) if (a[j] > max) max = a[j];
+
+    float sum = 0.0f;
+#if OpenMP_VERSION_MAJOR >= 4
+    #pragma omp simd reduction(+:sum)
+#endif
+    for (int j = 0; j < n; j++) {
+      b[j] = std::exp(a[j] - max);
+      sum += b[j];
+    }
 
-    sum = (*B->ptr2).col(i).sum();
-    for (int j = 0; j < B->shape[1]; j++)
-    (*B->ptr2)(j, i) = (*B->ptr2)(j, i) / sum;
+    float inv = 1.0f / sum;
+#if OpenMP_VERSION_MAJOR >= 4
+    #pragma omp simd
+#endif
+    for (int j = 0; j < n; j++) b[j] *= inv;
   }
     _profile(_CPU_SOFTMAX, 1);
 }
 
 void cpu_d_softmax(Tensor *D, Tensor *I, Tensor *PD) {
     _profile(_CPU_D_SOFTMAX, 0);
-  PD->tsem->lock();
-
+#if OpenMP_VERSION_MAJOR >= 4
+  #pragma omp parallel for simd
+#else
   #pragma omp parallel for
+#endif
   for (int i = 0; i < D->size; i++)
-    PD->ptr[i] += D->ptr[i] * (I->ptr[i] * (1.0 - I->ptr[i]));
+    PD->ptr[i] += D->ptr[i] * (I->ptr[i] * (1.0f - I->ptr[i]));
 
-  PD->tsem->unlock();
     _profile(_CPU_D_SOFTMAX, 1);
 }
+
+
+// Bias and activation epilogue of Conv/Dense: the same operations (and
+// rounding) as the bias add followed by the activation layer, in one pass
+template<int ACT>
+static inline float epi(float v, float param) {
+  if (ACT == EPI_RELU) return (v > 0.0f) ? v : 0.0f;
+  if (ACT == EPI_LEAKY_RELU) return (v > 0.0f) ? v : param * v;
+  if (ACT == EPI_SIGMOID) return 1.0f / (1.0f + ::expf(-v));
+  if (ACT == EPI_TANH) return ::tanhf(v);
+  return v;
+}
+
+template<int ACT>
+static void epilogue(float *ptr, long int n, float bias, float param) {
+#if OpenMP_VERSION_MAJOR >= 4
+  #pragma omp simd
+#endif
+  for (long int i = 0; i < n; i++) ptr[i] = epi<ACT>(ptr[i] + bias, param);
+}
+
+template<int ACT>
+static void epilogue_rows(float *ptr, int rows, int cols, const float *bias, float param) {
+  #pragma omp parallel for
+  for (int i = 0; i < rows; i++) {
+    float *p = ptr + (long int)i * cols;
+    if (bias != nullptr) {
+#if OpenMP_VERSION_MAJOR >= 4
+      #pragma omp simd
+#endif
+      for (int j = 0; j < cols; j++) p[j] = epi<ACT>(p[j] + bias[j], param);
+    }
+    else epilogue<ACT>(p, cols, 0.0f, param);
+  }
+}
+
+template<int ACT>
+static void d_epilogue(float *d, const float *o, long int n, float param) {
+  #pragma omp parallel for
+  for (long int i = 0; i < n; i++) {
+    if (ACT == EPI_RELU) d[i] = (o[i] > 0.0f) ? d[i] : 0.0f;
+    else if (ACT == EPI_LEAKY_RELU) d[i] = (o[i] > 0.0f) ? d[i] : param * d[i];
+    else if (ACT == EPI_SIGMOID) d[i] = d[i] * ((1 - o[i]) * o[i]);
+    else if (ACT == EPI_TANH) d[i] = d[i] * (1 - (o[i] * o[i]));
+  }
+}
+
+#define EPI_DISPATCH(act, F, ...) \
+  switch (act) { \
+    case EPI_RELU: F<EPI_RELU>(__VA_ARGS__); break; \
+    case EPI_LEAKY_RELU: F<EPI_LEAKY_RELU>(__VA_ARGS__); break; \
+    case EPI_SIGMOID: F<EPI_SIGMOID>(__VA_ARGS__); break; \
+    case EPI_TANH: F<EPI_TANH>(__VA_ARGS__); break; \
+    default: F<EPI_NONE>(__VA_ARGS__); break; \
+  }
+
+void cpu_epilogue(float *ptr, long int n, float bias, int act, float param){
+  EPI_DISPATCH(act, epilogue, ptr, n, bias, param);
+}
+
+void cpu_bias_act(Tensor *O, Tensor *bias, int act, float param){
+  _profile(_CPU_BIAS_ACT, 0);
+  int b = O->shape[0];
+  int z = O->shape[1];
+  long int rc = O->size / ((long int)b * z);
+  const float *pb = (bias != nullptr) ? bias->ptr : nullptr;
+
+  if (rc == 1) {
+    // Dense: the channels are the columns
+    EPI_DISPATCH(act, epilogue_rows, O->ptr, b, z, pb, param);
+  }
+  else {
+    #pragma omp parallel for
+    for (int p = 0; p < b * z; p++)
+      cpu_epilogue(O->ptr + (long int)p * rc, rc, (pb != nullptr) ? pb[p % z] : 0.0f, act, param);
+  }
+  _profile(_CPU_BIAS_ACT, 1);
+}
+
+void cpu_d_act(Tensor *D, Tensor *O, int act, float param){
+  _profile(_CPU_D_ACT, 0);
+  if (act != EPI_NONE) {
+    EPI_DISPATCH(act, d_epilogue, D->ptr, O->ptr, (long int) D->size, param);
+  }
+  _profile(_CPU_D_ACT, 1);
+}
@@ -11,6 +11,7 @@
 #include <cstdio>      /* printf, scanf, NULL */
 #include <cstdlib>     /* malloc, free, rand */
 #include <iostream>
+#include <cmath>
 
 #include "eddl/hardware/cpu/nn/cpu_tensor_nn.h"
 
@@ -113,3 +114,216 @@ void cpu_permute_batch_first(Tensor *A,Tensor *B)
     _profile(_CPU_PERMUTE_BATCH_FIRST, 1);
 
 }
+
+
+// Fused BatchNorm over NCHW (or {batch,dim}) tensors: b samples, z channels
+// and rc=H*W contiguous values per (sample, channel) plane.
+// Statistics are gathered in a single pass with Welford/Chan updates, so no
+// permutation or scratch tensors are needed.
+#define BN_BLOCK 64
+
+void cpu_batchnorm_forward(Tensor *input, Tensor *output, Tensor *opa,
+                           Tensor *global_mean, Tensor *global_variance,
+                           Tensor *affine_g, Tensor *affine_b,
+                           Tensor *mean, Tensor *variance,
+                           bool trmode, float epsilon, float momentum)
+{
+  _profile(_CPU_BATCHNORM_FORWARD, 0);
+  int b=input->shape[0];
+  int z=input->shape[1];
+  int rc=input->size/(b*z);
+
+  float *x=input->ptr;
+  float *y=output->ptr;
+  float *o=opa->ptr;
+  float *m=mean->ptr;
+  float *sd=variance->ptr;
+
+  if (trmode) {
+    if (rc==1) {
+      // Dense: running mean and M2 per column, vectorized along the columns
+      #pragma omp parallel for
+      for (int j0=0;j0<z;j0+=BN_BLOCK) {
+        int j1=(j0+BN_BLOCK<z)?j0+BN_BLOCK:z;
+        for(int j=j0;j<j1;j++) m[j]=sd[j]=0.0f;
+        for(int i=0;i<b;i++) {
+          float inv=1.0f/(i+1);
+          float *xi=x+(long)i*z;
+          for(int j=j0;j<j1;j++) {
+            float d=xi[j]-m[j];
+            m[j]+=d*inv;
+            sd[j]+=d*(xi[j]-m[j]);
+          }
+        }
+        for(int j=j0;j<j1;j++) sd[j]/=b;
+      }
+    }
+    else {
+      // Conv: statistics of each plane merged into the channel ones (Chan et al.)
+      #pragma omp parallel for
+      for (int j=0;j<z;j++) {
+        double cm=0.0,cm2=0.0;
+        long n=0;
+        for(int i=0;i<b;i++) {
+          float *xi=x+((long)i*z+j)*rc;
+          float s=0.0f;
+          for(int k=0;k<rc;k++) s+=xi[k];
+          float pm=s/rc;
+          float q=0.0f;
+          for(int k=0;k<rc;k++) {
+            float d=xi[k]-pm;
+            q+=d*d;
+          }
+          long nn=n+rc;
+          double d=pm-cm;
+          cm+=d*rc/nn;
+          cm2+=q+d*d*((double)n*rc/nn);
+          n=nn;
+        }
+        m[j]=cm;
+        sd[j]=cm2/n;
+      }
+    }
+
+    float *gm=global_mean->ptr;
+    float *gv=global_variance->ptr;
+    for(int j=0;j<z;j++) {
+      if (momentum!=0.0) {
+        gm[j]=momentum*gm[j]+(1.0f-momentum)*m[j];
+        gv[j]=momentum*gv[j]+(1.0f-momentum)*sd[j];
+      }
+      sd[j]=sqrtf(sd[j]+epsilon);
+    }
+  }
+  else {
+    float *gv=global_variance->ptr;
+    m=global_mean->ptr;
+    for(int j=0;j<z;j++) sd[j]=sqrtf(gv[j]+epsilon);
+  }
+
+  float *g=(affine_g!=nullptr)?affine_g->ptr:nullptr;
+  float *be=(affine_b!=nullptr)?affine_b->ptr:nullptr;
+
+  if (rc==1) {
+    #pragma omp parallel for
+    for(int i=0;i<b;i++) {
+      long p=(long)i*z;
+      for(int j=0;j<z;j++) {
+        float h=(x[p+j]-m[j])/sd[j];
+        o[p+j]=h;
+        y[p+j]=(g!=nullptr)?g[j]*h+be[j]:h;
+      }
+    }
+  }
+  else {
+    #pragma omp parallel for
+    for(int p=0;p<b*z;p++) {
+      int j=p%z;
+      float mj=m[j];
+      float inv=1.0f/sd[j];
+      float gj=(g!=nullptr)?g[j]:1.0f;
+      float bj=(g!=nullptr)?be[j]:0.0f;
+      float *xi=x+(long)p*rc;
+      float *oi=o+(long)p*rc;
+      float *yi=y+(long)p*rc;
+      for(int k=0;k<rc;k++) {
+        float h=(xi[k]-mj)*inv;
+        oi[k]=h;
+        yi[k]=gj*h+bj;
+      }
+    }
+  }
+  _profile(_CPU_BATCHNORM_FORWARD, 1);
+}
+
+void cpu_batchnorm_backward(Tensor *delta, Tensor *opa, Tensor *pdelta,
+                            Tensor *variance, Tensor *affine_g,
+                            Tensor *gaffine_g, Tensor *gaffine_b,
+                            Tensor *mdelta, Tensor *mdelta_opa)
+{
+  _profile(_CPU_BATCHNORM_BACKWARD, 0);
+  int b=delta->shape[0];
+  int z=delta->shape[1];
+  int rc=delta->size/(b*z);
+  float N=(float)b*rc;
+
+  float *dy=delta->ptr;
+  float *o=opa->ptr;
+  float *dx=pdelta->ptr;
+  float *sd=variance->ptr;
+  float *md=mdelta->ptr;
+  float *mdo=mdelta_opa->ptr;
+
+  // Per channel mean(delta) and mean(delta*opa)
+  if (rc==1) {
+    #pragma omp parallel for
+    for (int j0=0;j0<z;j0+=BN_BLOCK) {
+      int j1=(j0+BN_BLOCK<z)?j0+BN_BLOCK:z;
+      for(int j=j0;j<j1;j++) md[j]=mdo[j]=0.0f;
+      for(int i=0;i<b;i++) {
+        long p=(long)i*z;
+        for(int j=j0;j<j1;j++) {
+          md[j]+=dy[p+j];
+          mdo[j]+=dy[p+j]*o[p+j];
+        }
+      }
+      for(int j=j0;j<j1;j++) {
+        md[j]/=N;
+        mdo[j]/=N;
+      }
+    }
+  }
+  else {
+    #pragma omp parallel for
+    for (int j=0;j<z;j++) {
+      double s=0.0,so=0.0;
+      for(int i=0;i<b;i++) {
+        long p=((long)i*z+j)*rc;
+        float ps=0.0f,pso=0.0f;
+        for(int k=0;k<rc;k++) {
+          ps+=dy[p+k];
+          pso+=dy[p+k]*o[p+k];
+        }
+        s+=ps;
+        so+=pso;
+      }
+      md[j]=s/N;
+      mdo[j]=so/N;
+    }
+  }
+
+  float *g=nullptr;
+  if (affine_g!=nullptr) {
+    g=affine_g->ptr;
+    for(int j=0;j<z;j++) {
+      gaffine_g->ptr[j]+=mdo[j];
+      gaffine_b->ptr[j]+=md[j];
+    }
+  }
+
+  // parent_delta += g*(delta - mean(delta) - opa*mean(delta*opa))/sd
+  if (rc==1) {
+    #pragma omp parallel for
+    for(int i=0;i<b;i++) {
+      long p=(long)i*z;
+      for(int j=0;j<z;j++) {
+        float gj=(g!=nullptr)?g[j]:1.0f;
+        dx[p+j]+=gj*(dy[p+j]-md[j]-o[p+j]*mdo[j])/sd[j];
+      }
+    }
+  }
+  else {
+    #pragma omp parallel for
+    for(int p=0;p<b*z;p++) {
+      int j=p%z;
+      float s=((g!=nullptr)?g[j]:1.0f)/sd[j];
+      float mj=md[j];
+      float moj=mdo[j];
+      float *dyi=dy+(long)p*rc;
+      float *oi=o+(long)p*rc;
+      float *dxi=dx+(long)p*rc;
+      for(int k=0;k<rc;k++) dxi[k]+=s*(dyi[k]-mj-oi[k]*moj);
+    }
+  }
+  _profile(_CPU_BATCHNORM_BACKWARD, 1);
+}
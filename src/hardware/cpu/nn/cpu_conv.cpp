@@ -10,6 +10,12 @@
 #include <cstdio>      /* printf, scanf, NULL */
 #include <cstdlib>     /* malloc, free, rand */
 #include <iostream>
+#include <cstring>
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "eddl/hardware/cpu/nn/cpu_tensor_nn.h"
 
@@ -39,126 +45,513 @@ void add_pixel(int b,int px,int py,int pz,ConvolDescriptor *D,int isize,int irsi
 }
 
 
-void im2col(int b,ConvolDescriptor *D,float *ptrI,int col2im)
+// Upper bound (bytes) of the im2col workspace, see CompServ
+static long int conv_workspace_limit=256L*1024*1024;
+
+// im2col workspace shared by all the convolutions run from the same thread
+struct ConvWorkspace {
+  float *ptr=nullptr;
+  long int size=0;
+  ~ConvWorkspace() { free_fmem(ptr); }
+};
+static thread_local ConvWorkspace conv_ws;
+
+void cpu_set_conv_workspace(long int bytes)
 {
-  _profile(_CPU_IM2COL, 0);
-  int i,j,k;
-  int pz,py,px,y,x;
-  int ksize=D->kr*D->kc;
-  int kr2=D->kr/2;
-  int kc2=D->kc/2;
+  if (bytes<=0) msg("The convolution workspace must be > 0","cpu_set_conv_workspace");
+  conv_workspace_limit=bytes;
+}
+
+long int cpu_get_conv_workspace()
+{
+  return conv_workspace_limit;
+}
 
-  if (kc2==0) kc2=-1;
+float *conv_workspace(long int size)
+{
+  if (size>conv_ws.size) {
+    free_fmem(conv_ws.ptr);
+    conv_ws.ptr=nullptr;
+    conv_ws.size=0;
+    conv_ws.ptr=get_fmem(size,"conv_workspace");
+    conv_ws.size=size;
+  }
+  return conv_ws.ptr;
+}
 
-  int orsize=D->r*D->c;
+// Output positions per im2col tile, so that nth tiles fit in the workspace.
+// Whole output rows are preferred; a tile never goes below one position.
+int conv_tile_rows(ConvolDescriptor *D,int nth)
+{
+  int rcsize=D->r*D->c;
+  long int ksize=D->kr*D->kc*D->kz;
+
+  long int rows=conv_workspace_limit/((long int)sizeof(float)*ksize*nth);
+  if (rows>=rcsize) return rcsize;
+  if (rows>D->c) rows-=rows%D->c;
+  if (rows<1) rows=1;
+  return (int)rows;
+}
+
+int conv_thread_id()
+{
+#ifdef _OPENMP
+  return omp_get_thread_num();
+#else
+  return 0;
+#endif
+}
 
-  int isize=D->ir*D->ic*D->iz;
+// Lowers the output positions [p0,p0+np) of sample b and group g into ptrT,
+// a (np x kr*kc*kz) column-major matrix. With col2im the tile is accumulated
+// back into the delta of the input instead. Padding is resolved once per row
+// segment, so the interior is a plain copy (memcpy for unit stride).
+void im2col_tile(ConvolDescriptor *D,int b,int g,int p0,int np,float *ptrT,int col2im)
+{
+  _profile(_CPU_IM2COL, 0);
   int irsize=D->ir*D->ic;
+  int p1=p0+np;
+  float *ptr=(col2im) ? D->ID->ptr : D->I->ptr;
+  ptr+=((long int)b*D->iz+g*D->kz)*irsize;
+
+  int col=0;
+  for(int z=0;z<D->kz;z++)
+  for(int i=0;i<D->kr;i++)
+  for(int j=0;j<D->kc;j++,col++) {
+    float *ptrC=ptrT+(long int)col*np;
+    int jd=j*D->dc;
+
+    // Output columns reading inside the input: 0 <= x*sc-padcl+j*dc < ic
+    int xlo=(D->padcl>jd) ? (D->padcl-jd+D->sc-1)/D->sc : 0;
+    int xhi=(D->ic+D->padcl-jd>0) ? (D->ic+D->padcl-jd-1)/D->sc+1 : 0;
+    if (xhi>D->c) xhi=D->c;
+
+    for(int p=p0;p<p1;) {
+      int y=p/D->c;
+      int x0=p%D->c;
+      int x1=std::min(D->c,x0+(p1-p));
+      float *dst=ptrC+(p-p0);
+      p+=x1-x0;
+
+      int iy=y*D->sr-D->padrt+i*D->dr;
+      if ((iy<0)||(iy>=D->ir)) {
+        if (!col2im) memset(dst,0,(x1-x0)*sizeof(float));
+        continue;
+      }
+
+      int a=std::max(x0,xlo);
+      int e=std::min(x1,xhi);
+      if (a>e) a=e;
+      float *src=ptr+(long int)z*irsize+iy*D->ic+jd-D->padcl;
+
+      if (col2im) {
+        if (D->sc==1) for(int x=a;x<e;x++) src[x]+=dst[x-x0];
+        else for(int x=a;x<e;x++) src[x*D->sc]+=dst[x-x0];
+      }
+      else {
+        if (a>x0) memset(dst,0,(a-x0)*sizeof(float));
+        if (D->sc==1) memcpy(dst+(a-x0),src+a,(e-a)*sizeof(float));
+        else for(int x=a;x<e;x++) dst[x-x0]=src[x*D->sc];
+        if (x1>e) memset(dst+(e-x0),0,(x1-e)*sizeof(float));
+      }
+    }
+  }
+  _profile(_CPU_IM2COL, 1);
+}
 
-  k=0;
-  py=-D->padrt;
-  px=-D->padcl;
 
+void conv2D_im2col(ConvolDescriptor *D)
+{
+  int batch=D->I->shape[0];
+  int osize=D->z*D->r*D->c;
+  int rcsize=D->r*D->c;
+  int ksize=D->kr*D->kc*D->kz;
+
+  int nth=1;
+#ifdef _OPENMP
+  nth=omp_get_max_threads();
+#endif
+  int nkg=D->nk/D->groups;
+  int trows=conv_tile_rows(D,nth);
+  int ntiles=(rcsize+trows-1)/trows;
+  int total=batch*D->groups*ntiles;
+  if (nth>total) nth=total;
+
+  float *ws=conv_workspace((long int)nth*trows*ksize);
+  Eigen::Map<Eigen::MatrixXf> matK(D->K->ptr,ksize,D->nk);
+
+  #pragma omp parallel for num_threads(nth)
+  for(int t=0;t<total;t++){
+    int b=t/(D->groups*ntiles);
+    int g=(t/ntiles)%D->groups;
+    int p0=(t%ntiles)*trows;
+    int np=std::min(trows,rcsize-p0);
+
+    float *ptrT=ws+(long int)conv_thread_id()*trows*ksize;
+    im2col_tile(D,b,g,p0,np,ptrT,0);
+
+    Eigen::Map<Eigen::MatrixXf> matT(ptrT,np,ksize);
+    Eigen::Map<Eigen::MatrixXf> matO(D->O->ptr+(b*osize),rcsize,D->z);
+
+    matO.block(p0,g*nkg,np,nkg).noalias()=matT*matK.middleCols(g*nkg,nkg);
+
+    // bias and activation while the tile is still in cache
+    if (D->use_bias || (D->act!=EPI_NONE))
+      for(int z=g*nkg;z<(g+1)*nkg;z++)
+        cpu_epilogue(D->O->ptr+(b*osize)+(long int)z*rcsize+p0,np,D->use_bias?D->bias->ptr[z]:0.0f,D->act,D->act_param);
+  }// tiles
+}
+
+// 1x1 kernels, no padding and stride 1: each input sample is already the
+// (r*c x iz) lowered matrix
+void conv2D_gemm1x1(ConvolDescriptor *D)
+{
+  int isize=D->iz*D->ir*D->ic;
+  int osize=D->z*D->r*D->c;
+  int rcsize=D->r*D->c;
+  Eigen::Map<Eigen::MatrixXf> matK(D->K->ptr,D->kz,D->nk);
+
+  #pragma omp parallel for
+  for(int b=0;b<D->I->shape[0];b++){
+    Eigen::Map<Eigen::MatrixXf> matI(D->I->ptr+(b*isize),rcsize,D->iz);
+    Eigen::Map<Eigen::MatrixXf> matO(D->O->ptr+(b*osize),rcsize,D->z);
 
-  for(j=0;j<D->matI.rows();j++) {
-    k=j;
+    matO.noalias()=matI*matK;
 
-    for(i=0;i<D->matI.cols();i++,k+=orsize) {
-      pz=i/ksize;
-      y=py+(i%ksize)/D->kc;
-      x=px+(i%D->kc);
+    if (D->use_bias || (D->act!=EPI_NONE))
+      for(int z=0;z<D->z;z++)
+        cpu_epilogue(D->O->ptr+(b*osize)+(long int)z*rcsize,rcsize,D->use_bias?D->bias->ptr[z]:0.0f,D->act,D->act_param);
+  }
+}
 
-      if(col2im)
-      add_pixel(b,x,y,pz,D,isize,irsize,ptrI[k]);
-      else
-      ptrI[k]=get_pixel(b,x,y,pz,D,isize,irsize);
+// Winograd F(2x2,3x3) transformed kernels: U = G g G^T, stored as 16
+// (iz x nk) column-major matrices, one per point of the 4x4 tile
+void winograd_kernels(ConvolDescriptor *D)
+{
+  int cksize=D->iz*D->nk;
+  if (D->size_U<16*cksize) {
+    free_fmem(D->ptrU);
+    D->size_U=16*cksize;
+    D->ptrU=get_fmem(D->size_U,"winograd_kernels");
+  }
+  float *U=D->ptrU;
 
+  #pragma omp parallel for
+  for(int k=0;k<D->nk;k++)
+  for(int z=0;z<D->iz;z++) {
+    const float *g=D->K->ptr+((long int)k*D->kz+z)*9;
+    float t[4][3];
+    for(int j=0;j<3;j++) {
+      t[0][j]=g[j];
+      t[1][j]=0.5f*(g[j]+g[3+j]+g[6+j]);
+      t[2][j]=0.5f*(g[j]-g[3+j]+g[6+j]);
+      t[3][j]=g[6+j];
     }
-    px+=D->sc;
-    if (px>=D->ic+D->padcl-kc2-1) {
-      px=-D->padcl;
-      py+=D->sr;
+    for(int i=0;i<4;i++) {
+      float *u=U+(i*4)*cksize+k*D->iz+z;
+      u[0]=t[i][0];
+      u[cksize]=0.5f*(t[i][0]+t[i][1]+t[i][2]);
+      u[2*cksize]=0.5f*(t[i][0]-t[i][1]+t[i][2]);
+      u[3*cksize]=t[i][2];
     }
   }
-    _profile(_CPU_IM2COL, 1);
 }
 
+// Input transform V = B^T d B of the tiles [t0,t0+nt) of sample b into 16
+// (nt x iz) column-major matrices
+void winograd_input(ConvolDescriptor *D,int b,int t0,int nt,float *V)
+{
+  int irsize=D->ir*D->ic;
+  int tc=(D->c+1)/2;
+  long int vsize=(long int)nt*D->iz;
+
+  for(int z=0;z<D->iz;z++) {
+    const float *ptrI=D->I->ptr+((long int)b*D->iz+z)*irsize;
+    for(int t=0;t<nt;t++) {
+      int y0=((t0+t)/tc)*2-D->padrt;
+      int x0=((t0+t)%tc)*2-D->padcl;
+      float d[4][4];
+
+      if ((y0>=0)&&(y0+4<=D->ir)&&(x0>=0)&&(x0+4<=D->ic)) {
+        for(int i=0;i<4;i++)
+          for(int j=0;j<4;j++) d[i][j]=ptrI[(y0+i)*D->ic+x0+j];
+      }
+      else {
+        for(int i=0;i<4;i++)
+          for(int j=0;j<4;j++) {
+            int y=y0+i, x=x0+j;
+            d[i][j]=((y>=0)&&(y<D->ir)&&(x>=0)&&(x<D->ic)) ? ptrI[y*D->ic+x] : 0.0f;
+          }
+      }
+
+      float w[4][4];
+      for(int j=0;j<4;j++) {
+        w[0][j]=d[0][j]-d[2][j];
+        w[1][j]=d[1][j]+d[2][j];
+        w[2][j]=d[2][j]-d[1][j];
+        w[3][j]=d[1][j]-d[3][j];
+      }
+      float *v=V+z*nt+t;
+      for(int i=0;i<4;i++) {
+        v[(i*4)*vsize]=w[i][0]-w[i][2];
+        v[(i*4+1)*vsize]=w[i][1]+w[i][2];
+        v[(i*4+2)*vsize]=w[i][2]-w[i][1];
+        v[(i*4+3)*vsize]=w[i][1]-w[i][3];
+      }
+    }
+  }
+}
 
-void cpu_conv2D(ConvolDescriptor *D)
+// Output transform Y = A^T m A of the tiles [t0,t0+nt) of sample b
+void winograd_output(ConvolDescriptor *D,int b,int t0,int nt,float *M)
 {
-  _profile(_CPU_CONV2D, 0);
-  int osize=D->z*D->r*D->c;
-  int isize=D->r*D->c*D->kc*D->kr*D->kz;//r*c,kr*kc*kz
+  int tc=(D->c+1)/2;
+  long int msize=(long int)nt*D->nk;
+
+  for(int k=0;k<D->nk;k++) {
+    float *ptrO=D->O->ptr+((long int)b*D->z+k)*D->r*D->c;
+    for(int t=0;t<nt;t++) {
+      int y0=((t0+t)/tc)*2;
+      int x0=((t0+t)%tc)*2;
+      const float *m=M+k*nt+t;
+
+      float s[2][4];
+      for(int j=0;j<4;j++) {
+        s[0][j]=m[j*msize]+m[(4+j)*msize]+m[(8+j)*msize];
+        s[1][j]=m[(4+j)*msize]-m[(8+j)*msize]-m[(12+j)*msize];
+      }
+      for(int i=0;(i<2)&&(y0+i<D->r);i++) {
+        ptrO[(y0+i)*D->c+x0]=s[i][0]+s[i][1]+s[i][2];
+        if (x0+1<D->c) ptrO[(y0+i)*D->c+x0+1]=s[i][1]-s[i][2]-s[i][3];
+      }
+    }
+  }
+}
 
-  float *ptrO=D->O->ptr;
-  float *ptrI=D->ptrI;
+// 3x3 kernels with stride 1: Winograd F(2x2,3x3). Per block of 2x2 output
+// tiles, the transformed inputs and kernels are multiplied with 16 GEMMs
+// over the input channels. Blocks are bounded by the conv workspace.
+void conv2D_winograd(ConvolDescriptor *D)
+{
+  int batch=D->I->shape[0];
+  int ntiles=((D->r+1)/2)*((D->c+1)/2);
+  long int tsize=16L*(D->iz+D->nk);
+
+  // Training transforms the kernels at every forward, inference only once
+  // until they change (see LConv::forward)
+  if (!(D->keep_U && D->valid_U)) winograd_kernels(D);
+  D->valid_U=D->keep_U;
+
+  int nth=1;
+#ifdef _OPENMP
+  nth=omp_get_max_threads();
+#endif
+  long int tb=cpu_get_conv_workspace()/((long int)sizeof(float)*tsize*nth);
+  if (tb>ntiles) tb=ntiles;
+  if (tb<1) tb=1;
+  int nblocks=(ntiles+tb-1)/tb;
+  int total=batch*nblocks;
+  if (nth>total) nth=total;
+
+  float *ws=conv_workspace(nth*tb*tsize);
+  int cksize=D->iz*D->nk;
+
+  #pragma omp parallel for num_threads(nth)
+  for(int t=0;t<total;t++){
+    int b=t/nblocks;
+    int t0=(t%nblocks)*tb;
+    int nt=std::min((int)tb,ntiles-t0);
+
+    float *V=ws+conv_thread_id()*tb*tsize;
+    float *M=V+16L*nt*D->iz;
+
+    winograd_input(D,b,t0,nt,V);
+    for(int xi=0;xi<16;xi++) {
+      Eigen::Map<Eigen::MatrixXf> matV(V+xi*nt*D->iz,nt,D->iz);
+      Eigen::Map<Eigen::MatrixXf> matU(D->ptrU+xi*cksize,D->iz,D->nk);
+      Eigen::Map<Eigen::MatrixXf> matM(M+xi*nt*D->nk,nt,D->nk);
+
+      matM.noalias()=matV*matU;
+    }
+    winograd_output(D,b,t0,nt,M);
+  }
+}
 
-  // Map memory to Eigen
-  new(&D->matK) Eigen::Map<Eigen::MatrixXf>(D->K->ptr, D->kr * D->kc * D->kz, D->nk);
-  new(&D->matI) Eigen::Map<Eigen::MatrixXf>(D->ptrI, D->r*D->c,D->kz*D->kr*D->kc);
+// One input channel per group (depthwise): direct accumulation of each
+// kernel tap over the output rows, vectorized along the columns
+void conv2D_depthwise(ConvolDescriptor *D)
+{
+  int irsize=D->ir*D->ic;
+  int orsize=D->r*D->c;
+  int nkg=D->nk/D->groups;
+  int total=D->I->shape[0]*D->nk;
 
   #pragma omp parallel for
-  for(int b=0;b<D->I->shape[0];b++){
-
-    float *ptrO=D->O->ptr+(b*osize);
-    float *ptrI=D->ptrI+(b*isize);
-
-    Eigen::Map<Eigen::MatrixXf> matI=Eigen::Map<Eigen::MatrixXf>(ptrI,D->r*D->c,D->kz*D->kr*D->kc);
-    Eigen::Map<Eigen::MatrixXf> matO=Eigen::Map<Eigen::MatrixXf>(ptrO,D->r*D->c,D->z);
+  for(int bk=0;bk<total;bk++){
+    int b=bk/D->nk;
+    int k=bk%D->nk;
+    const float *ptrI=D->I->ptr+((long int)b*D->iz+k/nkg)*irsize;
+    const float *ptrK=D->K->ptr+(long int)k*D->kr*D->kc;
+    float *ptrO=D->O->ptr+(long int)bk*orsize;
+
+    memset(ptrO,0,orsize*sizeof(float));
+    for(int i=0;i<D->kr;i++)
+    for(int j=0;j<D->kc;j++) {
+      float w=ptrK[i*D->kc+j];
+      int jd=j*D->dc;
+      int xlo=(D->padcl>jd) ? (D->padcl-jd+D->sc-1)/D->sc : 0;
+      int xhi=(D->ic+D->padcl-jd>0) ? (D->ic+D->padcl-jd-1)/D->sc+1 : 0;
+      if (xhi>D->c) xhi=D->c;
+
+      for(int y=0;y<D->r;y++) {
+        int iy=y*D->sr-D->padrt+i*D->dr;
+        if ((iy<0)||(iy>=D->ir)) continue;
+
+        const float *src=ptrI+iy*D->ic+jd-D->padcl;
+        float *dst=ptrO+y*D->c;
+        if (D->sc==1) {
+#if OpenMP_VERSION_MAJOR >= 4
+          #pragma omp simd
+#endif
+          for(int x=xlo;x<xhi;x++) dst[x]+=w*src[x];
+        }
+        else {
+          for(int x=xlo;x<xhi;x++) dst[x]+=w*src[x*D->sc];
+        }
+      }
+    }
+  }
+}
 
-    im2col(b,D,ptrI,0);
+void cpu_conv2D(ConvolDescriptor *D)
+{
+  _profile(_CPU_CONV2D, 0);
 
-    matO=matI*D->matK;
-  }// batch
+  if (D->algo==CONV_ALGO_GEMM1X1) conv2D_gemm1x1(D);
+  else if (D->algo==CONV_ALGO_WINOGRAD) conv2D_winograd(D);
+  else if (D->algo==CONV_ALGO_DEPTHWISE) conv2D_depthwise(D);
+  else conv2D_im2col(D);
 
-  //bias
-  if (D->use_bias) {
+  //bias and activation (im2col and 1x1 apply them per tile)
+  bool tiled=(D->algo!=CONV_ALGO_WINOGRAD)&&(D->algo!=CONV_ALGO_DEPTHWISE);
+  if ((!tiled) && (D->use_bias || (D->act!=EPI_NONE))) {
+    int rcsize=D->r*D->c;
     #pragma omp parallel for
-    for(int b=0;b<D->O->shape[0];b++) {
-      float *ptrO=D->O->ptr+(b*osize);
-      for(int z=0;z<D->O->shape[1];z++)
-      for(int r=0;r<D->O->shape[2];r++)
-      for(int c=0;c<D->O->shape[3];c++,ptrO++)
-      (*ptrO)+=D->bias->ptr[z];
-    }
+    for(int p=0;p<D->O->shape[0]*D->z;p++)
+      cpu_epilogue(D->O->ptr+(long int)p*rcsize,rcsize,D->use_bias?D->bias->ptr[p%D->z]:0.0f,D->act,D->act_param);
   }
     _profile(_CPU_CONV2D, 1);
 
 }
 
+// Lowered input of a tile: for 1x1 kernels the input sample itself
+float *conv_lower(ConvolDescriptor *D,int b,int g,int p0,int np,float *ptrT)
+{
+  if (D->algo==CONV_ALGO_GEMM1X1) return D->I->ptr+(long int)b*D->iz*D->ir*D->ic;
+
+  im2col_tile(D,b,g,p0,np,ptrT,0);
+  return ptrT;
+}
+
 void cpu_conv2D_grad(ConvolDescriptor *D)
 {
   _profile(_CPU_CONV2D_GRAD, 0);
-  //return;
+  int batch=D->I->shape[0];
   int osize=D->z*D->r*D->c;
-  int isize=D->r*D->c*D->kc*D->kr*D->kz;//r*c,kr*kc*kz
+  int rcsize=D->r*D->c;
+  int ksize=D->kr*D->kc*D->kz;
+  int gksize=ksize*D->nk;
+
+  int nth=1;
+#ifdef _OPENMP
+  nth=omp_get_max_threads();
+#endif
+  int nkg=D->nk/D->groups;
+  bool direct=(D->algo==CONV_ALGO_GEMM1X1);
+  int trows=(direct) ? rcsize : conv_tile_rows(D,nth);
+  int ntiles=(rcsize+trows-1)/trows;
+  int total=batch*D->groups*ntiles;
+  if (nth>total) nth=total;
+
+  // The input is lowered again tile by tile, nothing is kept from the forward
+  long int wsize=(direct) ? 0 : (long int)trows*ksize;
+  float *ws=conv_workspace(nth*wsize);
+
+  if (nth==1) {
+    // Single stream: Eigen can use its own threads inside each product
+    Eigen::Map<Eigen::MatrixXf> matgK(D->gK->ptr,ksize,D->nk);
+    for(int t=0;t<total;t++){
+      int b=t/(D->groups*ntiles);
+      int g=(t/ntiles)%D->groups;
+      int p0=(t%ntiles)*trows;
+      int np=std::min(trows,rcsize-p0);
+
+      Eigen::Map<Eigen::MatrixXf> matT(conv_lower(D,b,g,p0,np,ws),np,ksize);
+      Eigen::Map<Eigen::MatrixXf> matD(D->D->ptr+(b*osize),rcsize,D->z);
+
+      matgK.middleCols(g*nkg,nkg).noalias()+=matT.transpose()*matD.block(p0,g*nkg,np,nkg);
+    }
+  }
+  else {
+    // Each thread accumulates a contiguous block of tiles in its own buffer
+    // (thread 0 directly in gK), then the buffers are reduced into gK
+    if (D->size_gKt<(nth-1)*gksize) {
+      free_fmem(D->ptrgKt);
+      D->size_gKt=(nth-1)*gksize;
+      D->ptrgKt=get_fmem(D->size_gKt,"cpu_conv2D_grad");
+    }
 
-  // Map memory to Eigen
-  new(&D->matgK) Eigen::Map<Eigen::MatrixXf>(D->gK->ptr, D->kr * D->kc * D->kz, D->nk);
+    #pragma omp parallel num_threads(nth)
+    {
+      int th=conv_thread_id();
+      int start=((long int)th*total)/nth;
+      int end=((long int)(th+1)*total)/nth;
 
-  //#pragma omp parallel for
-  for(int b=0;b<D->I->shape[0];b++){
+      float *ptrT=ws+th*wsize;
+      float *ptrgK=(th==0) ? D->gK->ptr : D->ptrgKt+((th-1)*gksize);
+      Eigen::Map<Eigen::MatrixXf> matgK(ptrgK,ksize,D->nk);
+      if (th>0) matgK.setZero();
 
-    float *ptrD=D->D->ptr+(b*osize);
-    float *ptrI=D->ptrI+(b*isize);
+      for(int t=start;t<end;t++){
+        int b=t/(D->groups*ntiles);
+        int g=(t/ntiles)%D->groups;
+        int p0=(t%ntiles)*trows;
+        int np=std::min(trows,rcsize-p0);
 
-    Eigen::Map<Eigen::MatrixXf> matI=Eigen::Map<Eigen::MatrixXf>(ptrI,D->r*D->c,D->kz*D->kr*D->kc);
-    Eigen::Map<Eigen::MatrixXf> matD=Eigen::Map<Eigen::MatrixXf>(ptrD,D->r*D->c,D->z);
+        Eigen::Map<Eigen::MatrixXf> matT(conv_lower(D,b,g,p0,np,ptrT),np,ksize);
+        Eigen::Map<Eigen::MatrixXf> matD(D->D->ptr+(b*osize),rcsize,D->z);
 
-    D->matgK+=matI.transpose()*matD;
-  }// batch
+        matgK.middleCols(g*nkg,nkg).noalias()+=matT.transpose()*matD.block(p0,g*nkg,np,nkg);
+      }
+    }
 
-  //bias
+    float *gK=D->gK->ptr;
+    float *gKt=D->ptrgKt;
+#if OpenMP_VERSION_MAJOR >= 4
+    #pragma omp parallel for simd
+#else
+    #pragma omp parallel for
+#endif
+    for(int i=0;i<gksize;i++) {
+      float acc=gK[i];
+      for(int t=0;t<nth-1;t++) acc+=gKt[t*gksize+i];
+      gK[i]=acc;
+    }
+  }
 
-  //#pragma omp parallel for
+  //bias
   if (D->use_bias) {
-    for(int b=0;b<D->D->shape[0];b++) {
-      float *ptrD=D->D->ptr+(b*osize);
-      for(int z=0;z<D->D->shape[1];z++)
-      for(int r=0;r<D->D->shape[2];r++)
-      for(int c=0;c<D->D->shape[3];c++,ptrD++)
-      D->gbias->ptr[z]+=(*ptrD);
-
+    #pragma omp parallel for
+    for(int z=0;z<D->z;z++) {
+      float sum=0.0f;
+      for(int b=0;b<batch;b++) {
+        float *ptrD=D->D->ptr+(b*osize)+(z*rcsize);
+#if OpenMP_VERSION_MAJOR >= 4
+        #pragma omp simd reduction(+:sum)
+#endif
+        for(int i=0;i<rcsize;i++) sum+=ptrD[i];
+      }
+      D->gbias->ptr[z]+=sum;
     }
   }
     _profile(_CPU_CONV2D_GRAD, 1);
@@ -167,29 +560,51 @@ void cpu_conv2D_grad(ConvolDescriptor *D)
 void cpu_conv2D_back(ConvolDescriptor *D)
 {
   _profile(_CPU_CONV2D_BACK, 0);
+  int batch=D->I->shape[0];
   int osize=D->z*D->r*D->c;
-  int isize=D->r*D->c*D->kc*D->kr*D->kz;//r*c,kr*kc*kz
-
-  float *ptrD=D->D->ptr;
-  float *ptrI=D->ptrI;
-
-  // Map memory to Eigen
-  new(&D->matK) Eigen::Map<Eigen::MatrixXf>(D->K->ptr, D->kr * D->kc * D->kz, D->nk);
-  new (&(D->matI)) Eigen::Map<Eigen::MatrixXf>(ptrI,D->r*D->c,D->kz*D->kr*D->kc);
-
-  #pragma omp parallel for
-  for(int b=0;b<D->I->shape[0];b++){
-
-    float *ptrD=D->D->ptr+(b*osize);
-    float *ptrI=D->ptrI+(b*isize);
-
-    Eigen::Map<Eigen::MatrixXf> matI=Eigen::Map<Eigen::MatrixXf>(ptrI,D->r*D->c,D->kz*D->kr*D->kc);
-    Eigen::Map<Eigen::MatrixXf> matD=Eigen::Map<Eigen::MatrixXf>(ptrD,D->r*D->c,D->z);
+  int rcsize=D->r*D->c;
+  int ksize=D->kr*D->kc*D->kz;
+
+  // Tiles of the same sample overlap in the input, so threads split the
+  // batch and the groups (disjoint input channels)
+  int nkg=D->nk/D->groups;
+  int total=batch*D->groups;
+  int nth=1;
+#ifdef _OPENMP
+  nth=omp_get_max_threads();
+#endif
+  if (nth>total) nth=total;
+  bool direct=(D->algo==CONV_ALGO_GEMM1X1);
+  int trows=(direct) ? rcsize : conv_tile_rows(D,nth);
+  int ntiles=(rcsize+trows-1)/trows;
+
+  long int wsize=(direct) ? 0 : (long int)trows*ksize;
+  float *ws=conv_workspace(nth*wsize);
+  Eigen::Map<Eigen::MatrixXf> matK(D->K->ptr,ksize,D->nk);
+
+  #pragma omp parallel for num_threads(nth)
+  for(int bg=0;bg<total;bg++){
+    int b=bg/D->groups;
+    int g=bg%D->groups;
+    float *ptrT=ws+conv_thread_id()*wsize;
+    Eigen::Map<Eigen::MatrixXf> matD(D->D->ptr+(b*osize),rcsize,D->z);
+
+    if (direct) {
+      // 1x1: the delta of the input is the lowered matrix itself
+      Eigen::Map<Eigen::MatrixXf> matID(D->ID->ptr+((long int)b*D->iz*D->ir*D->ic),rcsize,D->iz);
+      matID.noalias()+=matD*matK.transpose();
+      continue;
+    }
 
-    matI=matD*D->matK.transpose();
+    for(int t=0;t<ntiles;t++) {
+      int p0=t*trows;
+      int np=std::min(trows,rcsize-p0);
 
-    im2col(b,D,ptrI,1);
+      Eigen::Map<Eigen::MatrixXf> matT(ptrT,np,ksize);
+      matT.noalias()=matD.block(p0,g*nkg,np,nkg)*matK.middleCols(g*nkg,nkg).transpose();
 
+      im2col_tile(D,b,g,p0,np,ptrT,1);
+    }
   }// batch
     _profile(_CPU_CONV2D_BACK, 1);
 }
@@ -0,0 +1,71 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.7
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: April 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+
+#include <cstdio>      /* printf, scanf, NULL */
+#include <cstdlib>     /* malloc, free, rand */
+#include <iostream>
+
+#include "eddl/hardware/cpu/nn/cpu_tensor_nn.h"
+#include "eddl/random.h"
+
+
+// Dropout masks are packed 32 elements per word, bit i%32 of word i/32 keeps
+// element i. Each word takes the 32 draws of 8 Philox blocks.
+void cpu_dropout_forward(Tensor *A, Tensor *B, unsigned int *mask, float keep, float scale){
+  _profile(_CPU_DROPOUT_FORWARD, 0);
+  long int n = A->size;
+  long int nw = (n + 31) / 32;
+  uint64_t base = reserve_rand(nw * 32) >> 2;
+  uint64_t key = get_rand_seed();
+  float *a = A->ptr;
+  float *b = B->ptr;
+
+  #pragma omp parallel for
+  for (long int w = 0; w < nw; w++) {
+    unsigned int bits = 0;
+    for (int q = 0; q < 8; q++) {
+      uint32_t r[4];
+      philox4x32(base + w * 8 + q, key, r);
+      for (int k = 0; k < 4; k++)
+        bits |= (unsigned int) (rand_word_to_float(r[k]) < keep) << (q * 4 + k);
+    }
+    mask[w] = bits;
+
+    long int s = w * 32;
+    int e = (n - s < 32) ? (int) (n - s) : 32;
+#if OpenMP_VERSION_MAJOR >= 4
+    #pragma omp simd
+#endif
+    for (int j = 0; j < e; j++)
+      b[s + j] = a[s + j] * (scale * (float) ((bits >> j) & 1u));
+  }
+  _profile(_CPU_DROPOUT_FORWARD, 1);
+}
+
+void cpu_dropout_backward(Tensor *D, Tensor *PD, unsigned int *mask, float scale){
+  _profile(_CPU_DROPOUT_BACKWARD, 0);
+  long int n = D->size;
+  long int nw = (n + 31) / 32;
+  float *d = D->ptr;
+  float *pd = PD->ptr;
+
+  #pragma omp parallel for
+  for (long int w = 0; w < nw; w++) {
+    unsigned int bits = mask[w];
+    long int s = w * 32;
+    int e = (n - s < 32) ? (int) (n - s) : 32;
+#if OpenMP_VERSION_MAJOR >= 4
+    #pragma omp simd
+#endif
+    for (int j = 0; j < e; j++)
+      pd[s + j] += d[s + j] * (scale * (float) ((bits >> j) & 1u));
+  }
+  _profile(_CPU_DROPOUT_BACKWARD, 1);
+}
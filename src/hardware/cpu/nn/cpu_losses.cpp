@@ -11,6 +11,7 @@
 #include <cstdio>      /* printf, scanf, NULL */
 #include <cstdlib>     /* malloc, free, rand */
 #include <iostream>
+#include <cmath>
 
 #include "eddl/hardware/cpu/nn/cpu_tensor_nn.h"
 
@@ -25,3 +26,84 @@ void cpu_cent(Tensor *A, Tensor *B, Tensor *C){
   }
     _profile(_CPU_CENT, 1);
 }
+
+// Cross-entropy of the softmax output Y, summed over all the elements as cpu_cent,
+// and its delta D=(Y-T)/batch wrt the softmax input, in a single pass
+float cpu_softmax_cent(Tensor *T, Tensor *Y, Tensor *D){
+  _profile(_CPU_SOFTMAX_CENT, 0);
+  int n = T->shape[1];
+  float inv = 1.0f / T->shape[0];
+  float *t = T->ptr;
+  float *y = Y->ptr;
+  float *d = (D != nullptr) ? D->ptr : nullptr;
+  double loss = 0.0;
+
+  #pragma omp parallel for reduction(+:loss)
+  for (int i = 0; i < T->shape[0]; i++) {
+    long p = (long)i * n;
+    float c = 0.0f;
+#if OpenMP_VERSION_MAJOR >= 4
+    #pragma omp simd reduction(+:c)
+#endif
+    for (int j = 0; j < n; j++) {
+      float tj = t[p + j], yj = y[p + j];
+      if (tj != 0.0f) c -= tj * std::log(yj + 0.00001f);
+      if (tj != 1.0f) c -= (1.0f - tj) * std::log(1.0f - yj + 0.00001f);
+    }
+    loss += c;
+
+    if (d != nullptr) {
+#if OpenMP_VERSION_MAJOR >= 4
+      #pragma omp simd
+#endif
+      for (int j = 0; j < n; j++) d[p + j] = (y[p + j] - t[p + j]) * inv;
+    }
+  }
+    _profile(_CPU_SOFTMAX_CENT, 1);
+  return (float)loss;
+}
+
+// Cross-entropy of Y against the class indices T (batch x 1), equal to cpu_cent on
+// the one-hot targets summed over all the elements. D, if given, is the delta of
+// the one-hot loss: wrt the softmax input, (Y-T)/batch, or wrt Y as cross_entropy
+float cpu_sparse_cent(Tensor *T, Tensor *Y, Tensor *D, bool softmax){
+  _profile(_CPU_SPARSE_CENT, 0);
+  int n = Y->shape[1];
+  float inv = 1.0f / Y->shape[0];
+  float eps = 0.000001f;
+  float *y = Y->ptr;
+  float *d = (D != nullptr) ? D->ptr : nullptr;
+  double loss = 0.0;
+
+  #pragma omp parallel for reduction(+:loss)
+  for (int i = 0; i < Y->shape[0]; i++) {
+    long p = (long)i * n;
+    int k = (int)T->ptr[i];
+    float c = 0.0f;
+#if OpenMP_VERSION_MAJOR >= 4
+    #pragma omp simd reduction(+:c)
+#endif
+    for (int j = 0; j < n; j++) c -= std::log(1.0f - y[p + j] + 0.00001f);
+    c += std::log(1.0f - y[p + k] + 0.00001f) - std::log(y[p + k] + 0.00001f);
+    loss += c;
+
+    if (d != nullptr) {
+      if (softmax) {
+#if OpenMP_VERSION_MAJOR >= 4
+        #pragma omp simd
+#endif
+        for (int j = 0; j < n; j++) d[p + j] = y[p + j] * inv;
+        d[p + k] -= inv;
+      }
+      else {
+#if OpenMP_VERSION_MAJOR >= 4
+        #pragma omp simd
+#endif
+        for (int j = 0; j < n; j++) d[p + j] = inv / (1.0f - y[p + j] + eps);
+        d[p + k] = -inv / (y[p + k] + eps);
+      }
+    }
+  }
+    _profile(_CPU_SPARSE_CENT, 1);
+  return (float)loss;
+}
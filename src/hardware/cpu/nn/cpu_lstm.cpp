@@ -0,0 +1,107 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.7
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: April 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+
+#include <cstdio>      /* printf, scanf, NULL */
+#include <cstdlib>     /* malloc, free, rand */
+#include <iostream>
+#include <cmath>
+
+#include "eddl/hardware/cpu/nn/cpu_tensor_nn.h"
+
+
+// Gates are packed as [i|f|o|c] in the rows of G (batch x 4*units). On entry G holds
+// X*Wx+H*Wh, on exit the activated gates. hprev/cprev are null on the first step.
+// With a mask, samples with an all-zero input keep the previous states.
+void cpu_lstm_forward(Tensor *X, Tensor *G, Tensor *bias, Tensor *hprev, Tensor *cprev,
+                      Tensor *mask, Tensor *sh, Tensor *h, Tensor *c){
+  _profile(_CPU_LSTM_FORWARD, 0);
+  int u = h->shape[1];
+  int d = X->shape[1];
+  float *b = bias->ptr;
+
+  #pragma omp parallel for
+  for (int r = 0; r < h->shape[0]; r++) {
+    long p = (long)r * u;
+    float *g = G->ptr + 4 * p;
+
+    if (mask != nullptr) {
+      float *x = X->ptr + (long)r * d;
+      int k = 0;
+      while ((k < d) && (x[k] == 0.0f)) k++;
+      mask->ptr[r] = (k < d) ? 1.0f : 0.0f;
+
+      if (k == d) {
+        for (int j = 0; j < u; j++) {
+          h->ptr[p + j] = (hprev != nullptr) ? hprev->ptr[p + j] : 0.0f;
+          c->ptr[p + j] = (cprev != nullptr) ? cprev->ptr[p + j] : 0.0f;
+        }
+        continue;
+      }
+    }
+
+    for (int j = 0; j < u; j++) {
+      float i = 1.0f / (1.0f + std::exp(-(g[j] + b[j])));
+      float f = 1.0f / (1.0f + std::exp(-(g[u + j] + b[u + j])));
+      float o = 1.0f / (1.0f + std::exp(-(g[2 * u + j] + b[2 * u + j])));
+      float n = std::tanh(g[3 * u + j] + b[3 * u + j]);
+      g[j] = i; g[u + j] = f; g[2 * u + j] = o; g[3 * u + j] = n;
+
+      float cc = i * n;
+      if (cprev != nullptr) cc += f * cprev->ptr[p + j];
+      float s = std::tanh(cc);
+      c->ptr[p + j] = cc;
+      sh->ptr[p + j] = s;
+      h->ptr[p + j] = o * s;
+    }
+  }
+  _profile(_CPU_LSTM_FORWARD, 1);
+}
+
+// Delta of the gate pre-activations DG from the deltas of the states dh, dc.
+// The deltas of the previous states, if any, are incremented; masked samples
+// pass dh and dc through unchanged.
+void cpu_lstm_backward(Tensor *G, Tensor *cprev, Tensor *sh, Tensor *mask, Tensor *dh, Tensor *dc,
+                       Tensor *DG, Tensor *dhprev, Tensor *dcprev){
+  _profile(_CPU_LSTM_BACKWARD, 0);
+  int u = dh->shape[1];
+
+  #pragma omp parallel for
+  for (int r = 0; r < dh->shape[0]; r++) {
+    long p = (long)r * u;
+    float *g = G->ptr + 4 * p;
+    float *dg = DG->ptr + 4 * p;
+
+    if ((mask != nullptr) && (mask->ptr[r] == 0.0f)) {
+      for (int j = 0; j < 4 * u; j++) dg[j] = 0.0f;
+      for (int j = 0; j < u; j++) {
+        if (dhprev != nullptr) dhprev->ptr[p + j] += dh->ptr[p + j];
+        if (dcprev != nullptr) dcprev->ptr[p + j] += dc->ptr[p + j];
+      }
+      continue;
+    }
+
+    for (int j = 0; j < u; j++) {
+      float i = g[j], f = g[u + j], o = g[2 * u + j], n = g[3 * u + j];
+      float s = sh->ptr[p + j];
+      float dhj = dh->ptr[p + j];
+      float dct = dc->ptr[p + j] + dhj * o * (1.0f - s * s);
+
+      dg[j] = dct * n * i * (1.0f - i);
+      dg[2 * u + j] = dhj * s * o * (1.0f - o);
+      dg[3 * u + j] = dct * i * (1.0f - n * n);
+      if (cprev != nullptr) {
+        dg[u + j] = dct * cprev->ptr[p + j] * f * (1.0f - f);
+        dcprev->ptr[p + j] += dct * f;
+      }
+      else dg[u + j] = 0.0f;
+    }
+  }
+  _profile(_CPU_LSTM_BACKWARD, 1);
+}
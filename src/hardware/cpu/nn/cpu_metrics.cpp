@@ -37,3 +37,20 @@ int cpu_bin_accuracy(Tensor *A, Tensor *B){
 
   return acc;
 }
+
+int cpu_sparse_accuracy(Tensor *T, Tensor *Y){
+  _profile(_CPU_SPARSE_ACCURACY, 0);
+  int acc = 0;
+  int n = Y->shape[1];
+
+  #pragma omp parallel for reduction(+:acc)
+  for (int i = 0; i < Y->shape[0]; i++) {
+    float *row = Y->ptr + (long)i * n;
+    int ind = 0;
+    for (int j = 1; j < n; j++)
+      if (row[j] > row[ind]) ind = j;
+    if (ind == (int)T->ptr[i]) acc++;
+  }
+  _profile(_CPU_SPARSE_ACCURACY, 1);
+  return acc;
+}
@@ -0,0 +1,144 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.7
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: April 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <cstdio>      /* printf, scanf, NULL */
+#include <cstdlib>     /* malloc, free, rand */
+#include <iostream>
+#include <cmath>
+
+#include "eddl/hardware/cpu/nn/cpu_tensor_nn.h"
+
+// Each kernel reads param, gradient and state once and writes param and state once.
+// The gradient is left untouched.
+
+void cpu_sgd_update(Tensor *P, Tensor *G, Tensor *M, float lr, float mu, float weight_decay, bool nesterov) {
+    _profile(_CPU_SGD_UPDATE, 0);
+    float *p = P->ptr;
+    float *g = G->ptr;
+    float *m = M->ptr;
+    int size = P->size;
+
+#if OpenMP_VERSION_MAJOR >= 4
+    #pragma omp parallel for simd
+#else
+    #pragma omp parallel for
+#endif
+    for (int i = 0; i < size; i++) {
+        float gi = g[i] + weight_decay * p[i];
+        float mi = mu * m[i] + lr * gi;
+        m[i] = mi;
+        p[i] -= nesterov ? (mu * mi + lr * gi) : mi;
+    }
+    _profile(_CPU_SGD_UPDATE, 1);
+}
+
+void cpu_adam_update(Tensor *P, Tensor *G, Tensor *M, Tensor *V, float step, float beta_1, float beta_2, float inv_bc2, float epsilon, float weight_decay) {
+    _profile(_CPU_ADAM_UPDATE, 0);
+    float *p = P->ptr;
+    float *g = G->ptr;
+    float *m = M->ptr;
+    float *v = V->ptr;
+    int size = P->size;
+    float ob1 = 1.0f - beta_1;
+    float ob2 = 1.0f - beta_2;
+
+#if OpenMP_VERSION_MAJOR >= 4
+    #pragma omp parallel for simd
+#else
+    #pragma omp parallel for
+#endif
+    for (int i = 0; i < size; i++) {
+        float gi = g[i] + weight_decay * p[i];
+        float mi = beta_1 * m[i] + ob1 * gi;
+        float vi = beta_2 * v[i] + ob2 * gi * gi;
+        m[i] = mi;
+        v[i] = vi;
+        p[i] -= step * mi / ::sqrtf(vi * inv_bc2 + epsilon);
+    }
+    _profile(_CPU_ADAM_UPDATE, 1);
+}
+
+void cpu_rmsprop_update(Tensor *P, Tensor *G, Tensor *G1, float lr, float rho, float epsilon, float weight_decay) {
+    _profile(_CPU_RMSPROP_UPDATE, 0);
+    float *p = P->ptr;
+    float *g = G->ptr;
+    float *g1 = G1->ptr;
+    int size = P->size;
+    float orho = 1.0f - rho;
+
+#if OpenMP_VERSION_MAJOR >= 4
+    #pragma omp parallel for simd
+#else
+    #pragma omp parallel for
+#endif
+    for (int i = 0; i < size; i++) {
+        float gi = g[i] + weight_decay * p[i];
+        float prev = g1[i];
+        float ms = orho * gi * gi + rho * prev * prev;
+        g1[i] = gi;
+        p[i] -= lr * gi / ::sqrtf(ms + epsilon);
+    }
+    _profile(_CPU_RMSPROP_UPDATE, 1);
+}
+
+// Row-sparse variants: only the listed rows of the 2D param are updated, the
+// state of the other rows is left as is (lazy moments)
+
+void cpu_sgd_update_rows(Tensor *P, Tensor *G, Tensor *M, const vector<int> &rows, float lr, float mu, float weight_decay, bool nesterov) {
+    _profile(_CPU_SGD_UPDATE_ROWS, 0);
+    int dim = P->size / P->shape[0];
+    int nrows = rows.size();
+
+    #pragma omp parallel for
+    for (int r = 0; r < nrows; r++) {
+        long int o = (long int) rows[r] * dim;
+        float *p = P->ptr + o;
+        float *g = G->ptr + o;
+        float *m = M->ptr + o;
+#if OpenMP_VERSION_MAJOR >= 4
+        #pragma omp simd
+#endif
+        for (int i = 0; i < dim; i++) {
+            float gi = g[i] + weight_decay * p[i];
+            float mi = mu * m[i] + lr * gi;
+            m[i] = mi;
+            p[i] -= nesterov ? (mu * mi + lr * gi) : mi;
+        }
+    }
+    _profile(_CPU_SGD_UPDATE_ROWS, 1);
+}
+
+void cpu_adam_update_rows(Tensor *P, Tensor *G, Tensor *M, Tensor *V, const vector<int> &rows, float step, float beta_1, float beta_2, float inv_bc2, float epsilon, float weight_decay) {
+    _profile(_CPU_ADAM_UPDATE_ROWS, 0);
+    int dim = P->size / P->shape[0];
+    int nrows = rows.size();
+    float ob1 = 1.0f - beta_1;
+    float ob2 = 1.0f - beta_2;
+
+    #pragma omp parallel for
+    for (int r = 0; r < nrows; r++) {
+        long int o = (long int) rows[r] * dim;
+        float *p = P->ptr + o;
+        float *g = G->ptr + o;
+        float *m = M->ptr + o;
+        float *v = V->ptr + o;
+#if OpenMP_VERSION_MAJOR >= 4
+        #pragma omp simd
+#endif
+        for (int i = 0; i < dim; i++) {
+            float gi = g[i] + weight_decay * p[i];
+            float mi = beta_1 * m[i] + ob1 * gi;
+            float vi = beta_2 * v[i] + ob2 * gi * gi;
+            m[i] = mi;
+            v[i] = vi;
+            p[i] -= step * mi / ::sqrtf(vi * inv_bc2 + epsilon);
+        }
+    }
+    _profile(_CPU_ADAM_UPDATE_ROWS, 1);
+}
@@ -51,7 +51,7 @@ bool fpga_all(Tensor *A){
     cl_int err;
     cl::Event event;
 
-    OCL_CHECK(err, err = kernel_all.setArg(0, *(A->fpga_ptr)));
+    OCL_CHECK(err, err = kernel_all.setArg(0, *fpga_kernel_in(A)));
     OCL_CHECK(err, err = kernel_all.setArg(1, (long int)A->size));
 
     OCL_CHECK(err, err = q.enqueueTask(kernel_all, NULL, &event));
@@ -79,7 +79,7 @@ bool fpga_any(Tensor *A){
     cl_int err;
     cl::Event event;
 
-    OCL_CHECK(err, err = kernel_any.setArg(0, *(A->fpga_ptr)));
+    OCL_CHECK(err, err = kernel_any.setArg(0, *fpga_kernel_in(A)));
     OCL_CHECK(err, err = kernel_any.setArg(1, (long int)A->size));
 
     OCL_CHECK(err, err = q.enqueueTask(kernel_any, NULL, &event));
@@ -108,8 +108,8 @@ void fpga_isfinite(Tensor *A, Tensor* B){
     cl_int err;
     cl::Event event;
 
-    OCL_CHECK(err, err = kernel_isfinite.setArg(0, *(A->fpga_ptr)));
-    OCL_CHECK(err, err = kernel_isfinite.setArg(1, *(B->fpga_ptr)));
+    OCL_CHECK(err, err = kernel_isfinite.setArg(0, *fpga_kernel_in(A)));
+    OCL_CHECK(err, err = kernel_isfinite.setArg(1, *fpga_kernel_out(B)));
     OCL_CHECK(err, err = kernel_isfinite.setArg(2, (long int)A->size));
 
     OCL_CHECK(err, err = q.enqueueTask(kernel_isfinite, NULL, &event));
@@ -135,8 +135,8 @@ void fpga_isinf(Tensor *A, Tensor* B){
     cl_int err;
     cl::Event event;
 
-    OCL_CHECK(err, err = kernel_isinf.setArg(0, *(A->fpga_ptr)));
-    OCL_CHECK(err, err = kernel_isinf.setArg(1, *(B->fpga_ptr)));
+    OCL_CHECK(err, err = kernel_isinf.setArg(0, *fpga_kernel_in(A)));
+    OCL_CHECK(err, err = kernel_isinf.setArg(1, *fpga_kernel_out(B)));
     OCL_CHECK(err, err = kernel_isinf.setArg(2, (long int)A->size));
 
     OCL_CHECK(err, err = q.enqueueTask(kernel_isinf, NULL, &event));
@@ -162,8 +162,8 @@ void fpga_isnan(Tensor *A, Tensor* B){
     cl_int err;
     cl::Event event;
 
-    OCL_CHECK(err, err = kernel_isnan.setArg(0, *(A->fpga_ptr)));
-    OCL_CHECK(err, err = kernel_isnan.setArg(1, *(B->fpga_ptr)));
+    OCL_CHECK(err, err = kernel_isnan.setArg(0, *fpga_kernel_in(A)));
+    OCL_CHECK(err, err = kernel_isnan.setArg(1, *fpga_kernel_out(B)));
     OCL_CHECK(err, err = kernel_isnan.setArg(2, (long int)A->size));
 
     OCL_CHECK(err, err = q.enqueueTask(kernel_isnan, NULL, &event));
@@ -188,8 +188,8 @@ void fpga_isneginf(Tensor *A, Tensor* B){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_isneginf.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_isneginf.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_isneginf.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_isneginf.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_isneginf.setArg(2, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_isneginf, NULL, &event));
@@ -215,8 +215,8 @@ void fpga_isposinf(Tensor *A, Tensor* B){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_isposinf.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_isposinf.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_isposinf.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_isposinf.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_isposinf.setArg(2, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_isposinf, NULL, &event));
@@ -245,9 +245,9 @@ void fpga_logical_and(Tensor *A, Tensor *B, Tensor *C){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_logical_and.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_logical_and.setArg(1, *(B->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_logical_and.setArg(2, *(C->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_logical_and.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_logical_and.setArg(1, *fpga_kernel_in(B)));
+  OCL_CHECK(err, err = kernel_logical_and.setArg(2, *fpga_kernel_out(C)));
   OCL_CHECK(err, err = kernel_logical_and.setArg(3, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_logical_and, NULL, &event));
@@ -274,9 +274,9 @@ void fpga_logical_or(Tensor *A, Tensor *B, Tensor *C){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_logical_or.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_logical_or.setArg(1, *(B->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_logical_or.setArg(2, *(C->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_logical_or.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_logical_or.setArg(1, *fpga_kernel_in(B)));
+  OCL_CHECK(err, err = kernel_logical_or.setArg(2, *fpga_kernel_out(C)));
   OCL_CHECK(err, err = kernel_logical_or.setArg(3, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_logical_or, NULL, &event));
@@ -302,8 +302,8 @@ void fpga_logical_not(Tensor *A, Tensor *B){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_logical_not.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_logical_not.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_logical_not.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_logical_not.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_logical_not.setArg(2, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_logical_not, NULL, &event));
@@ -330,9 +330,9 @@ void fpga_logical_xor(Tensor *A, Tensor *B, Tensor *C){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_logical_xor.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_logical_xor.setArg(1, *(B->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_logical_xor.setArg(2, *(C->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_logical_xor.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_logical_xor.setArg(1, *fpga_kernel_in(B)));
+  OCL_CHECK(err, err = kernel_logical_xor.setArg(2, *fpga_kernel_out(C)));
   OCL_CHECK(err, err = kernel_logical_xor.setArg(3, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_logical_not, NULL, &event));
@@ -397,9 +397,9 @@ void fpga_isclose(Tensor *A, Tensor *B, Tensor *C, float rtol, float atol, bool
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_isclose.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_isclose.setArg(1, *(B->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_isclose.setArg(2, *(C->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_isclose.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_isclose.setArg(1, *fpga_kernel_in(B)));
+  OCL_CHECK(err, err = kernel_isclose.setArg(2, *fpga_kernel_out(C)));
   OCL_CHECK(err, err = kernel_isclose.setArg(3, rtol));
   OCL_CHECK(err, err = kernel_isclose.setArg(4, atol));
   OCL_CHECK(err, err = kernel_isclose.setArg(5, equal_nan));
@@ -428,8 +428,8 @@ void fpga_greater(Tensor *A, Tensor *B, float v){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_greater_vector.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_greater_vector.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_greater_vector.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_greater_vector.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_greater_vector.setArg(2, v));
   OCL_CHECK(err, err = kernel_greater_vector.setArg(3, (long int)A->size));
 
@@ -458,9 +458,9 @@ void fpga_greater(Tensor *A, Tensor *B, Tensor *C){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_greater.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_greater.setArg(1, *(B->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_greater.setArg(2, *(C->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_greater.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_greater.setArg(1, *fpga_kernel_in(B)));
+  OCL_CHECK(err, err = kernel_greater.setArg(2, *fpga_kernel_out(C)));
   OCL_CHECK(err, err = kernel_greater.setArg(3, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_greater, NULL, &event));
@@ -486,8 +486,8 @@ void fpga_greater_equal(Tensor *A, Tensor *B, float v){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_greater_equal_vector.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_greater_equal_vector.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_greater_equal_vector.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_greater_equal_vector.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_greater_equal_vector.setArg(2, v));
   OCL_CHECK(err, err = kernel_greater_equal_vector.setArg(3, (long int)A->size));
 
@@ -516,9 +516,9 @@ void fpga_greater_equal(Tensor *A, Tensor *B, Tensor *C){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_greater_equal.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_greater_equal.setArg(1, *(B->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_greater_equal.setArg(2, *(C->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_greater_equal.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_greater_equal.setArg(1, *fpga_kernel_in(B)));
+  OCL_CHECK(err, err = kernel_greater_equal.setArg(2, *fpga_kernel_out(C)));
   OCL_CHECK(err, err = kernel_greater_equal.setArg(3, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_greater_equal, NULL, &event));
@@ -544,8 +544,8 @@ void fpga_less(Tensor *A, Tensor *B, float v){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_less_vector.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_less_vector.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_less_vector.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_less_vector.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_less_vector.setArg(2, v));
   OCL_CHECK(err, err = kernel_less_vector.setArg(3, (long int)A->size));
 
@@ -573,9 +573,9 @@ void fpga_less(Tensor *A, Tensor *B, Tensor *C){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_less.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_less.setArg(1, *(B->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_less.setArg(2, *(C->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_less.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_less.setArg(1, *fpga_kernel_in(B)));
+  OCL_CHECK(err, err = kernel_less.setArg(2, *fpga_kernel_out(C)));
   OCL_CHECK(err, err = kernel_less.setArg(3, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_less, NULL, &event));
@@ -601,8 +601,8 @@ void fpga_less_equal(Tensor *A, Tensor *B, float v){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_less_equal_vector.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_less_equal_vector.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_less_equal_vector.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_less_equal_vector.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_less_equal_vector.setArg(2, v));
   OCL_CHECK(err, err = kernel_less_equal_vector.setArg(3, (long int)A->size));
 
@@ -631,9 +631,9 @@ void fpga_less_equal(Tensor *A, Tensor *B, Tensor *C){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_less_equal.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_less_equal.setArg(1, *(B->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_less_equal.setArg(2, *(C->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_less_equal.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_less_equal.setArg(1, *fpga_kernel_in(B)));
+  OCL_CHECK(err, err = kernel_less_equal.setArg(2, *fpga_kernel_out(C)));
   OCL_CHECK(err, err = kernel_less_equal.setArg(3, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_less_equal, NULL, &event));
@@ -659,8 +659,8 @@ void fpga_equal(Tensor *A, Tensor *B, float v){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_equal_vector.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_equal_vector.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_equal_vector.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_equal_vector.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_equal_vector.setArg(2, v));
   OCL_CHECK(err, err = kernel_equal_vector.setArg(3, (long int)A->size));
 
@@ -689,9 +689,9 @@ void fpga_equal(Tensor *A, Tensor *B, Tensor *C){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_equal.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_equal.setArg(1, *(B->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_equal.setArg(2, *(C->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_equal.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_equal.setArg(1, *fpga_kernel_in(B)));
+  OCL_CHECK(err, err = kernel_equal.setArg(2, *fpga_kernel_out(C)));
   OCL_CHECK(err, err = kernel_equal.setArg(3, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_equal, NULL, &event));
@@ -717,8 +717,8 @@ void fpga_not_equal(Tensor *A, Tensor *B, float v){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_not_equal_vector.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_not_equal_vector.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_not_equal_vector.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_not_equal_vector.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_not_equal_vector.setArg(2, (float)v));
   OCL_CHECK(err, err = kernel_not_equal_vector.setArg(3, (long int)A->size));
 
@@ -747,9 +747,9 @@ void fpga_not_equal(Tensor *A, Tensor *B, Tensor *C){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_not_equal.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_not_equal.setArg(1, *(B->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_not_equal.setArg(2, *(C->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_not_equal.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_not_equal.setArg(1, *fpga_kernel_in(B)));
+  OCL_CHECK(err, err = kernel_not_equal.setArg(2, *fpga_kernel_out(C)));
   OCL_CHECK(err, err = kernel_not_equal.setArg(3, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_not_equal, NULL, &event));
@@ -249,6 +249,9 @@ void _profile_fpga_funcname(int i, char *name) {
       case _FPGA_REPEAT_NN              : strcpy(name, "repeat_nn"); break;
       case _FPGA_D_REPEAT_NN            : strcpy(name, "d_repeat_nn"); break;
       case _FPGA_SUM_2                  : strcpy(name, "sum_2"); break;
+      case _FPGA_SGD_UPDATE             : strcpy(name, "sgd_update"); break;
+      case _FPGA_ADAM_UPDATE            : strcpy(name, "adam_update"); break;
+      case _FPGA_RMSPROP_UPDATE         : strcpy(name, "rmsprop_update"); break;
       default                          : strcpy(name, "?????"); break;
   }
 }
@@ -1003,18 +1006,80 @@ void fpga_delete_tensor(int device, cl::Buffer *ptr, int fpga_tensor_id_p, int s
 //
 
 ///////////////////////////////////////////
+// ---------------------------------------------------
+// Host mirror
+//
+// Every FPGA tensor keeps a host copy in ptr (used by the cpu emulation of the
+// kernels). fpga_copy_to_fpga/fpga_copy_from_fpga only update that copy and its
+// state; the buffers are synchronized when a real kernel, a device copy or a
+// different host buffer needs the newest data.
+
+class FPGAMemory : public DeviceMemory {
+public:
+    void read(void *buf, float *host, long size) override {
+        cl_int err;
+        cl::Event event;
+        OCL_CHECK(err, err= q.enqueueReadBuffer(*((cl::Buffer *)buf), CL_TRUE, 0, size*sizeof(float), host, nullptr, &event));
+        q.finish();
+        reads++;
+        bytes_read += size*sizeof(float);
+    }
+
+    void write(void *buf, const float *host, long size) override {
+        cl_int err;
+        cl::Event blocking_event;
+        OCL_CHECK(err, err= q.enqueueWriteBuffer(*((cl::Buffer *)buf), CL_TRUE, 0, size*sizeof(float), host, nullptr, &blocking_event));
+        q.finish();
+        writes++;
+        bytes_written += size*sizeof(float);
+    }
+};
+
+static FPGAMemory fpga_memory_backend;
+DeviceMemory *fpga_memory = &fpga_memory_backend;
+
+// Writes back the host copy if it is newer
+void fpga_sync(Tensor *A)
+{
+    A->fpga_mirror->device_read(fpga_memory, A->fpga_ptr, A->ptr, A->size);
+}
+
+// Buffer of a tensor a kernel only reads: the device copy is made valid
+cl::Buffer *fpga_kernel_in(Tensor *A)
+{
+    fpga_sync(A);
+    return A->fpga_ptr;
+}
+
+// Buffer of a tensor a kernel writes: as above, and the host copy (of every
+// alias, the mirror is shared) is no longer trusted
+cl::Buffer *fpga_kernel_out(Tensor *A)
+{
+    fpga_sync(A);
+    A->fpga_mirror->device_write();
+    return A->fpga_ptr;
+}
+
 void fpga_copy_fpga(Tensor *A, Tensor *B)
 {
 #ifdef FPGA_DEBUG
     printf("    (copy fpga: tensor id %d (size %d, ptr %p) -> tensor id %d (size %d, ptr %p))\n", A->fpga_tensor_id, A->size, A->fpga_ptr, B->fpga_tensor_id, B->size, B->fpga_ptr);
 #endif
+    if (A->size > B->size) {printf("Error, copy_fpga beyond limits\n"); exit(1);}
+
+    // Host copy of A is newer: copy it on the host and keep both lazy
+    if (A->fpga_mirror->state == MIRROR_HOST) {
+        B->fpga_mirror->host_write(B->ptr, A->size, A->ptr);
+        return;
+    }
+
     cl_int err;
     cl::Event blocking_event;
     cl::Buffer *bufferA = A->fpga_ptr;
     cl::Buffer *bufferB = B->fpga_ptr;
-    if (A->size > B->size) {printf("Error, copy_fpga beyond limits\n"); exit(1);}
     OCL_CHECK(err, err= q.enqueueCopyBuffer(*bufferA, *bufferB, 0, 0, A->size*sizeof(float), NULL, &blocking_event));
     q.finish();
+    B->fpga_mirror->device_write();
 #ifdef FPGA_DEBUG
     printf("copy completed\n");
 #endif
@@ -1025,11 +1090,7 @@ void fpga_copy_to_fpga(float *nptr, Tensor *A)
 #ifdef FPGA_DEBUG
     printf("    (copy to fpga: tensor id %d, size %d, from_cpu_ptr %p)\n", A->fpga_tensor_id, A->size, nptr);
 #endif
-    cl_int err;
-    cl::Event blocking_event;
-    cl::Buffer *buf = A->fpga_ptr;
-    OCL_CHECK(err, err= q.enqueueWriteBuffer(*buf, CL_TRUE, 0, A->size*sizeof(float), nptr, nullptr, &blocking_event));
-    q.finish();
+    A->fpga_mirror->host_write(A->ptr, A->size, nptr);
 }
 
 ///////////////////////////////////////////
@@ -1038,10 +1099,7 @@ void fpga_copy_from_fpga(Tensor *A,float *nptr)
 #ifdef FPGA_DEBUG
     printf("    (copy from fpga: tensor id %d, size %d, to_cpu_ptr %p)\n", A->fpga_tensor_id, A->size, nptr);
 #endif
-    cl_int err;
-    cl::Event event;
-    OCL_CHECK(err, err= q.enqueueReadBuffer(*(A->fpga_ptr), CL_TRUE, 0, A->size*sizeof(float), nptr, nullptr, &event));
-    q.finish();;
+    A->fpga_mirror->host_read(fpga_memory, A->fpga_ptr, A->ptr, A->size, nptr);
 }
 
 void fpga_copy_addresses_from_fpga(SelDescriptor *SD, int size, int *nptr)
@@ -1109,8 +1167,8 @@ void fpga_transpose(Tensor * A, Tensor * B) {
     cl_int err;
     cl::Event event;
 
-    OCL_CHECK(err, err = kernel_transpose.setArg(0, *(A->fpga_ptr)));
-    OCL_CHECK(err, err = kernel_transpose.setArg(1, *(B->fpga_ptr)));
+    OCL_CHECK(err, err = kernel_transpose.setArg(0, *fpga_kernel_in(A)));
+    OCL_CHECK(err, err = kernel_transpose.setArg(1, *fpga_kernel_out(B)));
     OCL_CHECK(err, err = kernel_transpose.setArg(2, (long int)A->size));
 
     OCL_CHECK(err, err = q.enqueueTask(kernel_transpose, NULL, &event));
@@ -1158,7 +1216,7 @@ void fpga_fill_(Tensor *A, float v){
     cl_int err;
     cl::Event event;
 
-    OCL_CHECK(err, err = kernel_fill_.setArg(0, *(A->fpga_ptr)));
+    OCL_CHECK(err, err = kernel_fill_.setArg(0, *fpga_kernel_out(A)));
     OCL_CHECK(err, err = kernel_fill_.setArg(1, v));
     OCL_CHECK(err, err = kernel_fill_.setArg(2, (long int)A->size));
 
@@ -1185,10 +1243,10 @@ void fpga_fill(Tensor *A, int aini, int aend, Tensor *B, int bini, int bend, int
     cl_int err;
     cl::Event event;
 
-    OCL_CHECK(err, err = kernel_fill.setArg(0, *(A->fpga_ptr)));
+    OCL_CHECK(err, err = kernel_fill.setArg(0, *fpga_kernel_in(A)));
     OCL_CHECK(err, err = kernel_fill.setArg(1, (int)aini));
     OCL_CHECK(err, err = kernel_fill.setArg(2, (int)aend));
-    OCL_CHECK(err, err = kernel_fill.setArg(3, *(B->fpga_ptr)));
+    OCL_CHECK(err, err = kernel_fill.setArg(3, *fpga_kernel_out(B)));
     OCL_CHECK(err, err = kernel_fill.setArg(4, (int)bini));
     OCL_CHECK(err, err = kernel_fill.setArg(5, (int)bend));
     OCL_CHECK(err, err = kernel_fill.setArg(6, (int)inc));
@@ -34,7 +34,7 @@ void fpga_range(Tensor *A, float min, float step){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_range.setArg(0, *(A->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_range.setArg(0, *fpga_kernel_out(A)));
   OCL_CHECK(err, err = kernel_range.setArg(1, min));
   OCL_CHECK(err, err = kernel_range.setArg(2, step));
   OCL_CHECK(err, err = kernel_range.setArg(3, (long int)A->size));
@@ -61,7 +61,7 @@ void fpga_eye(Tensor *A, int offset){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_range.setArg(0, *(A->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_range.setArg(0, *fpga_kernel_out(A)));
   OCL_CHECK(err, err = kernel_range.setArg(1, offset));
   OCL_CHECK(err, err = kernel_range.setArg(2, (long int)A->size));
   OCL_CHECK(err, err = kernel_range.setArg(3, (int)A->shape[0]));
@@ -90,8 +90,8 @@ void fpga_diag(Tensor *A, Tensor *B, int k){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_diag.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_diag.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_diag.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_diag.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_diag.setArg(2, (long int)A->size));
   OCL_CHECK(err, err = kernel_diag.setArg(3, A->shape[0]));
   OCL_CHECK(err, err = kernel_diag.setArg(4, A->shape[1]));
@@ -40,8 +40,8 @@ void fpga_shift(Tensor *A, Tensor *B, vector<int> shift, int mode, float constan
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_shift.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_shift.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_shift.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_shift.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_shift.setArg(2, A->shape[0]));
   OCL_CHECK(err, err = kernel_shift.setArg(3, A->shape[1]));
   OCL_CHECK(err, err = kernel_shift.setArg(4, A->shape[2]));
@@ -281,8 +281,8 @@ void fpga_crop_scale_random(Tensor *A, Tensor *B, vector<float> factor, int mode
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_crop_scale_random.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_crop_scale_random.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_crop_scale_random.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_crop_scale_random.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_crop_scale_random.setArg(2, A->shape[0]));
   OCL_CHECK(err, err = kernel_crop_scale_random.setArg(3, A->shape[2]));
   OCL_CHECK(err, err = kernel_crop_scale_random.setArg(4, A->shape[3]));
@@ -36,8 +36,8 @@ void fpga_abs(Tensor *A, Tensor *B) {
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_abs.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_abs.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_abs.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_abs.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_abs.setArg(2, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_abs, NULL, &event));
@@ -63,8 +63,8 @@ void fpga_acos(Tensor *A, Tensor *B){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_acos.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_acos.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_acos.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_acos.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_acos.setArg(2, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_acos, NULL, &event));
@@ -90,8 +90,8 @@ void fpga_add(Tensor *A, Tensor *B, float v) {
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_add.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_add.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_add.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_add.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_add.setArg(2, v));
   OCL_CHECK(err, err = kernel_add.setArg(3, (long int)A->size));
 
@@ -118,8 +118,8 @@ void fpga_asin(Tensor *A, Tensor *B){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_asin.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_asin.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_asin.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_asin.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_asin.setArg(2, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_asin, NULL, &event));
@@ -145,8 +145,8 @@ void fpga_atan(Tensor *A, Tensor *B){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_atan.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_atan.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_atan.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_atan.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_atan.setArg(2, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_atan, NULL, &event));
@@ -172,8 +172,8 @@ void fpga_ceil(Tensor *A, Tensor *B){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_ceil.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_ceil.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_ceil.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_ceil.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_ceil.setArg(2, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_ceil, NULL, &event));
@@ -199,8 +199,8 @@ void fpga_clamp(Tensor *A, Tensor *B, float min, float max){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_clamp.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_clamp.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_clamp.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_clamp.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_clamp.setArg(2, min));
   OCL_CHECK(err, err = kernel_clamp.setArg(3, max));
   OCL_CHECK(err, err = kernel_clamp.setArg(4, (long int)A->size));
@@ -228,8 +228,8 @@ void fpga_cos(Tensor *A, Tensor *B){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_cos.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_cos.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_cos.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_cos.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_cos.setArg(2, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_cos, NULL, &event));
@@ -255,8 +255,8 @@ void fpga_cosh(Tensor *A, Tensor *B){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_cosh.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_cosh.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_cosh.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_cosh.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_cosh.setArg(2, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_cosh, NULL, &event));
@@ -282,8 +282,8 @@ void fpga_exp(Tensor *A, Tensor *B) {
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_exp.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_exp.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_exp.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_exp.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_exp.setArg(2, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_exp, NULL, &event));
@@ -309,8 +309,8 @@ void fpga_floor(Tensor *A, Tensor *B){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_floor.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_floor.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_floor.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_floor.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_floor.setArg(2, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_floor, NULL, &event));
@@ -336,8 +336,8 @@ void fpga_inv(Tensor *A, Tensor *B, float v){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_inv.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_inv.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_inv.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_inv.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_inv.setArg(2, v));
   OCL_CHECK(err, err = kernel_inv.setArg(3, (long int)A->size));
 
@@ -364,8 +364,8 @@ void fpga_log(Tensor *A, Tensor *B) {
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_log.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_log.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_log.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_log.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_log.setArg(2, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_log, NULL, &event));
@@ -392,7 +392,7 @@ void fpga_log2(Tensor *A, Tensor *B) {
     cl_int err;
     cl::Event event;
 
-    OCL_CHECK(err, err = kernel_log2.setArg(0, *(A->fpga_ptr)));
+    OCL_CHECK(err, err = kernel_log2.setArg(0, *fpga_kernel_out(A)));
     OCL_CHECK(err, err = kernel_log2.setArg(1, (long int)A->size));
 
     OCL_CHECK(err, err = q.enqueueTask(kernel_log2, NULL, &event));
@@ -418,8 +418,8 @@ void fpga_log10(Tensor *A, Tensor *B) {
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_log10.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_log10.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_log10.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_log10.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_log10.setArg(2, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_log10, NULL, &event));
@@ -445,8 +445,8 @@ void fpga_logn(Tensor *A, Tensor *B, float n) {
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_logn.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_logn.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_logn.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_logn.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_logn.setArg(2, n));
   OCL_CHECK(err, err = kernel_logn.setArg(3, (long int)A->size));
 
@@ -473,8 +473,8 @@ void fpga_mod(Tensor *A, Tensor *B, float v){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_mod.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_mod.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_mod.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_mod.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_mod.setArg(2, v));
   OCL_CHECK(err, err = kernel_mod.setArg(3, (long int)A->size));
 
@@ -502,8 +502,8 @@ void fpga_mult(Tensor *A, Tensor *B, float v) {
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_mult.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_mult.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_mult.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_mult.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_mult.setArg(2, v));
   OCL_CHECK(err, err = kernel_mult.setArg(3, (long int)A->size));
 
@@ -530,8 +530,8 @@ void fpga_normalize(Tensor *A, Tensor *B, float min, float max){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_normalize.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_normalize.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_normalize.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_normalize.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_normalize.setArg(2, min));
   OCL_CHECK(err, err = kernel_normalize.setArg(3, max));
   OCL_CHECK(err, err = kernel_normalize.setArg(4, (long int)A->size));
@@ -561,8 +561,8 @@ void fpga_pow(Tensor *A, Tensor *B, float exp) {
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_pow.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_pow.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_pow.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_pow.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_pow.setArg(2, exp));
   OCL_CHECK(err, err = kernel_pow.setArg(3, (long int)A->size));
 
@@ -589,8 +589,8 @@ void fpga_powb(Tensor *A, Tensor *B, float base) {
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_powb.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_powb.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_powb.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_powb.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_powb.setArg(2, base));
   OCL_CHECK(err, err = kernel_powb.setArg(3, (long int)A->size));
 
@@ -619,7 +619,7 @@ void fpga_reciprocal_(Tensor *A) {
     cl_int err;
     cl::Event event;
 
-    OCL_CHECK(err, err = kernel_reciprocal_.setArg(0, *(A->fpga_ptr)));
+    OCL_CHECK(err, err = kernel_reciprocal_.setArg(0, *fpga_kernel_out(A)));
     OCL_CHECK(err, err = kernel_reciprocal_.setArg(1, (long int)A->size));
 
     OCL_CHECK(err, err = q.enqueueTask(kernel_reciprocal_, NULL, &event));
@@ -645,8 +645,8 @@ void fpga_remainder(Tensor *A, Tensor *B, float v) {
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_remainder.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_remainder.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_remainder.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_remainder.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_remainder.setArg(2, v));
   OCL_CHECK(err, err = kernel_remainder.setArg(3, (long int)A->size));
 
@@ -673,8 +673,8 @@ void fpga_round(Tensor *A, Tensor *B){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_round.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_round.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_round.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_round.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_round.setArg(2, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_round, NULL, &event));
@@ -700,8 +700,8 @@ void fpga_rsqrt(Tensor *A, Tensor *B){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_rsqrt.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_rsqrt.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_rsqrt.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_rsqrt.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_rsqrt.setArg(2, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_rsqrt, NULL, &event));
@@ -727,8 +727,8 @@ void fpga_sin(Tensor *A, Tensor *B){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_sin.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_sin.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_sin.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_sin.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_sin.setArg(2, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_sin, NULL, &event));
@@ -754,8 +754,8 @@ void fpga_sinh(Tensor *A, Tensor *B){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_sinh.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_sinh.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_sinh.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_sinh.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_sinh.setArg(2, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_sinh, NULL, &event));
@@ -781,8 +781,8 @@ void fpga_sqr(Tensor *A, Tensor *B) {
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_sqr.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_sqr.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_sqr.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_sqr.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_sqr.setArg(2, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_sqr, NULL, &event));
@@ -808,8 +808,8 @@ void fpga_sqrt(Tensor *A, Tensor *B) {
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_sqrt.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_sqrt.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_sqrt.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_sqrt.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_sqrt.setArg(2, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_sqrt, NULL, &event));
@@ -835,8 +835,8 @@ void fpga_tan(Tensor *A, Tensor *B){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_tan.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_tan.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_tan.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_tan.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_tan.setArg(2, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_tan, NULL, &event));
@@ -862,8 +862,8 @@ void fpga_tanh(Tensor *A, Tensor *B){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_tanh.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_tanh.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_tanh.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_tanh.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_tanh.setArg(2, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_tanh, NULL, &event));
@@ -889,8 +889,8 @@ void fpga_trunc(Tensor *A, Tensor *B){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_trunc.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_trunc.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_trunc.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_trunc.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_trunc.setArg(2, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_trunc, NULL, &event));
@@ -920,10 +920,10 @@ void fpga_add(float scA, Tensor *A, float scB, Tensor *B, Tensor *C, int incC) {
     cl::Event event;
 
     OCL_CHECK(err, err = kernel_add.setArg(0, scA));
-    OCL_CHECK(err, err = kernel_add.setArg(1, *(A->fpga_ptr)));
+    OCL_CHECK(err, err = kernel_add.setArg(1, *fpga_kernel_in(A)));
     OCL_CHECK(err, err = kernel_add.setArg(2, scB));
-    OCL_CHECK(err, err = kernel_add.setArg(3, *(B->fpga_ptr)));
-    OCL_CHECK(err, err = kernel_add.setArg(4, *(C->fpga_ptr)));
+    OCL_CHECK(err, err = kernel_add.setArg(3, *fpga_kernel_in(B)));
+    OCL_CHECK(err, err = kernel_add.setArg(4, *fpga_kernel_out(C)));
     OCL_CHECK(err, err = kernel_add.setArg(5, incC));
     OCL_CHECK(err, err = kernel_add.setArg(6, (long int)A->size));
 
@@ -951,8 +951,8 @@ void fpga_inc(Tensor *A, Tensor *B) {
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_inc.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_inc.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_inc.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_inc.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_inc.setArg(2, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_inc, NULL, &event));
@@ -983,9 +983,9 @@ void fpga_mult2D(Tensor *A, int tA, Tensor *B, int tB, Tensor *C, int incC) {
     cl_int err;
     cl::Event event;
 
-    OCL_CHECK(err, err = kernel_mult2d.setArg(0, *(A->fpga_ptr)));
-    OCL_CHECK(err, err = kernel_mult2d.setArg(1, *(B->fpga_ptr)));
-    OCL_CHECK(err, err = kernel_mult2d.setArg(2, *(C->fpga_ptr)));
+    OCL_CHECK(err, err = kernel_mult2d.setArg(0, *fpga_kernel_in(A)));
+    OCL_CHECK(err, err = kernel_mult2d.setArg(1, *fpga_kernel_in(B)));
+    OCL_CHECK(err, err = kernel_mult2d.setArg(2, *fpga_kernel_out(C)));
     OCL_CHECK(err, err = kernel_mult2d.setArg(3, (int)A->shape[0]));
     OCL_CHECK(err, err = kernel_mult2d.setArg(4, (int)A->shape[1]));
     OCL_CHECK(err, err = kernel_mult2d.setArg(5, (int)B->shape[0]));
@@ -1022,9 +1022,9 @@ void fpga_el_div(Tensor *A, Tensor *B, Tensor *C, int incC) {
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_el_div.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_el_div.setArg(1, *(B->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_el_div.setArg(2, *(C->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_el_div.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_el_div.setArg(1, *fpga_kernel_in(B)));
+  OCL_CHECK(err, err = kernel_el_div.setArg(2, *fpga_kernel_out(C)));
   OCL_CHECK(err, err = kernel_el_div.setArg(3, incC));
   OCL_CHECK(err, err = kernel_el_div.setArg(4, (long int)A->size));
 
@@ -1055,9 +1055,9 @@ void fpga_el_mult(Tensor *A, Tensor *B, Tensor *C, int incC) {
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_el_mult.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_el_mult.setArg(1, *(B->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_el_mult.setArg(2, *(C->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_el_mult.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_el_mult.setArg(1, *fpga_kernel_in(B)));
+  OCL_CHECK(err, err = kernel_el_mult.setArg(2, *fpga_kernel_out(C)));
   OCL_CHECK(err, err = kernel_el_mult.setArg(3, incC));
   OCL_CHECK(err, err = kernel_el_mult.setArg(4, (long int)A->size));
 
@@ -1084,8 +1084,8 @@ void fpga_sign(Tensor *A, Tensor *B, float zero_sign){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_sign2.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_sign2.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_sign2.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_sign2.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_sign2.setArg(2, zero_sign));
   OCL_CHECK(err, err = kernel_sign2.setArg(3, (long int)A->size));
 
@@ -1114,9 +1114,9 @@ void fpga_sum2D_rowwise(Tensor *A, Tensor *B, Tensor *C) {
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_sum2D_rowwise.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_sum2D_rowwise.setArg(1, *(B->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_sum2D_rowwise.setArg(2, *(C->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_sum2D_rowwise.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_sum2D_rowwise.setArg(1, *fpga_kernel_in(B)));
+  OCL_CHECK(err, err = kernel_sum2D_rowwise.setArg(2, *fpga_kernel_out(C)));
   OCL_CHECK(err, err = kernel_sum2D_rowwise.setArg(3, A->shape[0]));
   OCL_CHECK(err, err = kernel_sum2D_rowwise.setArg(4, A->shape[1]));
 
@@ -1144,9 +1144,9 @@ void fpga_sum2D_colwise(Tensor *A, Tensor *B, Tensor *C) {
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_sum2D_colwise.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_sum2D_colwise.setArg(1, *(B->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_sum2D_colwise.setArg(2, *(C->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_sum2D_colwise.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_sum2D_colwise.setArg(1, *fpga_kernel_in(B)));
+  OCL_CHECK(err, err = kernel_sum2D_colwise.setArg(2, *fpga_kernel_out(C)));
   OCL_CHECK(err, err = kernel_sum2D_colwise.setArg(3, A->shape[0]));
   OCL_CHECK(err, err = kernel_sum2D_colwise.setArg(4, A->shape[1]));
 
@@ -1178,7 +1178,7 @@ float fpga_max(Tensor *A){
   cl_int err;
   cl::Event event;
   
-  OCL_CHECK(err, err = kernel_max.setArg(0, *(A->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_max.setArg(0, *fpga_kernel_in(A)));
   OCL_CHECK(err, err = kernel_max.setArg(1, (long int)A->size));
   // Jorge, añade parametro de return 
   OCL_CHECK(err, err = q.enqueueTask(kernel_max, NULL, &event));
@@ -1208,8 +1208,8 @@ void fpga_max(Tensor *A, Tensor *B, ReduceDescriptor2 *rd){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_max_2.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_max_2.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_max_2.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_max_2.setArg(1, *fpga_kernel_out(B)));
   // añadir mas parametros
   printf("fpga_max not implemented yet\n"); exit(1);
   OCL_CHECK(err, err = q.enqueueTask(kernel_max_2, NULL, &event));
@@ -1237,7 +1237,7 @@ int fpga_argmax(Tensor *A){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_argmax.setArg(0, *(A->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_argmax.setArg(0, *fpga_kernel_in(A)));
   OCL_CHECK(err, err = kernel_argmax.setArg(1, (long int)A->size));
   // Jorge, añade parametro de return 
   OCL_CHECK(err, err = q.enqueueTask(kernel_argmax, NULL, &event));
@@ -1266,8 +1266,8 @@ void fpga_argmax(Tensor *A, Tensor *B, ReduceDescriptor2 *rd){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_argmax_2.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_argmax_2.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_argmax_2.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_argmax_2.setArg(1, *fpga_kernel_out(B)));
   // añadir mas parametros
   printf("fpga_max not implemented yet\n"); exit(1);
   OCL_CHECK(err, err = q.enqueueTask(kernel_argmax_2, NULL, &event));
@@ -1295,7 +1295,7 @@ float fpga_min(Tensor *A){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_min.setArg(0, *(A->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_min.setArg(0, *fpga_kernel_in(A)));
   OCL_CHECK(err, err = kernel_min.setArg(1, (long int)A->size));
   // Jorge, añade parametro de return
   OCL_CHECK(err, err = q.enqueueTask(kernel_min, NULL, &event));
@@ -1325,8 +1325,8 @@ void fpga_min(Tensor *A, Tensor *B, ReduceDescriptor2 *rd){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_min_2.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_min_2.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_min_2.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_min_2.setArg(1, *fpga_kernel_out(B)));
   // añadir mas parametros
   printf("fpga_min not implemented yet\n"); exit(1);
   OCL_CHECK(err, err = q.enqueueTask(kernel_min_2, NULL, &event));
@@ -1355,7 +1355,7 @@ int fpga_argmin(Tensor *A){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_argmin.setArg(0, *(A->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_argmin.setArg(0, *fpga_kernel_in(A)));
   OCL_CHECK(err, err = kernel_argmin.setArg(1, (long int)A->size));
   // Jorge, añade parametro de return
   OCL_CHECK(err, err = q.enqueueTask(kernel_argmin, NULL, &event));
@@ -1384,8 +1384,8 @@ void fpga_argmin(Tensor *A, Tensor *B, ReduceDescriptor2 *rd){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_argmin_2.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_argmin_2.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_argmin_2.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_argmin_2.setArg(1, *fpga_kernel_out(B)));
   // añadir mas parametros
   printf("fpga_min not implemented yet\n"); exit(1);
   OCL_CHECK(err, err = q.enqueueTask(kernel_argmin_2, NULL, &event));
@@ -1413,7 +1413,7 @@ float fpga_sum(Tensor *A) {
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_sum.setArg(0, *(A->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_sum.setArg(0, *fpga_kernel_in(A)));
   OCL_CHECK(err, err = kernel_sum.setArg(1, A->size));
   printf("Error, fpga_sum not properly implemented yet\n");
   exit(1);
@@ -27,23 +27,22 @@ char fpga_set_cpuemu_reduction_back  = 1;
 // -----------------------------------------------------------------
 // reduce
 //
-void fpga_cpuemu_reduce(Tensor *A, Tensor *B, string mode, int* map) {
-  // TODO: map should be mapped to FPGA
+void fpga_cpuemu_reduce(Tensor *A, Tensor *B, int mode, const vector<int> &axis) {
   fpga_copy_from_fpga(A, A->ptr);
-  cpu_reduce(A, B, mode, map);
+  cpu_reduce(A, B, axis, mode);
   fpga_copy_to_fpga(B->ptr, B);
 }
 
-void fpga_reduce(Tensor *A, Tensor *B, string mode, int *map){
+void fpga_reduce(Tensor *A, Tensor *B, int mode, const vector<int> &axis){
   _profile_fpga(_FPGA_REDUCE, 0);
 #ifndef K_ENABLED_REDUCE
-  fpga_cpuemu_reduce(A, B, mode, map);
+  fpga_cpuemu_reduce(A, B, mode, axis);
 #else
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_reduce.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_reduce.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_reduce.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_reduce.setArg(1, *fpga_kernel_out(B)));
   // OCL_CHECK(err, err = kernel_reduce.setArg(2, (int)mode));
   printf("Error, mode parameter not passed\n"); exit(1);
   // OCL_CHECK(err, err = kernel_reduce.setArg(3, (int)map));
@@ -55,38 +54,30 @@ void fpga_reduce(Tensor *A, Tensor *B, string mode, int *map){
   _profile_fpga(_FPGA_REDUCE, 1);
 }
 
-// -----------------------------------------------------------------
-// reduce
-//
-void fpga_reduce(Tensor *A, Tensor *B, string mode, MapReduceDescriptor *MD)
-{
-    fpga_reduce(A,B,mode,MD->ind);
-}
-
 // -----------------------------------------------------------------
 // reduce_op
 //
-void fpga_cpuemu_reduce_op(Tensor *A, Tensor *B, string op, int *map) {
+void fpga_cpuemu_reduce_op(Tensor *A, Tensor *B, int op, const vector<int> &axis) {
   int Asize = A->size * sizeof(float);
   int Bsize = B->size * sizeof(float);
   if (A->ptr == NULL) A->ptr = (float *)malloc(Asize);
   if (B->ptr == NULL) B->ptr = (float *)malloc(Bsize);
   fpga_copy_from_fpga(A, A->ptr);
-  cpu_reduce_op(A, B, op, map);
+  cpu_reduce_op(A, B, axis, op);
   fpga_copy_to_fpga(B->ptr, B);
 }
 
-void fpga_reduce_op(Tensor *A, Tensor *B, string op, int *map)
+void fpga_reduce_op(Tensor *A, Tensor *B, int op, const vector<int> &axis)
 {
   _profile_fpga(_FPGA_REDUCE_OP, 0);
   if (fpga_set_cpuemu_reduce_op == 1) {
-      fpga_cpuemu_reduce_op(A, B, op, map);
+      fpga_cpuemu_reduce_op(A, B, op, axis);
   } else {
       cl_int err;
       cl::Event event;
 
-      OCL_CHECK(err, err = kernel_reduce_op.setArg(0, *(A->fpga_ptr)));
-      OCL_CHECK(err, err = kernel_reduce_op.setArg(1, *(B->fpga_ptr)));
+      OCL_CHECK(err, err = kernel_reduce_op.setArg(0, *fpga_kernel_in(A)));
+      OCL_CHECK(err, err = kernel_reduce_op.setArg(1, *fpga_kernel_out(B)));
       //OCL_CHECK(err, err = kernel_reduce_op.setArg(2, (int)op));
       //OCL_CHECK(err, err = kernel_reduce_op.setArg(3, (int)map));
       printf("Error, parameters not passed\n"); exit(1);
@@ -97,14 +88,6 @@ void fpga_reduce_op(Tensor *A, Tensor *B, string op, int *map)
   _profile_fpga(_FPGA_REDUCE_OP, 1);
 }
 
-// -----------------------------------------------------------------
-// reduce_op
-//
-void fpga_reduce_op(Tensor *A, Tensor *B, string op, MapReduceDescriptor *MD)
-{
-  fpga_reduce_op(A,B,op,MD->ind);
-}
-
 // -----------------------------------------------------------------
 // reduce_sum2D
 //
@@ -126,8 +109,8 @@ void fpga_reduce_sum2D(Tensor *A, Tensor *B, int axis, int incB) {
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_reduce_sum2D.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_reduce_sum2D.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_reduce_sum2D.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_reduce_sum2D.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_reduce_sum2D.setArg(2, A->shape[0]));
   OCL_CHECK(err, err = kernel_reduce_sum2D.setArg(3, A->shape[1]));
   OCL_CHECK(err, err = kernel_reduce_sum2D.setArg(4, axis));
@@ -143,7 +126,6 @@ void fpga_reduce_sum2D(Tensor *A, Tensor *B, int axis, int incB) {
 // reduction
 //
 void fpga_cpuemu_reduction(ReduceDescriptor *RD) {
-  // TODO: index should be mapped on FPGA (for the moment is at CPU)
   fpga_copy_from_fpga(RD->I, RD->I->ptr);
   cpu_reduction(RD);
   fpga_copy_to_fpga(RD->O->ptr, RD->O);
@@ -173,10 +155,9 @@ void fpga_reduction(ReduceDescriptor *RD){
 // reduction_back
 //
 void fpga_cpuemu_reduction_back(ReduceDescriptor *RD) {
-  // input data: tensor RD->S, tensor RD->D, and index vector
+  // input data: tensor RD->S, tensor RD->D
   if (RD->S != nullptr) fpga_copy_from_fpga(RD->S, RD->S->ptr);
   fpga_copy_from_fpga(RD->D, RD->D->ptr);
-  // TODO: For the moment index vector is on CPU always
   cpu_reduction_back(RD);
   // output data: tensor RD->ID
   fpga_copy_to_fpga(RD->ID->ptr, RD->ID);
@@ -35,8 +35,8 @@ void fpga_relu(Tensor *A, Tensor *B){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_relu.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_relu.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_relu.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_relu.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_relu.setArg(2, A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_relu, NULL, &event));
@@ -65,9 +65,9 @@ void fpga_d_relu(Tensor *D, Tensor *I, Tensor *PD){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_d_relu.setArg(0, *(D->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_d_relu.setArg(1, *(I->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_d_relu.setArg(2, *(PD->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_d_relu.setArg(0, *fpga_kernel_in(D)));
+  OCL_CHECK(err, err = kernel_d_relu.setArg(1, *fpga_kernel_in(I)));
+  OCL_CHECK(err, err = kernel_d_relu.setArg(2, *fpga_kernel_out(PD)));
   OCL_CHECK(err, err = kernel_d_relu.setArg(3, (long int)D->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_d_relu, NULL, &event));
@@ -93,8 +93,8 @@ void fpga_thresholded_relu(Tensor *A, Tensor *B, float param){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_thresholded_relu.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_thresholded_relu.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_thresholded_relu.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_thresholded_relu.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_thresholded_relu.setArg(2, (long int)A->size));
   OCL_CHECK(err, err = kernel_thresholded_relu.setArg(3, param));
 
@@ -122,9 +122,9 @@ void fpga_d_thresholded_relu(Tensor *D, Tensor *I, Tensor *PD, float param){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_d_thresholded_relu.setArg(0, *(D->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_d_thresholded_relu.setArg(1, *(I->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_d_thresholded_relu.setArg(2, *(PD->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_d_thresholded_relu.setArg(0, *fpga_kernel_in(D)));
+  OCL_CHECK(err, err = kernel_d_thresholded_relu.setArg(1, *fpga_kernel_in(I)));
+  OCL_CHECK(err, err = kernel_d_thresholded_relu.setArg(2, *fpga_kernel_out(PD)));
   OCL_CHECK(err, err = kernel_d_thresholded_relu.setArg(3, (long int)D->size));
   OCL_CHECK(err, err = kernel_d_thresholded_relu.setArg(4, param));
 
@@ -151,8 +151,8 @@ void fpga_leaky_relu(Tensor *A, Tensor *B, float param){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_leaky_relu.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_leaky_relu.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_leaky_relu.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_leaky_relu.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_leaky_relu.setArg(2, (long int)A->size));
   OCL_CHECK(err, err = kernel_leaky_relu.setArg(4, param));
 
@@ -180,9 +180,9 @@ void fpga_d_leaky_relu(Tensor *D, Tensor *I, Tensor *PD, float param){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_d_leaky_relu.setArg(0, *(D->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_d_leaky_relu.setArg(1, *(I->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_d_leaky_relu.setArg(2, *(PD->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_d_leaky_relu.setArg(0, *fpga_kernel_in(D)));
+  OCL_CHECK(err, err = kernel_d_leaky_relu.setArg(1, *fpga_kernel_in(I)));
+  OCL_CHECK(err, err = kernel_d_leaky_relu.setArg(2, *fpga_kernel_out(PD)));
   OCL_CHECK(err, err = kernel_d_leaky_relu.setArg(3, (long int)D->size));
   OCL_CHECK(err, err = kernel_d_leaky_relu.setArg(4, param));
 
@@ -209,8 +209,8 @@ void fpga_elu(Tensor *A, Tensor *B, float param){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_elu.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_elu.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_elu.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_elu.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_elu.setArg(3, (long int)A->size));
   OCL_CHECK(err, err = kernel_elu.setArg(4, param));
 
@@ -238,9 +238,9 @@ void fpga_d_elu(Tensor *D, Tensor *I, Tensor *PD, float param){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_d_elu.setArg(0, *(D->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_d_elu.setArg(1, *(I->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_d_elu.setArg(2, *(PD->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_d_elu.setArg(0, *fpga_kernel_in(D)));
+  OCL_CHECK(err, err = kernel_d_elu.setArg(1, *fpga_kernel_in(I)));
+  OCL_CHECK(err, err = kernel_d_elu.setArg(2, *fpga_kernel_out(PD)));
   OCL_CHECK(err, err = kernel_d_elu.setArg(3, (long int)D->size));
   OCL_CHECK(err, err = kernel_d_elu.setArg(4, param));
 
@@ -267,8 +267,8 @@ void fpga_softplus(Tensor *A, Tensor *B){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_softplus.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_softplus.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_softplus.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_softplus.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_softplus.setArg(2, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_softplus, NULL, &event));
@@ -295,10 +295,10 @@ void fpga_d_softplus(Tensor *D, Tensor *I, Tensor *PD){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_d_softplus.setArg(0, *(D->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_d_softplus.setArg(1, *(I->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_d_softplus.setArg(0, *fpga_kernel_in(D)));
+  OCL_CHECK(err, err = kernel_d_softplus.setArg(1, *fpga_kernel_in(I)));
   OCL_CHECK(err, err = kernel_d_softplus.setArg(2, (long int)D->size));
-  OCL_CHECK(err, err = kernel_d_softplus.setArg(3, *(PD->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_d_softplus.setArg(3, *fpga_kernel_out(PD)));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_d_softplus, NULL, &event));
   q.finish();
@@ -323,8 +323,8 @@ void fpga_softsign(Tensor *A, Tensor *B){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_softsign.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_softsign.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_softsign.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_softsign.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_softsign.setArg(2, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_softsign, NULL, &event));
@@ -351,9 +351,9 @@ void fpga_d_softsign(Tensor *D, Tensor *I, Tensor *PD){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_d_softsign.setArg(0, *(D->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_d_softsign.setArg(1, *(I->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_d_softsign.setArg(2, *(PD->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_d_softsign.setArg(0, *fpga_kernel_in(D)));
+  OCL_CHECK(err, err = kernel_d_softsign.setArg(1, *fpga_kernel_in(I)));
+  OCL_CHECK(err, err = kernel_d_softsign.setArg(2, *fpga_kernel_out(PD)));
   OCL_CHECK(err, err = kernel_d_softsign.setArg(3, (long int)D->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_d_softsign, NULL, &event));
@@ -379,8 +379,8 @@ void fpga_linear(Tensor *A, Tensor *B, float param){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_linear.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_linear.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_linear.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_linear.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_linear.setArg(2, param));
   OCL_CHECK(err, err = kernel_linear.setArg(3, (long int)A->size));
 
@@ -408,9 +408,9 @@ void fpga_d_linear(Tensor *D, Tensor *I, Tensor *PD, float param){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_d_linear.setArg(0, *(D->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_d_linear.setArg(1, *(I->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_d_linear.setArg(2, *(PD->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_d_linear.setArg(0, *fpga_kernel_in(D)));
+  OCL_CHECK(err, err = kernel_d_linear.setArg(1, *fpga_kernel_in(I)));
+  OCL_CHECK(err, err = kernel_d_linear.setArg(2, *fpga_kernel_out(PD)));
   OCL_CHECK(err, err = kernel_d_linear.setArg(3, param));
   OCL_CHECK(err, err = kernel_d_linear.setArg(4, (long int)D->size));
 
@@ -437,8 +437,8 @@ void fpga_sigmoid(Tensor *A, Tensor *B){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_sigmoid.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_sigmoid.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_sigmoid.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_sigmoid.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_sigmoid.setArg(2, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_sigmoid, NULL, &event));
@@ -465,9 +465,9 @@ void fpga_d_sigmoid(Tensor *D, Tensor *I, Tensor *PD){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_d_sigmoid.setArg(0, *(D->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_d_sigmoid.setArg(1, *(I->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_d_sigmoid.setArg(2, *(PD->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_d_sigmoid.setArg(0, *fpga_kernel_in(D)));
+  OCL_CHECK(err, err = kernel_d_sigmoid.setArg(1, *fpga_kernel_in(I)));
+  OCL_CHECK(err, err = kernel_d_sigmoid.setArg(2, *fpga_kernel_out(PD)));
   OCL_CHECK(err, err = kernel_d_sigmoid.setArg(3, (long int)D->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_d_sigmoid, NULL, &event));
@@ -493,8 +493,8 @@ void fpga_hard_sigmoid(Tensor *A, Tensor *B){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_hard_sigmoid.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_hard_sigmoid.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_hard_sigmoid.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_hard_sigmoid.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_hard_sigmoid.setArg(2, (long int)A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_hard_sigmoid, NULL, &event));
@@ -521,9 +521,9 @@ void fpga_d_hard_sigmoid(Tensor *D, Tensor *I, Tensor *PD){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_d_hard_sigmoid.setArg(0, *(D->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_d_hard_sigmoid.setArg(1, *(I->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_d_hard_sigmoid.setArg(2, *(PD->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_d_hard_sigmoid.setArg(0, *fpga_kernel_in(D)));
+  OCL_CHECK(err, err = kernel_d_hard_sigmoid.setArg(1, *fpga_kernel_in(I)));
+  OCL_CHECK(err, err = kernel_d_hard_sigmoid.setArg(2, *fpga_kernel_out(PD)));
   OCL_CHECK(err, err = kernel_d_hard_sigmoid.setArg(3, (long int)D->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_d_hard_sigmoid, NULL, &event));
@@ -550,9 +550,9 @@ void fpga_d_exp(Tensor *D, Tensor *I, Tensor *PD){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_d_exp.setArg(0, *(D->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_d_exp.setArg(1, *(I->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_d_exp.setArg(2, *(PD->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_d_exp.setArg(0, *fpga_kernel_in(D)));
+  OCL_CHECK(err, err = kernel_d_exp.setArg(1, *fpga_kernel_in(I)));
+  OCL_CHECK(err, err = kernel_d_exp.setArg(2, *fpga_kernel_out(PD)));
   OCL_CHECK(err, err = kernel_d_exp.setArg(3, (long int)D->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_d_exp, NULL, &event));
@@ -579,9 +579,9 @@ void fpga_d_tanh(Tensor *D, Tensor *I, Tensor *PD){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_d_tanh.setArg(0, *(D->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_d_tanh.setArg(1, *(I->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_d_tanh.setArg(2, *(PD->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_d_tanh.setArg(0, *fpga_kernel_in(D)));
+  OCL_CHECK(err, err = kernel_d_tanh.setArg(1, *fpga_kernel_in(I)));
+  OCL_CHECK(err, err = kernel_d_tanh.setArg(2, *fpga_kernel_out(PD)));
   OCL_CHECK(err, err = kernel_d_tanh.setArg(3, (long int)D->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_d_tanh, NULL, &event));
@@ -609,8 +609,8 @@ void fpga_softmax(Tensor *A, Tensor *B) {
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_softmax.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_softmax.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_softmax.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_softmax.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_softmax.setArg(2, (int)A->shape[0]));
   OCL_CHECK(err, err = kernel_softmax.setArg(3, (int)A->shape[1]));
   OCL_CHECK(err, err = kernel_softmax.setArg(4, (int)B->shape[1]));
@@ -640,9 +640,9 @@ void fpga_d_softmax(Tensor *D, Tensor *I, Tensor *PD) {
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_d_softmax.setArg(0, *(D->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_d_softmax.setArg(1, *(I->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_d_softmax.setArg(2, *(PD->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_d_softmax.setArg(0, *fpga_kernel_in(D)));
+  OCL_CHECK(err, err = kernel_d_softmax.setArg(1, *fpga_kernel_in(I)));
+  OCL_CHECK(err, err = kernel_d_softmax.setArg(2, *fpga_kernel_out(PD)));
   OCL_CHECK(err, err = kernel_d_softmax.setArg(3, (long int)D->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_d_softmax, NULL, &event));
@@ -48,16 +48,16 @@ void fpga_conv2D(ConvolDescriptor *D)
 
   // conv2D parameters
   int batch_size   = D->I->shape[0];     // batch size
-  cl::Buffer I     = *D->I->fpga_ptr;    // input activations
+  cl::Buffer I     = *fpga_kernel_in(D->I);    // input activations
   int Irows        = D->I->shape[2];     // rows of input image
   int Icols        = D->I->shape[3];     // cols of input image
   int Ichannels    = D->I->shape[1];     // input channels
-  cl::Buffer K     = *D->K->fpga_ptr;    // kernel
+  cl::Buffer K     = *fpga_kernel_in(D->K);    // kernel
   int Krows        = D->kr;              // kernel rows
   int Kcols        = D->kc;              // kernel cols
-  cl::Buffer B     = *D->bias->fpga_ptr; // bias
+  cl::Buffer B     = *fpga_kernel_in(D->bias); // bias
   int use_bias     = D->use_bias;        // whether use bias or not
-  cl::Buffer O     = *D->O->fpga_ptr;    // output activations
+  cl::Buffer O     = *fpga_kernel_out(D->O);    // output activations
   int Orows        = D->O->shape[2];     // rows of output images
   int Ocols        = D->O->shape[3];     // cols of output images
   int Ochannels    = D->O->shape[1];     // output channels
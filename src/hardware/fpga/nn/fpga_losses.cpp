@@ -38,9 +38,9 @@ void fpga_cent(Tensor *A, Tensor *B, Tensor *C){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_cent.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_cent.setArg(1, *(B->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_cent.setArg(2, *(C->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_cent.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_cent.setArg(1, *fpga_kernel_in(B)));
+  OCL_CHECK(err, err = kernel_cent.setArg(2, *fpga_kernel_out(C)));
   OCL_CHECK(err, err = kernel_cent.setArg(3, A->size));
 
   OCL_CHECK(err, err = q.enqueueTask(kernel_cent, NULL, &event));
@@ -46,8 +46,8 @@ int fpga_accuracy(Tensor *A, Tensor *B){
    posix_memalign((void **)&accu,4096,sizeof(int));
    OCL_CHECK(err, cl::Buffer buffer_acc(context, CL_MEM_USE_HOST_PTR | CL_MEM_WRITE_ONLY, sizeof(int) ,accu, &err));
 
-   OCL_CHECK(err, err = kernel_accuracy.setArg(0, *(A->fpga_ptr)));
-   OCL_CHECK(err, err = kernel_accuracy.setArg(1, *(B->fpga_ptr)));
+   OCL_CHECK(err, err = kernel_accuracy.setArg(0, *fpga_kernel_in(A)));
+   OCL_CHECK(err, err = kernel_accuracy.setArg(1, *fpga_kernel_in(B)));
    OCL_CHECK(err, err = kernel_accuracy.setArg(2, A->shape[0]));
    OCL_CHECK(err, err = kernel_accuracy.setArg(3, A->shape[1]));
    OCL_CHECK(err, err = kernel_accuracy.setArg(4, buffer_acc));
@@ -87,8 +87,8 @@ int fpga_bin_accuracy(Tensor *A, Tensor *B){
    posix_memalign((void **)&accu,4096,sizeof(int));
    OCL_CHECK(err, cl::Buffer buffer_acc(context, CL_MEM_USE_HOST_PTR | CL_MEM_WRITE_ONLY, sizeof(int) ,accu, &err));
 
-   OCL_CHECK(err, err = kernel_bin_accuracy.setArg(0, *(A->fpga_ptr)));
-   OCL_CHECK(err, err = kernel_bin_accuracy.setArg(1, *(B->fpga_ptr)));
+   OCL_CHECK(err, err = kernel_bin_accuracy.setArg(0, *fpga_kernel_in(A)));
+   OCL_CHECK(err, err = kernel_bin_accuracy.setArg(1, *fpga_kernel_in(B)));
    OCL_CHECK(err, err = kernel_bin_accuracy.setArg(2, A->shape[0]));
    OCL_CHECK(err, err = kernel_bin_accuracy.setArg(3, A->shape[1]));
    OCL_CHECK(err, err = kernel_bin_accuracy.setArg(4, buffer_acc));
@@ -0,0 +1,66 @@
+/*
+* FPGA support for EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.6
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), GAP research group
+* Date: June 2020
+* Author: GAP Research Group (UPV), contact: carlherlu@gap.upv.es, jflich@disca.upv.es
+* All rights reserved
+*/
+
+#ifdef cFPGA
+
+#include <cstdio>      /* printf, scanf, NULL */
+#include <cstdlib>     /* malloc, free, rand */
+#include <iostream>
+
+#include "eddl/hardware/fpga/nn/fpga_nn.h"
+#include "eddl/hardware/cpu/nn/cpu_tensor_nn.h"
+#include "eddl/hardware/fpga/fpga_hw.h"
+
+// There are no optimizer kernels on the FPGA yet: the updates run on the cpu
+
+// -----------------------------------------------------------------
+// sgd_update
+//
+void fpga_sgd_update(Tensor *P, Tensor *G, Tensor *M, float lr, float mu, float weight_decay, bool nesterov){
+  _profile_fpga(_FPGA_SGD_UPDATE, 0);
+  fpga_copy_from_fpga(P, P->ptr);
+  fpga_copy_from_fpga(G, G->ptr);
+  fpga_copy_from_fpga(M, M->ptr);
+  cpu_sgd_update(P, G, M, lr, mu, weight_decay, nesterov);
+  fpga_copy_to_fpga(P->ptr, P);
+  fpga_copy_to_fpga(M->ptr, M);
+  _profile_fpga(_FPGA_SGD_UPDATE, 1);
+}
+
+// -----------------------------------------------------------------
+// adam_update
+//
+void fpga_adam_update(Tensor *P, Tensor *G, Tensor *M, Tensor *V, float step, float beta_1, float beta_2, float inv_bc2, float epsilon, float weight_decay){
+  _profile_fpga(_FPGA_ADAM_UPDATE, 0);
+  fpga_copy_from_fpga(P, P->ptr);
+  fpga_copy_from_fpga(G, G->ptr);
+  fpga_copy_from_fpga(M, M->ptr);
+  fpga_copy_from_fpga(V, V->ptr);
+  cpu_adam_update(P, G, M, V, step, beta_1, beta_2, inv_bc2, epsilon, weight_decay);
+  fpga_copy_to_fpga(P->ptr, P);
+  fpga_copy_to_fpga(M->ptr, M);
+  fpga_copy_to_fpga(V->ptr, V);
+  _profile_fpga(_FPGA_ADAM_UPDATE, 1);
+}
+
+// -----------------------------------------------------------------
+// rmsprop_update
+//
+void fpga_rmsprop_update(Tensor *P, Tensor *G, Tensor *G1, float lr, float rho, float epsilon, float weight_decay){
+  _profile_fpga(_FPGA_RMSPROP_UPDATE, 0);
+  fpga_copy_from_fpga(P, P->ptr);
+  fpga_copy_from_fpga(G, G->ptr);
+  fpga_copy_from_fpga(G1, G1->ptr);
+  cpu_rmsprop_update(P, G, G1, lr, rho, epsilon, weight_decay);
+  fpga_copy_to_fpga(P->ptr, P);
+  fpga_copy_to_fpga(G1->ptr, G1);
+  _profile_fpga(_FPGA_RMSPROP_UPDATE, 1);
+}
+
+#endif
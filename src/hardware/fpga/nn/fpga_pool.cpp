@@ -57,10 +57,10 @@ void fpga_mpool2D(PoolDescriptor *D){
         OCL_CHECK(err, err = kernel_mpool2D.setArg(10, (int)D->sc));
         OCL_CHECK(err, err = kernel_mpool2D.setArg(11, (long int)D->size));
         OCL_CHECK(err, err = kernel_mpool2D.setArg(12, (int)D->I->shape[0]));
-        OCL_CHECK(err, err = kernel_mpool2D.setArg(13, *(D->I->fpga_ptr)));
-        OCL_CHECK(err, err = kernel_mpool2D.setArg(14, *(D->O->fpga_ptr)));
-        OCL_CHECK(err, err = kernel_mpool2D.setArg(15, *(D->indX->fpga_ptr)));
-        OCL_CHECK(err, err = kernel_mpool2D.setArg(16, *(D->indY->fpga_ptr)));
+        OCL_CHECK(err, err = kernel_mpool2D.setArg(13, *fpga_kernel_in(D->I)));
+        OCL_CHECK(err, err = kernel_mpool2D.setArg(14, *fpga_kernel_out(D->O)));
+        OCL_CHECK(err, err = kernel_mpool2D.setArg(15, *fpga_kernel_out(D->indX)));
+        OCL_CHECK(err, err = kernel_mpool2D.setArg(16, *fpga_kernel_out(D->indY)));
 
         OCL_CHECK(err, err = q.enqueueTask(kernel_mpool2D, NULL, &event));
         q.finish();
@@ -99,10 +99,10 @@ void fpga_mpool2D_back(PoolDescriptor *D){
       OCL_CHECK(err, err = kernel_mpool2D_back.setArg(10, (int)D->sc));
       OCL_CHECK(err, err = kernel_mpool2D_back.setArg(11, (long int)D->size));
       OCL_CHECK(err, err = kernel_mpool2D_back.setArg(12, (int)D->I->shape[0]));
-      OCL_CHECK(err, err = kernel_mpool2D_back.setArg(13, *(D->I->fpga_ptr)));
-      OCL_CHECK(err, err = kernel_mpool2D_back.setArg(14, *(D->O->fpga_ptr)));
-      OCL_CHECK(err, err = kernel_mpool2D_back.setArg(15, *(D->indX->fpga_ptr)));
-      OCL_CHECK(err, err = kernel_mpool2D_back.setArg(16, *(D->indY->fpga_ptr)));
+      OCL_CHECK(err, err = kernel_mpool2D_back.setArg(13, *fpga_kernel_out(D->I)));
+      OCL_CHECK(err, err = kernel_mpool2D_back.setArg(14, *fpga_kernel_out(D->O)));
+      OCL_CHECK(err, err = kernel_mpool2D_back.setArg(15, *fpga_kernel_in(D->indX)));
+      OCL_CHECK(err, err = kernel_mpool2D_back.setArg(16, *fpga_kernel_in(D->indY)));
 
       OCL_CHECK(err, err = q.enqueueTask(kernel_mpool2D, NULL, &event));
       q.finish();
@@ -36,8 +36,8 @@ void fpga_repeat_nn(Tensor *A, Tensor *B, vector<int> size){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_repeat_nn.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_repeat_nn.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_repeat_nn.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_repeat_nn.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_repeat_nn.setArg(2, B->shape[3]));
   OCL_CHECK(err, err = kernel_repeat_nn.setArg(3, B->size));
   OCL_CHECK(err, err = kernel_repeat_nn.setArg(4, size[0]));
@@ -67,8 +67,8 @@ void fpga_d_repeat_nn(Tensor *D, Tensor *A, vector<int> size){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_d_repeat_nn.setArg(0, *(D->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_d_repeat_nn.setArg(1, *(A->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_d_repeat_nn.setArg(0, *fpga_kernel_in(D)));
+  OCL_CHECK(err, err = kernel_d_repeat_nn.setArg(1, *fpga_kernel_out(A)));
   OCL_CHECK(err, err = kernel_d_repeat_nn.setArg(2, D->shape[3]));
   OCL_CHECK(err, err = kernel_d_repeat_nn.setArg(3, D->size));
   OCL_CHECK(err, err = kernel_d_repeat_nn.setArg(4, size[0]));
@@ -98,8 +98,8 @@ void fpga_select_nn(Tensor *A, Tensor *B, SelDescriptor *sd){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_select_nn.setArg(0, *A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_select_nn.setArg(1, *B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_select_nn.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_select_nn.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_select_nn.setArg(2, B->shape[0]));
   OCL_CHECK(err, err = kernel_select_nn.setArg(3, A->stride[0]));
   OCL_CHECK(err, err = kernel_select_nn.setArg(4, B->stride[0]));
@@ -128,8 +128,8 @@ void fpga_select_back_nn(Tensor *A, Tensor *B, SelDescriptor *sd){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_select_back_nn.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_select_back_nn.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_select_back_nn.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_select_back_nn.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_select_back_nn.setArg(2, A->shape[0]));
   OCL_CHECK(err, err = kernel_select_back_nn.setArg(3, A->stride[0]));
   OCL_CHECK(err, err = kernel_select_back_nn.setArg(4, B->stride[0]));
@@ -158,8 +158,8 @@ void fpga_set_select_nn(Tensor *A, Tensor *B, SelDescriptor *sd){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_set_select_nn.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_set_select_nn.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_set_select_nn.setArg(0, *fpga_kernel_out(A)));
+  OCL_CHECK(err, err = kernel_set_select_nn.setArg(1, *fpga_kernel_in(B)));
   OCL_CHECK(err, err = kernel_set_select_nn.setArg(2, B->shape[0]));
   OCL_CHECK(err, err = kernel_set_select_nn.setArg(3, A->stride[0]));
   OCL_CHECK(err, err = kernel_set_select_nn.setArg(4, B->stride[0]));
@@ -188,8 +188,8 @@ void fpga_set_select_back_nn(Tensor *A, Tensor *B, SelDescriptor *sd){
   cl_int err;
   cl::Event event;
 
-  OCL_CHECK(err, err = kernel_set_select_back_nn.setArg(0, *(A->fpga_ptr)));
-  OCL_CHECK(err, err = kernel_set_select_back_nn.setArg(1, *(B->fpga_ptr)));
+  OCL_CHECK(err, err = kernel_set_select_back_nn.setArg(0, *fpga_kernel_in(A)));
+  OCL_CHECK(err, err = kernel_set_select_back_nn.setArg(1, *fpga_kernel_out(B)));
   OCL_CHECK(err, err = kernel_set_select_back_nn.setArg(2, B->shape[0]));
   OCL_CHECK(err, err = kernel_set_select_back_nn.setArg(3, A->stride[0]));
   OCL_CHECK(err, err = kernel_set_select_back_nn.setArg(4, B->stride[0]));
@@ -0,0 +1,51 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.7
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: April 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <cstdio>
+#include <cuda.h>
+#include <cuda_runtime_api.h>
+#include <cublas_v2.h>
+
+#include "eddl/hardware/gpu/nn/gpu_tensor_nn.h"
+#include "eddl/hardware/gpu/nn/gpu_tensor_nn_kernels.h"
+
+#include "eddl/hardware/gpu/gpu_tensor.h"
+
+#include "eddl/tensor/tensor.h"
+
+
+void gpu_sgd_update(Tensor *P, Tensor *G, Tensor *M, float lr, float mu, float weight_decay, bool nesterov){
+  int device=P->gpu_device;
+  cudaSetDevice(device);
+
+  setDims(P);
+
+  sgd_update<<<dimGrid,dimBlock>>>(P->ptr,G->ptr,M->ptr,lr,mu,weight_decay,nesterov,P->size);
+  check_cuda(cudaDeviceSynchronize(),"gpu_sgd_update");
+}
+
+void gpu_adam_update(Tensor *P, Tensor *G, Tensor *M, Tensor *V, float step, float beta_1, float beta_2, float inv_bc2, float epsilon, float weight_decay){
+  int device=P->gpu_device;
+  cudaSetDevice(device);
+
+  setDims(P);
+
+  adam_update<<<dimGrid,dimBlock>>>(P->ptr,G->ptr,M->ptr,V->ptr,step,beta_1,beta_2,inv_bc2,epsilon,weight_decay,P->size);
+  check_cuda(cudaDeviceSynchronize(),"gpu_adam_update");
+}
+
+void gpu_rmsprop_update(Tensor *P, Tensor *G, Tensor *G1, float lr, float rho, float epsilon, float weight_decay){
+  int device=P->gpu_device;
+  cudaSetDevice(device);
+
+  setDims(P);
+
+  rmsprop_update<<<dimGrid,dimBlock>>>(P->ptr,G->ptr,G1->ptr,lr,rho,epsilon,weight_decay,P->size);
+  check_cuda(cudaDeviceSynchronize(),"gpu_rmsprop_update");
+}
@@ -0,0 +1,59 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.7
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: April 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+
+#include <string.h>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <cuda.h>
+
+#include "eddl/hardware/gpu/nn/gpu_tensor_nn_kernels.h"
+#include "eddl/hardware/gpu/gpu_kernels.h"
+
+
+__global__ void sgd_update(float *p, float *g, float *m, float lr, float mu, float weight_decay, bool nesterov, long int size)
+{
+  long int thread_id_x = threadIdx.x+blockIdx.x*blockDim.x;
+
+  if (thread_id_x < size){
+    float gi=g[thread_id_x]+weight_decay*p[thread_id_x];
+    float mi=mu*m[thread_id_x]+lr*gi;
+    m[thread_id_x]=mi;
+    if (nesterov) p[thread_id_x]-=mu*mi+lr*gi;
+    else p[thread_id_x]-=mi;
+  }
+}
+
+__global__ void adam_update(float *p, float *g, float *m, float *v, float step, float beta_1, float beta_2, float inv_bc2, float epsilon, float weight_decay, long int size)
+{
+  long int thread_id_x = threadIdx.x+blockIdx.x*blockDim.x;
+
+  if (thread_id_x < size){
+    float gi=g[thread_id_x]+weight_decay*p[thread_id_x];
+    float mi=beta_1*m[thread_id_x]+(1.0f-beta_1)*gi;
+    float vi=beta_2*v[thread_id_x]+(1.0f-beta_2)*gi*gi;
+    m[thread_id_x]=mi;
+    v[thread_id_x]=vi;
+    p[thread_id_x]-=step*mi/sqrtf(vi*inv_bc2+epsilon);
+  }
+}
+
+__global__ void rmsprop_update(float *p, float *g, float *g1, float lr, float rho, float epsilon, float weight_decay, long int size)
+{
+  long int thread_id_x = threadIdx.x+blockIdx.x*blockDim.x;
+
+  if (thread_id_x < size){
+    float gi=g[thread_id_x]+weight_decay*p[thread_id_x];
+    float prev=g1[thread_id_x];
+    float ms=(1.0f-rho)*gi*gi+rho*prev*prev;
+    g1[thread_id_x]=gi;
+    p[thread_id_x]-=lr*gi/sqrtf(ms+epsilon);
+  }
+}
@@ -0,0 +1,74 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.7
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: April 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <cstring>
+
+#include "eddl/hardware/host_mirror.h"
+
+
+DeviceMemory::DeviceMemory() {
+    reset_counters();
+}
+
+void DeviceMemory::reset_counters() {
+    reads = 0;
+    writes = 0;
+    bytes_read = 0;
+    bytes_written = 0;
+}
+
+
+void *MockDeviceMemory::create(long size) {
+    return new float[size];
+}
+
+void MockDeviceMemory::destroy(void *buf) {
+    delete[] (float *) buf;
+}
+
+void MockDeviceMemory::read(void *buf, float *host, long size) {
+    std::memcpy(host, buf, size * sizeof(float));
+    reads++;
+    bytes_read += size * sizeof(float);
+}
+
+void MockDeviceMemory::write(void *buf, const float *host, long size) {
+    std::memcpy(buf, host, size * sizeof(float));
+    writes++;
+    bytes_written += size * sizeof(float);
+}
+
+
+HostMirror::HostMirror() {
+    state = MIRROR_SHARED;
+}
+
+void HostMirror::host_read(DeviceMemory *mem, void *buf, float *host, long size, float *dst) {
+    if (state == MIRROR_DEVICE) {
+        mem->read(buf, host, size);
+        state = MIRROR_SHARED;
+    }
+    if ((dst != nullptr) && (dst != host)) std::memcpy(dst, host, size * sizeof(float));
+}
+
+void HostMirror::host_write(float *host, long size, const float *src) {
+    if ((src != nullptr) && (src != host)) std::memcpy(host, src, size * sizeof(float));
+    state = MIRROR_HOST;
+}
+
+void HostMirror::device_read(DeviceMemory *mem, void *buf, float *host, long size) {
+    if (state == MIRROR_HOST) {
+        mem->write(buf, host, size);
+        state = MIRROR_SHARED;
+    }
+}
+
+void HostMirror::device_write() {
+    state = MIRROR_DEVICE;
+}
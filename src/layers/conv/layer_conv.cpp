@@ -25,9 +25,7 @@ LConv::LConv(Layer *parent, const vector<int> &ks, const vector<int> &st,
              const vector<int> &p, string name, int dev, int mem) : LConv(parent, new ConvolDescriptor(ks, st, p, mem), name, dev, mem) {}
 
 LConv::LConv(Layer *parent, int filters, const vector<int> &kernel_size, const vector<int> &strides, string padding,
-             int groups, const vector<int> &dilation_rate, bool use_bias, string name, int dev, int mem) : LConv(parent, new ConvolDescriptor(filters, kernel_size, strides, padding, use_bias, mem), name, dev, mem) {
-    // TODO: Implement (Fix initialization)
-};
+             int groups, const vector<int> &dilation_rate, bool use_bias, string name, int dev, int mem) : LConv(parent, new ConvolDescriptor(filters, kernel_size, strides, padding, use_bias, groups, dilation_rate, mem), name, dev, mem) {};
 
 LConv::LConv(Layer *parent, ConvolDescriptor *D, string name, int dev, int mem) : LinLayer(name, dev, mem) {
     if (parent->output->ndim != 4) msg("LConv only works over 4D tensors", "LConv::LConv");
@@ -61,6 +59,9 @@ LConv::LConv(Layer *parent, ConvolDescriptor *D, string name, int dev, int mem)
     addparent(parent);
 }
 
+LConv::~LConv(){
+    delete cd;
+}
 
 // virtual
 void LConv::resize(int batch){
@@ -84,10 +85,16 @@ void LConv::mem_delta(){
 }
 
 void LConv::forward() {
+    // The weights only stay fixed in test mode. Shares (unrolled nets) see
+    // the weights of the original layer change behind them
+    cd->keep_U = (mode == TSMODE) && (!isshared);
     tensorNN::Conv2D(this->cd);
 }
 
 void LConv::backward() {
+    // delta of the fused activation
+    if (cd->act != EPI_NONE) tensorNN::d_act(delta, output, cd->act, cd->act_param);
+
     //get gradients with provided delta
     if (trainable) { tensorNN::Conv2D_grad(this->cd); }
 
@@ -101,11 +108,13 @@ void LConv::backward() {
 }
 
 void LConv::update_weights(Tensor* w, Tensor* bias) {
+    cd->valid_U = false;
     Tensor::copy( w, cd->K );
     if ( bias != nullptr ) Tensor::copy( bias, cd->bias );
 }
 
 void LConv::accumulate_accumulated_gradients(Tensor* gw, Tensor* gbias) {
+    cd->valid_U = false;
     cd->K->add_( gw );
     if ( gbias != nullptr ) cd->bias->add_( gbias );
 }
@@ -116,6 +125,7 @@ void LConv::reset_accumulated_gradients() {
 }
 
 void LConv::apply_accumulated_gradients() {
+    cd->valid_U = false;
     cd->K->add_( cd->acc_gK );
     cd->bias->add_( cd->acc_gbias );
 
@@ -123,9 +133,22 @@ void LConv::apply_accumulated_gradients() {
     if(reg!= nullptr) {reg->apply(cd->K);}
 }
 
+void LConv::copy(Layer *l2) {
+    Layer::copy(l2);
+    ((LConv *) l2)->cd->valid_U = false;
+}
+
+void LConv::load(std::ifstream &ifs, string format) {
+    Layer::load(ifs, format);
+    cd->valid_U = false;
+}
+
 Layer *LConv::share(int c, int bs, vector<Layer *> p) {
     // TODO: share ComvDescriptor
-    LConv *n = new LConv(p[0], cd->ksize, cd->stride, cd->pad,  name, dev,mem_level);
+    auto *d = new ConvolDescriptor(cd->ksize, cd->stride, cd->pad, mem_level);
+    d->groups = cd->groups;
+    d->dr = cd->dr; d->dc = cd->dc;
+    LConv *n = new LConv(p[0], d, name, dev, mem_level);
     n->orig = this;
     n->isshared=true;
     n->trainable = trainable;
@@ -139,7 +162,6 @@ Layer *LConv::share(int c, int bs, vector<Layer *> p) {
 
     n->cd->K = cd->K;
     n->cd->bias = cd->bias;
-    n->cd->matK = cd->matK;
 
     n->params.push_back(n->cd->K);
     n->params.push_back(n->cd->bias);
@@ -173,7 +195,10 @@ Layer *LConv::share(int c, int bs, vector<Layer *> p) {
 
 Layer *LConv::clone(int c, int bs, vector<Layer *> p, int todev) {
 
-    LConv *n = new LConv(p[0], cd->ksize, cd->stride, cd->pad,  name, todev, this->mem_level);
+    auto *d = new ConvolDescriptor(cd->ksize, cd->stride, cd->pad, this->mem_level);
+    d->groups = cd->groups;
+    d->dr = cd->dr; d->dc = cd->dc;
+    LConv *n = new LConv(p[0], d, name, todev, this->mem_level);
     n->trainable = trainable;
 
     n->orig = this;
@@ -28,13 +28,55 @@ LActivation::LActivation(Layer *parent, string act, vector<float> params, string
     input = parent->output;
     output = new Tensor(input->shape, dev);
     delta_bp = 0;
+    fused = false;
+    inplace = false;
 
     parent->addchild(this);
     addparent(parent);
 }
 
+LActivation::~LActivation(){
+    // The buffers belong to the parent
+    if (fused || inplace) output->ptr = nullptr;
+    if (fused && (delta != nullptr)) delta->ptr = nullptr;
+}
+
+void LActivation::mem_delta(){
+    if (!fused) {
+        Layer::mem_delta();
+        return;
+    }
+
+    if (this->delta == nullptr) {
+        // The parent applies the derivative to its delta (as a reshape)
+        parent[0]->mem_delta();
+        delta = new Tensor(output->shape, parent[0]->delta);
+
+        if(this->verbosity_level >= 2){
+            std::cout << "Booked delta for: " + this->name << std::endl;
+        }
+    }
+}
+
+void LActivation::free_delta(){
+    if (fused && (this->delta != nullptr)) delta->ptr = nullptr;
+    Layer::free_delta();
+}
+
+void LActivation::resize(int batch){
+    if ((!fused) || (output->shape[0] == batch)) {
+        Layer::resize(batch);
+        return;
+    }
+
+    parent[0]->resize(batch);
+    output->ptr = nullptr;
+    output->resize(batch, parent[0]->output->ptr);
+}
+
 
 void LActivation::forward(){
+    if (fused) return;
 
     if (act == "relu"){
         tensorNN::ReLu(this->input, this->output);
@@ -88,6 +130,8 @@ void LActivation::forward(){
 
 
 void LActivation::backward(){
+    if (fused) return;
+
     if (delta_bp){
         Tensor::inc(delta, parent[0]->delta);
     }else {
@@ -24,6 +24,9 @@ LDense::LDense(Layer *parent, int ndim, bool use_bias, string name, int dev, int
     if(name.empty()) this->name = "dense" + to_string(++total_layers);
     this->ndim = ndim;
     this->use_bias = use_bias;
+    this->act = EPI_NONE;
+    this->act_param = 0.0f;
+    bias = gbias = nullptr;
 
     input = parent->output;
     output = new Tensor(vector<int>{input->shape[0], ndim}, dev);
@@ -50,10 +53,14 @@ LDense::LDense(Layer *parent, int ndim, bool use_bias, string name, int dev, int
 
 void LDense::forward() {
     Tensor::mult2D(input, 0, W, 0, output, 0);
-    if (use_bias) Tensor::sum2D_rowwise(output, bias, output);
+    if (act != EPI_NONE) tensorNN::bias_act(output, use_bias ? bias : nullptr, act, act_param);
+    else if (use_bias) Tensor::sum2D_rowwise(output, bias, output);
 }
 
 void LDense::backward() {
+    // delta of the fused activation
+    if (act != EPI_NONE) tensorNN::d_act(delta, output, act, act_param);
+
     //get gradients with provided delta
     if (trainable) {
         Tensor::mult2D(input, 1, delta, 0, gW, 1);
@@ -30,7 +30,7 @@ LDropout::LDropout(Layer *parent, float df, bool iw, string name, int dev, int m
     output = new Tensor(input->shape, dev);
     //    delta = new Tensor(output->shape, dev);
 
-    mask = new Tensor(input->shape, dev);
+    alloc_mask();
 
     parent->addchild(this);
     addparent(parent);
@@ -39,19 +39,34 @@ LDropout::LDropout(Layer *parent, float df, bool iw, string name, int dev, int m
 LDropout::~LDropout()
 {
     delete mask;
+    delete[] mask_bits;
+}
+
+void LDropout::alloc_mask() {
+    mask = nullptr;
+    mask_bits = nullptr;
+    if (input->isCPU()) mask_bits = new unsigned int[(input->size + 31) / 32];
+    else mask = new Tensor(input->shape, dev);
 }
 
 // virtual
 void LDropout::resize(int batch){
     Layer::resize(batch);
     delete mask;
-    mask = new Tensor(input->shape, dev);
+    delete[] mask_bits;
+    alloc_mask();
 }
 
 void LDropout::forward() {
     if (mode == TRMODE) {
-        mask->rand_binary(1.0 - df);
-        Tensor::el_mult(input, mask, output, 0);
+        if (mask_bits != nullptr) {
+            // mask drawn and applied in the same pass
+            tensorNN::dropout_forward(input, output, mask_bits, 1.0 - df, 1.0);
+        }
+        else {
+            mask->rand_binary(1.0 - df);
+            Tensor::el_mult(input, mask, output, 0);
+        }
     } else {
         Tensor::copy(input, output);
         if (iw) output->mult_(1.0 - df);
@@ -60,7 +75,8 @@ void LDropout::forward() {
 }
 
 void LDropout::backward() {
-    Tensor::el_mult(delta, mask, parent[0]->delta, 1);
+    if (mask_bits != nullptr) tensorNN::dropout_backward(delta, parent[0]->delta, mask_bits, 1.0);
+    else Tensor::el_mult(delta, mask, parent[0]->delta, 1);
 }
 
 
@@ -19,6 +19,27 @@ using namespace std;
 
 int LEmbedding::total_layers = 0;
 
+
+SparseRows::SparseRows(int n) : in(n, false) {
+    all = true;
+}
+
+void SparseRows::add(const vector<int> &ind) {
+    for (int r : ind) {
+        if (!in[r]) {
+            in[r] = true;
+            rows.push_back(r);
+        }
+    }
+}
+
+void SparseRows::clear() {
+    for (int r : rows) in[r] = false;
+    rows.clear();
+    all = false;
+}
+
+
 LEmbedding::LEmbedding(Layer *parent, int vocsize, int length, int dim, bool mask_zeros, string name, int dev, int mem): LinLayer(name, dev, mem) {
     // TODO: Implement
     if(name.empty()) this->name = "embedding" + to_string(++total_layers);
@@ -61,6 +82,7 @@ LEmbedding::LEmbedding(Layer *parent, int vocsize, int length, int dim, bool mas
 
     gE=new Tensor({vocsize,dim},dev);
     gradients.push_back(gE);
+    grows=new SparseRows(vocsize);
 
 
     parent->addchild(this);
@@ -68,6 +90,11 @@ LEmbedding::LEmbedding(Layer *parent, int vocsize, int length, int dim, bool mas
 
 }
 
+LEmbedding::~LEmbedding()
+{
+  if (!isshared) delete grows;
+}
+
 void LEmbedding::forward()
 {
 
@@ -78,23 +105,27 @@ void LEmbedding::forward()
 
   input->reshape_({b*length});
 
-  sind.clear();
+  sind.resize(b*length);
 
-  Tensor *inputc=input->clone();
-  inputc->toCPU();
+  // Indices are read in place when the input already lives on CPU
+  Tensor *inputc=input;
+  if (!input->isCPU()) {
+    inputc=input->clone();
+    inputc->toCPU();
+  }
 
+  float *in=inputc->ptr;
   for(int i=0;i<b*length;i++) {
-      int val=(int)inputc->ptr[i*inputc->stride[0]];
-    //int val=0;
+    int val=(int)in[i];
     if (val>=vocsize) {
       cout<<"\n Warning word:"<<val<<" out of vocabulary\n";
       val=0;
       //msg("word > vocsize","LEmbedding::forward");
     }
-    sind.push_back(val);
+    sind[i]=val;
   }
 
-  delete inputc;
+  if (inputc!=input) delete inputc;
 
   output->reshape_({b*length,dim});
 
@@ -115,6 +146,7 @@ void LEmbedding::backward()
      delta->reshape_({b*length,dim});
 
      Tensor::deselect(delta,gE, sind, 0,sind.size(),1, mask_zeros); //1=inc
+     grows->add(sind);
 
      delta->reshape_({b,length*dim});
 
@@ -122,6 +154,29 @@ void LEmbedding::backward()
    }
 }
 
+// Only the rows written by backward are cleared
+void LEmbedding::zeroGrads()
+{
+  if ((!gE->isCPU()) || (grows->all)) {
+    Layer::zeroGrads();
+  }
+  else {
+    vector<int> &rows=grows->rows;
+    #pragma omp parallel for
+    for(int i=0;i<rows.size();i++) {
+      float *g=gE->ptr+(long int)rows[i]*dim;
+      for(int j=0;j<dim;j++) g[j]=0.0;
+    }
+  }
+  grows->clear();
+}
+
+vector<int> *LEmbedding::sparse_rows(int j)
+{
+  if (grows->all) return nullptr;
+  return &grows->rows;
+}
+
 
 
 
@@ -141,6 +196,9 @@ Layer *LEmbedding::share(int c, int bs, vector<Layer *> p) {
     n->E = E;
     n->gE = gE;
 
+    delete n->grows;
+    n->grows = grows;
+
     n->params.push_back(E);
     n->gradients.push_back(gE);
 
@@ -86,7 +86,7 @@ LReshape::~LReshape()
 void LReshape::resize(int batch){
     ls[0]=batch;
 #ifdef cFPGA
-    output->resize(batch, parent[0]->output->ptr, parent[0]->output->fpga_ptr);
+    output->resize(batch, parent[0]->output->ptr, parent[0]->output->fpga_ptr, parent[0]->output->fpga_mirror);
 #else
     output->resize(batch, parent[0]->output->ptr);
 #endif
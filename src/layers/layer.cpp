@@ -86,11 +86,11 @@ void Layer::set_detach(){
 }
 
 
-void Layer::check_target() {
-  if (target==nullptr) target=new Tensor(output->getShape(),dev);
-  else if (target->size!=output->size) {
+void Layer::check_target(const vector<int> &shape) {
+  if (target==nullptr) target=new Tensor(shape,dev);
+  else if (target->shape!=shape) {
     delete target;
-    target=new Tensor(output->getShape(),dev);
+    target=new Tensor(shape,dev);
   }
 }
 
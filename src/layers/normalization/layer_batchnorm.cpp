@@ -37,6 +37,7 @@ LBatchNorm::LBatchNorm(Layer *parent, float momentum, float epsilon, bool affine
     this->momentum = momentum;
     this->epsilon = epsilon;
     this->affine = affine;
+    this->folded = false;
 
     output=new Tensor(input->getShape(),dev);
     opa=new Tensor(input->getShape(),dev);
@@ -48,7 +49,10 @@ LBatchNorm::LBatchNorm(Layer *parent, float momentum, float epsilon, bool affine
 
     bn_mean=new Tensor(shape,dev);
     bn_var=new Tensor(shape,dev);
+    bn_dmean=new Tensor(shape,dev);
+    bn_dopa=new Tensor(shape,dev);
 
+    bn_g=bn_b=gbn_g=gbn_b=nullptr;
     if (affine) {
 
         bn_g=new Tensor(shape,dev);
@@ -72,6 +76,11 @@ LBatchNorm::LBatchNorm(Layer *parent, float momentum, float epsilon, bool affine
     addparent(parent);
 }
 
+LBatchNorm::~LBatchNorm(){
+    // The output is the one of the parent
+    if (folded) output->ptr = nullptr;
+}
+
 
 // override functions:
 int LBatchNorm::get_trainable_params_count()
@@ -88,6 +97,15 @@ void LBatchNorm::initialize() {
 }
 
 void LBatchNorm::resize(int batch){
+    if (folded) {
+        if (batch!=output->shape[0]) {
+            parent[0]->resize(batch);
+            output->ptr=nullptr;
+            output->resize(batch, parent[0]->output->ptr);
+        }
+        return;
+    }
+
     if (batch!=output->shape[0]) {
         opa->reshape_(output->getShape());
         output->resize(batch);
@@ -95,12 +113,21 @@ void LBatchNorm::resize(int batch){
     }
 }
 
-// Batchnorm works over 2D Tensors
+// On CPU the statistics, normalization and affine transform are computed
+// in place over the NCHW layout in two fused passes.
+// Otherwise Batchnorm works over 2D Tensors:
 // Essentialy 4D Tensors are reshaped as 2D and
 // Permute 4D tensors and set N,M values.
 void LBatchNorm::forward() {
     // Input = Output = opa = {Batch,Channels,H,W} OR {Batch,Dim}
     // bn_mean = bn_var = mean = variance = bn_g = bn_b = {Channels} or {Dim}
+    if (folded) return;
+
+    if (input->isCPU()) {
+        tensorNN::batchnorm_forward(input, output, opa, mean, variance, bn_g, bn_b, bn_mean, bn_var,
+                                    mode==TRMODE, epsilon, momentum);
+        return;
+    }
 
     int M,N;
     int b,z,r,c,d;
@@ -156,6 +183,11 @@ void LBatchNorm::backward(){
 
     Tensor *dp;
 
+    if (input->isCPU()) {
+        tensorNN::batchnorm_backward(delta, opa, parent[0]->delta, bn_var, bn_g, gbn_g, gbn_b, bn_dmean, bn_dopa);
+        return;
+    }
+
     if (input->ndim==2) {
         N=b=input->shape[0];
         M=d=input->shape[1];
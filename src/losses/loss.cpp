@@ -24,4 +24,12 @@ void Loss::delta(Tensor *T, Tensor *Y, Tensor *D) {}
 
 float Loss::value(Tensor *T, Tensor *Y) {return 0;}
 
+float Loss::value_delta(Tensor *T, Tensor *Y, Tensor *D) {
+    float f = value(T, Y);
+    delta(T, Y, D);
+    return f;
+}
+
+vector<int> Loss::target_shape(const vector<int> &oshape) {return oshape;}
+
 Loss* Loss::clone() {return this;}
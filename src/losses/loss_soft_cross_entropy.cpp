@@ -26,9 +26,12 @@ void LSoftCrossEntropy::delta(Tensor *T, Tensor *Y, Tensor *D) {
 }
 
 float LSoftCrossEntropy::value(Tensor *T, Tensor *Y) {
+    int size=T->size/T->shape[0];  // batch is divided in print_loss
+
+    if (T->ndim == 2) return tensorNN::softmax_cent(T, Y, nullptr)/size;
+
     float f;
     Tensor *aux1;
-    int size=T->size/T->shape[0];  // batch is divided in print_loss
 
     aux1 = new Tensor(T->getShape(), T->device);
     tensorNN::cent(T, Y, aux1);
@@ -38,6 +41,12 @@ float LSoftCrossEntropy::value(Tensor *T, Tensor *Y) {
 
     return f;
 }
+
+float LSoftCrossEntropy::value_delta(Tensor *T, Tensor *Y, Tensor *D) {
+    int size=T->size/T->shape[0];  // batch is divided in print_loss
+
+    return tensorNN::softmax_cent(T, Y, D)/size;
+}
 Loss* LSoftCrossEntropy::clone()
 {
   return new LSoftCrossEntropy();
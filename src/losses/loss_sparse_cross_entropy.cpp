@@ -0,0 +1,38 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.7
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: April 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include "eddl/losses/loss.h"
+
+using namespace std;
+
+
+LSparseCrossEntropy::LSparseCrossEntropy() : Loss("sparse_categorical_cross_entropy"){}
+
+void LSparseCrossEntropy::delta(Tensor *T, Tensor *Y, Tensor *D) {
+    // delta: t/y - (1-t)/(1-y) of the one-hot targets
+    tensorNN::sparse_cent(T, Y, D, false);
+}
+
+float LSparseCrossEntropy::value(Tensor *T, Tensor *Y) {
+    return tensorNN::sparse_cent(T, Y, nullptr, false);
+}
+
+vector<int> LSparseCrossEntropy::target_shape(const vector<int> &oshape) {
+    return {oshape[0], 1};
+}
+
+Loss* LSparseCrossEntropy::clone()
+{
+  return new LSparseCrossEntropy();
+}
@@ -0,0 +1,46 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.7
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: April 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include "eddl/losses/loss.h"
+
+using namespace std;
+
+
+LSparseSoftCrossEntropy::LSparseSoftCrossEntropy() : Loss("sparse_soft_cross_entropy"){}
+
+
+void LSparseSoftCrossEntropy::delta(Tensor *T, Tensor *Y, Tensor *D) {
+    tensorNN::sparse_cent(T, Y, D, true);
+}
+
+float LSparseSoftCrossEntropy::value(Tensor *T, Tensor *Y) {
+    int size=Y->size/Y->shape[0];  // batch is divided in print_loss
+
+    return tensorNN::sparse_cent(T, Y, nullptr, true)/size;
+}
+
+float LSparseSoftCrossEntropy::value_delta(Tensor *T, Tensor *Y, Tensor *D) {
+    int size=Y->size/Y->shape[0];  // batch is divided in print_loss
+
+    return tensorNN::sparse_cent(T, Y, D, true)/size;
+}
+
+vector<int> LSparseSoftCrossEntropy::target_shape(const vector<int> &oshape) {
+    return {oshape[0], 1};
+}
+
+Loss* LSparseSoftCrossEntropy::clone()
+{
+  return new LSparseSoftCrossEntropy();
+}
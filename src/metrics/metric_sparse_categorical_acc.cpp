@@ -0,0 +1,29 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.7
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: April 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include "eddl/metrics/metric.h"
+
+using namespace std;
+
+
+MSparseCategoricalAccuracy::MSparseCategoricalAccuracy() : Metric("sparse_categorical_accuracy"){}
+
+float MSparseCategoricalAccuracy::value(Tensor *T, Tensor *Y) {
+    float f;
+    f = tensorNN::sparse_accuracy(T, Y);
+    return f;
+}
+
+Metric* MSparseCategoricalAccuracy::clone() {
+    return new MSparseCategoricalAccuracy();
+}
@@ -61,6 +61,10 @@ CompServ * CompServ::share() {
   n->lsb=lsb;
   n->isshared=true;
   n->mem_level=mem_level;
+  n->persistent_workers=persistent_workers;
+  n->pin_workers=pin_workers;
+  n->conv_workspace_mb=conv_workspace_mb;
+  n->seed=seed;
 
   return n;
 }
@@ -0,0 +1,74 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.7
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: April 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <algorithm>
+
+#include "eddl/net/mem_plan.h"
+#include "eddl/hardware/cpu/cpu_allocator.h"
+
+// Offsets keep the FMEM_ALIGN alignment of the arena
+#define MEM_ALIGN (FMEM_ALIGN / sizeof(float))
+
+static long align_up(long n) {
+    return (n + MEM_ALIGN - 1) / MEM_ALIGN * MEM_ALIGN;
+}
+
+
+MemPlan::MemPlan() {
+    naive = 0;
+    peak = 0;
+}
+
+int MemPlan::add(long size, int start, int end) {
+    MemBlock b;
+    b.size = size;
+    b.start = start;
+    b.end = end;
+    b.offset = 0;
+    blocks.push_back(b);
+    naive += size;
+    return blocks.size() - 1;
+}
+
+void MemPlan::place() {
+    vector<int> order(blocks.size());
+    for (int i = 0; i < order.size(); i++) order[i] = i;
+    stable_sort(order.begin(), order.end(), [this](int a, int b) {
+        return blocks[a].size > blocks[b].size;
+    });
+
+    peak = 0;
+    vector<int> placed;
+    for (int i : order) {
+        MemBlock &b = blocks[i];
+
+        // Placed blocks alive at the same time, by offset
+        vector<int> live;
+        for (int j : placed)
+            if ((blocks[j].start <= b.end) && (b.start <= blocks[j].end)) live.push_back(j);
+        sort(live.begin(), live.end(), [this](int x, int y) {
+            return blocks[x].offset < blocks[y].offset;
+        });
+
+        long need = align_up(b.size);
+        long best = -1, best_gap = 0, cur = 0;
+        for (int j : live) {
+            long gap = blocks[j].offset - cur;
+            if ((gap >= need) && ((best < 0) || (gap < best_gap))) {
+                best = cur;
+                best_gap = gap;
+            }
+            cur = max(cur, align_up(blocks[j].offset + blocks[j].size));
+        }
+        b.offset = (best >= 0) ? best : cur;
+
+        peak = max(peak, b.offset + b.size);
+        placed.push_back(i);
+    }
+}
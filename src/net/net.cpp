@@ -20,8 +20,10 @@
 #include <pthread.h>
 #include "eddl/utils.h"
 #include "eddl/random.h"
+#include "eddl/profiler.h"
 
 #include "eddl/layers/core/layer_core.h"
+#include "eddl/layers/normalization/layer_normalization.h"
 
 
 
@@ -72,11 +74,22 @@ Net::Net() {
     flog_tr=nullptr;
     flog_ts=nullptr;
     rnet=nullptr;
+    rnet_cache_size=4;
+    rnet_bucket=1;
+    rinl=routl=0;
+    workers=nullptr;
+    delta_arena=nullptr;
+    output_arena=nullptr;
+    cs=nullptr;
     isbuild=false;
+    isfrozen=false;
+    isfolded=false;
     isdecoder=false;
     isencoder=false;
     isrecurrent=false;
     decsize=1;
+    inferenced_samples=0;
+    inferenced_steps=0;
 }
 
 Net::Net(vlayer in, vlayer out):Net() {
@@ -101,8 +114,6 @@ Net::Net(vlayer in, vlayer out):Net() {
         fiterr.push_back(0.0);
     }
 
-
-    build_randn_table();
 }
 
 Net::Net(vector <Net *> vnets):Net()
@@ -114,6 +125,12 @@ Net::Net(vector <Net *> vnets):Net()
     msg("Use at least two networks to concatenate","Net::Net");
   }
 
+  // The layers are linked to other nets now, their deltas cannot be planned per net
+  for(int i=0;i<vsize;i++) {
+    if (vnets[i]->isfrozen) msg("Frozen nets can not be merged","Net::Net");
+    vnets[i]->release_memory_plan();
+  }
+
   for(int i=0;i<vnets[0]->lin.size();i++)
     lin.push_back(vnets[0]->lin[i]);
 
@@ -147,11 +164,6 @@ Net::Net(vector <Net *> vnets):Net()
 
   isrecurrent=false;
   rnet=nullptr;
-
-
-  build_randn_table();
-
-
 }
 
 
@@ -159,6 +171,13 @@ Net::Net(vector <Net *> vnets):Net()
 
 Net::~Net()
 {
+    release_memory_plan();
+
+    for(int i=0;i<rnets.size();i++)
+        delete rnets[i];
+    rnets.clear();
+    rnet=nullptr;
+
     for(int i=0;i<snets.size();i++){
 
         for(int j=0;j<snets[i]->layers.size();j++) {
@@ -183,6 +202,9 @@ Net::~Net()
 
     delete optimizer;
     optimizer= nullptr;
+
+    delete workers;
+    workers= nullptr;
 }
 
 /////////////////////////////////////////
@@ -250,6 +272,11 @@ string Net::summary() {
         ss << setw(10) << left << istr;
         ss << setw(8) << left << "=>";
         ss << setw(10) << left << ostr;
+        // computed by the parent (Net::fuse_layers, Net::fold_batchnorm)
+        auto *act = dynamic_cast<LActivation *>(l);
+        auto *bn = dynamic_cast<LBatchNorm *>(l);
+        if ((act != nullptr) && act->fused) ss << "(fused)";
+        if ((bn != nullptr) && bn->folded) ss << "(folded)";
         ss << endl;
     }
     ss << "---------------------------------------------------------" << endl;
@@ -257,6 +284,48 @@ string Net::summary() {
     return ss.str();
 }
 
+// Time (ms) and memory of the calls of each layer recorded by the profiler,
+// also by its copies in the computing service
+string Net::profile_summary() {
+    map<string, ProfStats> stats = prof_layer_stats();
+    ProfStats total = {{0, 0, 0}, {0, 0, 0}, 0};
+    auto add = [](ProfStats &a, const ProfStats &b) {
+        for (int k = 0; k < 3; k++) {
+            a.calls[k] += b.calls[k];
+            a.ns[k] += b.ns[k];
+        }
+        a.bytes += b.bytes;
+    };
+    auto row = [](std::stringstream &ss, const string &name, const ProfStats &st) {
+        ss << setw(30) << left << name << setw(8) << right << st.calls[PROF_FORWARD] << fixed << setprecision(3);
+        for (int k = 0; k < 3; k++) ss << setw(12) << right << st.ns[k] * 1e-6;
+        ss << setw(12) << right << bytes2human(st.bytes) << endl;
+    };
+
+    std::stringstream ss;
+    ss << "---------------------------------------------------------" << endl;
+    ss << name << " profile (ms)" << endl;
+    ss << "---------------------------------------------------------" << endl;
+    ss << setw(30) << left << "layer" << setw(8) << right << "calls" << setw(12) << "forward"
+       << setw(12) << "backward" << setw(12) << "update" << setw(12) << "allocated" << endl;
+
+    for (auto & l : vfts) {
+        ProfStats st = {{0, 0, 0}, {0, 0, 0}, 0};
+        if (stats.count(l->name)) add(st, stats[l->name]);
+        for (Net *sn : snets)
+            if (sn != this)
+                for (Layer *sl : sn->layers)
+                    if ((sl->orig == l) && stats.count(sl->name)) add(st, stats[sl->name]);
+        add(total, st);
+        row(ss, l->name, st);
+    }
+    ss << "---------------------------------------------------------" << endl;
+    row(ss, "total", total);
+    ss << "---------------------------------------------------------" << endl;
+
+    return ss.str();
+}
+
 void Net::plot(string fname,string mode) {
     ofstream out("tmp.dot");
     int ind;
@@ -314,6 +383,8 @@ void Net::setlogfile(string fname)
 
 
 void Net::save(const string& filename, string format){
+    if (isfolded) msg("Nets with batchnorms folded by freeze() can not be saved", "Net::save");
+
     // Open file stream
     std::ofstream ofs(filename, std::ios::out | std::ios::binary);
 
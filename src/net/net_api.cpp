@@ -17,6 +17,7 @@
 #include <thread>
 #include <stdexcept>
 #include "eddl/net/net.h"
+#include "eddl/net/sampler.h"
 #include <pthread.h>
 #include "eddl/utils.h"
 #include "eddl/random.h"
@@ -151,6 +152,34 @@ void *update_t(void *t) {
 /////////////////////////////////////////
 // "a ring to rule them all"
 void Net::run_snets(void *(*F)(void *t))
+{
+  int comp=snets.size();
+
+  if ((cs!=nullptr)&&(!cs->persistent_workers)) {
+    run_snets_spawn(F);
+    return;
+  }
+
+  // (Re)create the pool when the set of snets changes (toCPU, toGPU...)
+  bool pin=(cs!=nullptr)&&(cs->pin_workers);
+  if ((workers==nullptr)||(workers->size()!=comp)||(workers->ispinned()!=pin)) {
+    delete workers;
+    workers=new WorkerPool(comp,pin);
+  }
+
+  struct tdata td[100];
+  void *args[100];
+
+  for (int i = 0; i < comp; i++) {
+    td[i].net = snets[i];
+    args[i] = (void *) (&td[i]);
+  }
+
+  workers->run(F,args,comp);
+}
+
+// One thread per snet and call. Kept to compare against the worker pool
+void Net::run_snets_spawn(void *(*F)(void *t))
 {
   void *status;
   int rc;
@@ -228,12 +257,15 @@ void Net::forward(vector<Tensor*> in)
       }
 
       // Distribute to snets inputs
-      for (int i = 0; i < in.size(); i++)
-      distributeTensor(lin[i]);
+      if (!isfrozen)
+        for (int i = 0; i < in.size(); i++)
+        distributeTensor(lin[i]);
 
     }
 
-    run_snets(forward_t);
+    // Frozen nets run on the calling thread
+    if (isfrozen) do_forward();
+    else run_snets(forward_t);
   }
 
 }
@@ -301,13 +333,15 @@ void Net::forward()
 {
   reset();
 
-  run_snets(forward_t);
+  if (isfrozen) do_forward();
+  else run_snets(forward_t);
 }
 
 
 //// BACKWARD
 void Net::backward(vector<Tensor *> target)
 {
+  if (isfrozen) msg("Frozen nets only run the forward","Net.backward");
 
   if (isrecurrent) {
     if (rnet==nullptr) {
@@ -340,7 +374,7 @@ void Net::backward(vector<Tensor *> target)
         // Copy targets
         for (int j = 0; j < target.size(); j++) {
           Tensor::select(target[j], Ys[i][j], sind, start, end);
-          snets[i]->lout[j]->check_target();
+          snets[i]->lout[j]->check_target(Ys[i][j]->shape);
           Tensor::copy(Ys[i][j], snets[i]->lout[j]->target);
         }
       }
@@ -388,6 +422,7 @@ void Net::backward_recurrent(vector<Tensor *> target)
 
 
 void Net::backward(){
+  if (isfrozen) msg("Frozen nets only run the forward","Net.backward");
 
   vector<Net*> visited;
   tr_batches++;
@@ -429,24 +464,25 @@ void Net::backward(){
 void Net::reset_loss()
 {
   if (isrecurrent) {
-    if (rnet!=nullptr) rnet->reset_loss();
+    for(int i=0;i<rnets.size();i++)
+      rnets[i]->reset_loss();
   }
-  else {
-    // Reset errors
-    int p=0;
-    for (int j = 0; j < lout.size(); j++,p+=2){
-      total_loss[j] = 0.0;
-      total_metric[j] = 0.0;
-      fiterr[p] = fiterr[p + 1] = 0.0;
-    }
-    inferenced_samples=0;
+  // Reset errors (the totals of all the unrolls for recurrent nets)
+  int p=0;
+  for (int j = 0; j < lout.size(); j++,p+=2){
+    total_loss[j] = 0.0;
+    total_metric[j] = 0.0;
+    fiterr[p] = fiterr[p + 1] = 0.0;
   }
+  inferenced_samples=0;
+  inferenced_steps=0;
 }
 
 
 //// COMPUTE Loss
 void Net::compute_loss()
 {
+  if (isfrozen) msg("Frozen nets only run the forward","Net.compute_loss");
 
   if (isrecurrent) {
     if (rnet==nullptr) {
@@ -515,31 +551,59 @@ float Net::get_metric( const string  layer_name, const string  metric_name )
 
 void Net::print_loss(int b)
 {
-  int p = 0;
-
   if (isrecurrent) {
-    if (rnet!=nullptr) rnet->print_loss(b);
+    if (rnet==nullptr) return;
+    // Batches of different lengths ran on different unrolls
+    for(int i=0;i<rnets.size();i++)
+      collect_loss(rnets[i]);
+    print_totals(b,inferenced_steps);
   }
   else {
-    fprintf(stdout,"Batch %d ",b);
+    int p = 0;
     int length=decsize;
     for (int k = 0; k < lout.size(); k+=decsize) {
-
-
       for(int l=0;l<length;l++,p+=2) {
         total_loss[k] += fiterr[p];  // loss
         total_metric[k] += fiterr[p + 1];  // metric
         fiterr[p] = fiterr[p + 1] = 0.0;
       }
+    }
+    print_totals(b,length*inferenced_samples);
+  }
+}
+
+// Moves the errors of an unrolled net to the totals of this net
+void Net::collect_loss(Net *r)
+{
+  int p = 0;
+  for (int k = 0, g = 0; k < r->lout.size(); k+=r->decsize, g++) {
+    for(int l=0;l<r->decsize;l++,p+=2) {
+      if (g<total_loss.size()) {
+        total_loss[g] += r->fiterr[p];  // loss
+        total_metric[g] += r->fiterr[p + 1];  // metric
+      }
+      r->fiterr[p] = r->fiterr[p + 1] = 0.0;
+    }
+  }
+  inferenced_samples+=r->inferenced_samples;
+  inferenced_steps+=r->decsize*r->inferenced_samples;
+  r->inferenced_samples=0;
+}
+
+// steps: samples times the outputs per sample the totals were summed over
+void Net::print_totals(int b, int steps)
+{
+    fprintf(stdout,"Batch %d ",b);
+    for (int k = 0; k < lout.size(); k+=decsize) {
 
       string name=lout[k]->name;
 
       fprintf(stdout, "%s ( ", name.c_str());
       if (losses.size()>=(k+1)) {
-        fprintf(stdout, "loss[%s]=%1.3f ", losses[k]->name.c_str(), total_loss[k] / (length*inferenced_samples));
+        fprintf(stdout, "loss[%s]=%1.3f ", losses[k]->name.c_str(), total_loss[k] / steps);
       }
       if (metrics.size()>=(k+1)) {
-        fprintf(stdout, "metric[%s]=%1.3f ", metrics[k]->name.c_str(), total_metric[k] / (length*inferenced_samples));
+        fprintf(stdout, "metric[%s]=%1.3f ", metrics[k]->name.c_str(), total_metric[k] / steps);
       }
 
       fprintf(stdout, ") -- ");
@@ -585,11 +649,12 @@ void Net::print_loss(int b)
       fprintf(flog_ts, "\n");
       fflush(flog_ts);
     }
-  }
 }
 
 void Net::reset_grads()
 {
+  if (isfrozen) msg("Frozen nets only run the forward","Net.reset_grads");
+
   if (isrecurrent)
   if (rnet!=nullptr)
   rnet->reset_grads();
@@ -600,6 +665,8 @@ void Net::reset_grads()
 
 void Net::reset()
 {
+  if (isfrozen) return;  // no deltas nor states to clear
+
   if (isrecurrent)
   if (rnet!=nullptr)
   rnet->reset();
@@ -613,6 +680,8 @@ void Net::reset()
 
 void Net::update()
 {
+  if (isfrozen) msg("Frozen nets only run the forward","Net.update");
+
   if (isrecurrent) {
     if (rnet!=nullptr) {
       rnet->update();
@@ -636,6 +705,8 @@ void Net::update()
 
 void Net::delta()
 {
+  if (isfrozen) msg("Frozen nets only run the forward","Net.delta");
+
   if (isrecurrent) {
     if (rnet!=nullptr)
     rnet->run_snets(delta_t);
@@ -648,6 +719,8 @@ void Net::delta()
 //////////////////////////////////////////////////////////////
 //////// HIGHER LEVEL FUNCS
 void Net::fit(vtensor tin, vtensor tout, int batch, int epochs) {
+  if (isfrozen) msg("Frozen nets only run the forward","Net.fit");
+
   int i, j, k, n;
 
   if (isrecurrent) {
@@ -688,18 +761,15 @@ void Net::fit(vtensor tin, vtensor tout, int batch, int epochs) {
     // Set batch size
     resize(batch);
 
-
-    // Create array to store batch indices (later random)
-    vind sind;
-    for (i = 0; i < batch_size; i++)
-    sind.push_back(0);
-
+    // Every sample once per epoch, in shuffled order
+    Sampler sampler(n, batch_size, fit_drop_last, (unsigned int)rand());
+    if (fit_stratified) sampler.stratify(tout[0]);
 
     // Start training
     setmode(TRMODE);
 
     // Set some parameters
-    int num_batches = n / batch_size;
+    int num_batches = sampler.num_batches();
 
     // Train network
     fprintf(stdout, "%d epochs of %d batches of size %d\n", epochs, num_batches, batch_size);
@@ -709,26 +779,30 @@ void Net::fit(vtensor tin, vtensor tout, int batch, int epochs) {
 
       reset_loss();
 
-      // For each batch
-      for (j = 0; j < num_batches; j++) {
+      vector<vind> batches = sampler.epoch();
+      {
+        // The next batches are gathered while the current one is computed
+        BatchLoader loader(this, tin, tout, batches, fit_prefetch);
 
-        // Set random indices
-        for (k = 0; k < batch_size; k++) sind[k] = rand() % n;
+        // For each batch
+        for (j = 0; j < num_batches; j++) {
 
-        // Train batch
-        tr_batches++;
+          // Train batch
+          tr_batches++;
 
-        train_batch(tin, tout, sind);
-
-        print_loss(j+1);
-
-        high_resolution_clock::time_point e2 = high_resolution_clock::now();
-        duration<double> epoch_time_span = e2 - e1;
-        fprintf(stdout, "%1.3f secs/batch\r", epoch_time_span.count()/(j+1));
-        fflush(stdout);
+          BatchSlot *slot = loader.wait(j);
+          run_batch(slot->xs.data(), slot->ys.data());
+          loader.release(j);
 
+          print_loss(j+1);
 
+          high_resolution_clock::time_point e2 = high_resolution_clock::now();
+          duration<double> epoch_time_span = e2 - e1;
+          fprintf(stdout, "%1.3f secs/batch\r", epoch_time_span.count()/(j+1));
+          fflush(stdout);
+        }
       }
+
       high_resolution_clock::time_point e2 = high_resolution_clock::now();
       duration<double> epoch_time_span = e2 - e1;
       fprintf(stdout, "\n%1.3f secs/epoch\n", epoch_time_span.count());
@@ -784,14 +858,25 @@ void Net::prepare_recurrent(vtensor tin, vtensor tout, int &inl, int &outl, vten
   // prepare data for unroll net
   if (isencoder) {
     int offset;
+    // Left-pad the input sequences with zeros up to the bucket length,
+    // the last time steps stay aligned with the outputs
+    int pad=bucket_length(inl)-inl;
+    vtensor zeros;
     for(i=0;i<xt.size();i++) {
       offset=xt[i]->size/xt[i]->shape[0];
       vector<int>shape;
       for(j=1;j<xt[i]->ndim;j++)
         shape.push_back(xt[i]->shape[j]);
+      for(j=0;j<pad;j++) {
+        zeros.push_back(Tensor::zeros(shape,xt[i]->device));
+        tinr.push_back(zeros.back());
+      }
       for(j=0;j<inl;j++)
         tinr.push_back(new Tensor(shape,xt[i]->ptr+(j*offset),xt[i]->device));
     }
+    // released along with xt
+    for(i=0;i<zeros.size();i++) xt.push_back(zeros[i]);
+    inl+=pad;
   }
 
   if (isdecoder) {
@@ -850,9 +935,37 @@ void Net::fit_recurrent(vtensor tin, vtensor tout, int batch, int epochs) {
 // TODO:  train_batch_recurrent
 /////////////////////////////////////////
 void Net::train_batch(vtensor X, vtensor Y, vind sind, int eval) {
+  if (isfrozen) msg("Frozen nets only run the forward","Net::train_batch");
 
   if (batch_size!=sind.size()) resize(sind.size());
 
+  // Check indices
+  if (sind.size() == 0) msg("error void index","Net::train_batch");
+
+  gather_batch(X, Y, sind, Xs, Ys);
+  run_batch(Xs, Ys, eval);
+}
+
+void Net::set_sampling(bool stratified, bool drop_last, int prefetch) {
+  if (prefetch<0) msg("Invalid number of batches to prefetch","Net::set_sampling");
+
+  fit_stratified=stratified;
+  fit_drop_last=drop_last;
+  fit_prefetch=prefetch;
+}
+
+// Seeds the counter-based generator of the tensors (init, dropout, DA) and
+// rand(), used for the batch order of fit
+void Net::set_seed(int seed) {
+  if (seed<0) msg("Invalid seed","Net::set_seed");
+
+  set_rand_seed(seed);
+  srand(seed);
+}
+
+// Copy the samples sind of X and Y into the split buffers of each snet
+void Net::gather_batch(vtensor X, vtensor Y, vind sind, vtensor *xs, vtensor *ys) {
+
   int comp=snets.size();
 
   if (batch_size<comp) {
@@ -861,27 +974,34 @@ void Net::train_batch(vtensor X, vtensor Y, vind sind, int eval) {
 
   int thread_batch_size=batch_size / comp;
 
-  if (eval) setmode(TSMODE);
-  else setmode(TRMODE);
-
-  // Check indices
-  if (sind.size() == 0) msg("error void index","Net::train_batch");
-  // Split data for each network
   for (int i = 0; i < comp; i++) {
     int start = i * thread_batch_size;
-    int end = start + Xs[i][0]->shape[0];
+    int end = start + xs[i][0]->shape[0];
 
     // Copy samples
-    for (int j = 0; j < X.size(); j++) {
-      Tensor::select(X[j], Xs[i][j], sind, start, end);
-      Tensor::copy(Xs[i][j], snets[i]->lin[j]->input);
-    }
+    for (int j = 0; j < X.size(); j++)
+      Tensor::select(X[j], xs[i][j], sind, start, end);
 
     // Copy targets
-    for (int j = 0; j < Y.size(); j++) {
-      Tensor::select(Y[j], Ys[i][j], sind, start, end);
-      snets[i]->lout[j]->check_target();
-      Tensor::copy(Ys[i][j], snets[i]->lout[j]->target);
+    for (int j = 0; j < Y.size(); j++)
+      Tensor::select(Y[j], ys[i][j], sind, start, end);
+  }
+}
+
+void Net::run_batch(vtensor *xs, vtensor *ys, int eval) {
+
+  int comp=snets.size();
+
+  if (eval) setmode(TSMODE);
+  else setmode(TRMODE);
+
+  for (int i = 0; i < comp; i++) {
+    for (int j = 0; j < xs[i].size(); j++)
+      Tensor::copy(xs[i][j], snets[i]->lin[j]->input);
+
+    for (int j = 0; j < ys[i].size(); j++) {
+      snets[i]->lout[j]->check_target(ys[i][j]->shape);
+      Tensor::copy(ys[i][j], snets[i]->lout[j]->target);
 
       if (isdecoder) {
         if (eval) {
@@ -892,7 +1012,7 @@ void Net::train_batch(vtensor X, vtensor Y, vind sind, int eval) {
         }
         else {
           if (j==0) snets[i]->din[0]->input->fill_(0.0); //start
-          else Tensor::copy(Ys[i][j-1], snets[i]->din[j]->input);
+          else Tensor::copy(ys[i][j-1], snets[i]->din[j]->input);
         }
       }
     }
@@ -905,7 +1025,7 @@ void Net::train_batch(vtensor X, vtensor Y, vind sind, int eval) {
 
   if ((eval)&&(isdecoder))
     for (int i = 0; i < comp; i++)
-      for (int j = 1; j < Y.size(); j++)
+      for (int j = 1; j < ys[i].size(); j++)
          snets[i]->lout[j-1]->detach(snets[i]->din[j]);
 
   // If training (eval==0), apply gradients
@@ -927,6 +1047,7 @@ void Net::train_batch(vtensor X, vtensor Y, vind sind, int eval) {
 
 ///////////////////////////////////////////
 void Net::evaluate(vtensor tin, vtensor tout) {
+  if (isfrozen) msg("Frozen nets only run the forward","Net.evaluate");
 
   int i, j, k, n;
 
@@ -997,6 +1118,8 @@ void Net::evaluate_recurrent(vtensor tin, vtensor tout) {
 
   prepare_recurrent(tin,tout,inl,outl,xt,yt,tinr,toutr);
 
+  build_rnet(inl,outl);
+
   if ((isencoder)&&(isdecoder))
     rnet->evaluate(tinr,toutr);
   else if (isencoder)
@@ -1038,6 +1161,10 @@ vtensor Net::predict_recurrent(vtensor tin) {
 
   prepare_recurrent(tin,tout,inl,outl,xt,yt,tinr,toutr);
 
+  // decoders predict with the last unroll, its output length is not known here
+  if (!isdecoder) build_rnet(inl,outl);
+  else if (rnet==nullptr) msg("Error predict without previous fit","predict_recurrent");
+
   out=rnet->predict(tinr);
 
   for(int i=0;i<xt.size();i++)
@@ -1047,7 +1174,29 @@ vtensor Net::predict_recurrent(vtensor tin) {
   return out;
 }
 
-vtensor Net::predict(vtensor tin) {
+// View of the rows [start,end) of a CPU tensor
+static Tensor *rows_view(Tensor *A, int start, int end) {
+  vector<int> shape(A->shape);
+  shape[0]=end-start;
+  return new Tensor(shape, A->ptr+(long int)start*A->stride[0], A->device);
+}
+
+static void free_view(Tensor *A) {
+  A->ptr=nullptr; // data owned by the viewed tensor
+  delete A;
+}
+
+static void predict_copy_t(int start, vtensor &out, void *arg) {
+  vtensor *res=(vtensor *)arg;
+
+  for (int i = 0; i < out.size(); i++) {
+    Tensor *dst=rows_view((*res)[i], start, start+out[i]->shape[0]);
+    Tensor::copy(out[i], dst);
+    free_view(dst);
+  }
+}
+
+vtensor Net::predict(vtensor tin, int batch) {
   vtensor out;
 
   if (isrecurrent) {
@@ -1056,17 +1205,65 @@ vtensor Net::predict(vtensor tin) {
   else {
     cout<<"Predict "<<tin[0]->shape[0]<<" samples\n";
 
-    setmode(TSMODE);
+    // Preallocated outputs, filled chunk by chunk
+    for (int i = 0; i < lout.size(); i++) {
+      vector<int> shape(lout[i]->output->shape);
+      shape[0]=tin[0]->shape[0];
+      out.push_back(new Tensor(shape, DEV_CPU));
+    }
 
-    forward(tin);
+    // After build or load the net has a batch of 1: a larger default chunk
+    if (batch<=0) batch=max(batch_size, PREDICT_BATCH);
+    predict(tin, batch, predict_copy_t, &out);
 
-    for (int i = 0; i < lout.size(); i++) {
+    return out;
+  }
+
+}
+
+void Net::predict(vtensor tin, int batch, predict_callback F, void *arg) {
+  int i;
+
+  if (isrecurrent)
+    msg("Chunked predict is not available for recurrent nets","Net::predict");
+  if (tin.size()!=lin.size())
+    msg("size missmatch in list of tensors","Net::predict");
+  if (batch<=0)
+    msg("Invalid batch size","Net::predict");
+
+  int n=tin[0]->shape[0];
+  for (i = 0; i < tin.size(); i++) {
+    if (tin[i]->shape[0]!=n) msg("Input tensors with different number of samples","Net::predict");
+    if (!tin[i]->isCPU()) msg("Input tensors must be on CPU","Net::predict");
+  }
+
+  int bs=batch_size;
+  setmode(TSMODE);
+
+  vtensor chunk(tin.size());
+  vtensor out(lout.size());
+
+  // The net is only resized for the remainder batch
+  for (int start = 0; start < n; start += batch) {
+    int end = min(n, start + batch);
+
+    for (i = 0; i < tin.size(); i++)
+      chunk[i]=rows_view(tin[i], start, end);
+
+    forward(chunk);
+
+    for (i = 0; i < lout.size(); i++) {
       collectTensor(lout[i],"output");
-      out.push_back(lout[i]->output->clone());
+      out[i]=lout[i]->output;
     }
-    return out;
+
+    F(start, out, arg);
+
+    for (i = 0; i < tin.size(); i++)
+      free_view(chunk[i]);
   }
 
+  if (batch_size!=bs) resize(bs);
 }
 
 
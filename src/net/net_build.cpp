@@ -21,6 +21,7 @@
 #include "eddl/random.h"
 
 #include "eddl/layers/core/layer_core.h"
+#include "eddl/hardware/cpu/nn/cpu_tensor_nn.h"
 
 #ifdef cGPU
 #include "eddl/hardware/gpu/gpu_tensor.h"
@@ -178,6 +179,8 @@ void Net::build(Optimizer *opt, vloss lo, vmetrics me, CompServ *cs, bool initia
 
   if (isbuild) return;
 
+  // before any weight is initialized
+  if (cs->seed>=0) set_seed(cs->seed);
 
   for(int i=0;i<layers.size();i++) {
     if ((layers[i]->orig!=nullptr)&&(layers[i]->orig->net!=this)) {
@@ -205,6 +208,13 @@ void Net::build(Optimizer *opt, vloss lo, vmetrics me, CompServ *cs, bool initia
         cout << "Net running on FPGA " << snets[0]->dev - DEV_FPGA << "\n";
     }
   }
+  // Activations computed by their parent (net_fusion.cpp)
+  if (fusion) fuse_layers();
+
+  // Activation memory (net_memory.cpp)
+  plan_memory();
+  if (verbosity_level >= 1) cout << memory_summary();
+
   isbuild=true;
 
 }
@@ -246,9 +256,17 @@ void Net::build(Optimizer *opt, vloss lo, vmetrics me, bool initialize) {
     }
     else losses = vloss(lo);
 
+    softmax_cent.assign(lout.size(), false);
+    delta_ready.assign(lout.size(), false);
     for (int i = 0; i < lout.size(); i++) {
-        if (losses[i]->name == "soft_cross_entropy") lout[i]->delta_bp = 1;
-        lout[i]->target = new Tensor(lout[i]->output->getShape(), dev);
+        if (i >= losses.size()) continue;  // built without losses
+        if ((losses[i]->name == "soft_cross_entropy") || (losses[i]->name == "sparse_soft_cross_entropy")) {
+            lout[i]->delta_bp = 1;
+            // Softmax + soft_cross_entropy: loss and delta wrt the logits in one pass
+            auto *act = dynamic_cast<LActivation *>(lout[i]);
+            if ((act != nullptr) && (act->act == "softmax")) softmax_cent[i] = true;
+        }
+        lout[i]->target = new Tensor(losses[i]->target_shape(lout[i]->output->getShape()), dev);
     }
     // set metrics
     if (isdecoder) {
@@ -290,6 +308,7 @@ void Net::set_compserv(CompServ *cs){
 
                 Eigen::initParallel();
                 Eigen::setNbThreads(nthreads);
+                cpu_set_conv_workspace((long int)cs->conv_workspace_mb*1024*1024);
 
                 snets.push_back(this);
 
@@ -386,7 +405,7 @@ void Net::set_compserv(CompServ *cs){
       for (int j = 0; j < snets[i]->lin.size(); j++)
           Xs[i].push_back(new Tensor(snets[i]->lin[j]->input->shape));
       for (int j = 0; j < snets[i]->lout.size(); j++)
-          Ys[i].push_back(new Tensor(snets[i]->lout[j]->output->shape));
+          Ys[i].push_back(new Tensor(snets[i]->target_shape(j)));
     }
   }
 
@@ -475,6 +494,9 @@ void Net::resize(int b)
   batch_size=b;
   if (VERBOSE) cout<<"Resizing Net to batch_size="<<batch_size<<"\n";
 
+  // Planned buffers are given back before the layers resize theirs
+  release_memory_plan();
+
   int c=snets.size();
   int bs,m;
 
@@ -503,17 +525,30 @@ void Net::resize(int b)
         snets[i]->layers[j]->resize(bs);
       }
 
+    if (isfrozen) continue;  // no training batches
+
     for (j = 0; j < snets[i]->lin.size(); j++)
         Xs[i].push_back(new Tensor(snets[i]->lin[j]->input->shape));
 
     for (j = 0; j < snets[i]->lout.size(); j++)
-        Ys[i].push_back(new Tensor(snets[i]->lout[j]->output->shape));
+        Ys[i].push_back(new Tensor(snets[i]->target_shape(j)));
   }
 
+  // Buffer sizes follow the batch
+  plan_memory();
+
   reset();
 
 }
 
+// Shape of the targets of output i, as expected by its loss
+vector<int> Net::target_shape(int i)
+{
+  vector<int> shape=lout[i]->output->getShape();
+  if (i<losses.size()) return losses[i]->target_shape(shape);
+  return shape;
+}
+
 Layer * Net::getLayer(vlayer in)
 {
   int i,j,k,l,ind;
@@ -19,6 +19,7 @@
 #include <pthread.h>
 #include "eddl/utils.h"
 #include "eddl/random.h"
+#include "eddl/profiler.h"
 #include "eddl/layers/core/layer_core.h"
 
 #define VERBOSE 0
@@ -52,6 +53,7 @@ void Net::do_forward() {
   if (VERBOSE) {
     cout<<"START FORWARD\n";
   }
+  delta_ready.assign(lout.size(), false);
   for (int i = 0; i < vfts.size(); i++) {
     if (VERBOSE) {
       cout << vfts[i]->name << " Shape: ";
@@ -59,7 +61,10 @@ void Net::do_forward() {
       fprintf(stdout, "  %s In[%d,%s]:%f\n", vfts[i]->name.c_str(), j, vfts[i]->parent[j]->name.c_str(),vfts[i]->parent[j]->output->sum());
     }
 
-    vfts[i]->forward();
+    {
+      ProfScope prof(vfts[i]->name, PROF_FORWARD);
+      vfts[i]->forward();
+    }
     if (VERBOSE) {
       fprintf(stdout, "  %s Out:%f\n", vfts[i]->name.c_str(), vfts[i]->output->sum());
     }
@@ -82,16 +87,23 @@ void Net::do_backward() {
     // Reserve parent's delta (if reserved, ignored)
     vbts[i]->mem_delta_parent();
 
+    // Planned deltas becoming live here hold data of earlier ones
+    if (delta_arena != nullptr)
+      for (Tensor *d : delta_zero[i]) d->fill_(0.0);
+
     // Do backward
     if (VERBOSE) {
       cout << "backward "<<vbts[i]->name << " delta="<<vbts[i]->delta->sum()<<"\n";
     }
 
-    vbts[i]->backward();
+    {
+      ProfScope prof(vbts[i]->name, PROF_BACKWARD);
+      vbts[i]->backward();
+    }
 
 
-    // Delete this delta
-    if(vbts[i]->mem_level) { vbts[i]->free_delta(); }
+    // Delete this delta (planned deltas keep their place in the arena)
+    if((vbts[i]->mem_level) && (delta_arena == nullptr)) { vbts[i]->free_delta(); }
   }
   if (VERBOSE) {
     cout<<"END BACKWARD\n";
@@ -105,6 +117,10 @@ void Net::do_delta() {
     getchar();
   }
   for (int i = 0; i < lout.size(); i++) {
+    if ((i < delta_ready.size()) && delta_ready[i]) {
+      delta_ready[i] = false;
+      continue;
+    }
     lout[i]->mem_delta();
     if (losses.size()>=(i+1)) {
       losses[i]->delta(lout[i]->target, lout[i]->output, lout[i]->delta);
@@ -126,8 +142,15 @@ void Net::do_compute_loss() {
   int p = 0;
   for (int i = 0; i < lout.size(); i++, p += 2) {
     // loss value
-    if (losses.size()>=(i+1))
-    fiterr[p] = losses[i]->value(lout[i]->target, lout[i]->output);
+    if (losses.size()>=(i+1)) {
+      if ((i < softmax_cent.size()) && softmax_cent[i] && (lout[i]->mode == TRMODE)) {
+        // training: the delta comes out of the same pass, do_delta skips it
+        lout[i]->mem_delta();
+        fiterr[p] = losses[i]->value_delta(lout[i]->target, lout[i]->output, lout[i]->delta);
+        delta_ready[i] = true;
+      }
+      else fiterr[p] = losses[i]->value(lout[i]->target, lout[i]->output);
+    }
     // metric value
     if (metrics.size()>=(i+1))
     fiterr[p + 1] = metrics[i]->value(lout[i]->target, lout[i]->output);
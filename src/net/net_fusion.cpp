@@ -0,0 +1,177 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.7
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: April 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+
+#include <cmath>
+#include <map>
+#include <set>
+#include "eddl/net/net.h"
+#include "eddl/utils.h"
+#include "eddl/layers/core/layer_core.h"
+#include "eddl/layers/conv/layer_conv.h"
+#include "eddl/layers/normalization/layer_normalization.h"
+
+using namespace std;
+
+
+/////////////////////////////////////////
+//// LAYER FUSION (CPU)
+/////////////////////////////////////////
+// Layers are not removed from the graph: the fused ones share the output
+// (and delta) buffer of the layer computing them and do nothing in their
+// forward and backward, so summaries, plots, save/load and the ONNX export
+// still see the original net.
+
+// Epilogue computing the activation, EPI_NONE if there is none
+static int epilogue_act(LActivation *a) {
+    if (a->act == "relu") return EPI_RELU;
+    // the derivative is computed from the output: it needs the sign of the input
+    if ((a->act == "leaky_relu") && (a->params[0] >= 0.0f)) return EPI_LEAKY_RELU;
+    if (a->act == "sigmoid") return EPI_SIGMOID;
+    if (a->act == "tanh") return EPI_TANH;
+    return EPI_NONE;
+}
+
+// Conv or Dense layer whose bias can be followed by an epilogue
+static bool has_epilogue(Layer *l) {
+    auto *conv = dynamic_cast<LConv *>(l);
+    if (conv != nullptr) return conv->cd->act == EPI_NONE;
+    auto *dense = dynamic_cast<LDense *>(l);
+    if (dense != nullptr) return dense->act == EPI_NONE;
+    return false;
+}
+
+// The layer l takes the output buffer of p, as well as the layers viewing it
+static void share_output(Net *net, Layer *l, Layer *p) {
+    float *old = l->output->ptr;
+    l->output->deleteData();
+    for (Layer *v : net->layers)
+        if ((v != l) && (v->output != nullptr) && (v->output->ptr == old)) {
+            v->output->ptr = nullptr;
+            v->output->updateData(p->output->ptr);
+        }
+    l->output->updateData(p->output->ptr);
+}
+
+
+// Activations after a Conv or Dense layer (or a batchnorm folded into it) are
+// applied by the layer along with its bias, while the output is still in
+// cache. The backward of the layer starts by the derivative of the activation,
+// taken from the output, as the activation layer did.
+void Net::fuse_layers() {
+    if ((dev != DEV_CPU) || isrecurrent || (snets.size() != 1) || (snets[0] != this) || (!mnets.empty())) return;
+
+    set<Layer *> ends(lin.begin(), lin.end());
+    ends.insert(lout.begin(), lout.end());
+    map<float *, int> users;
+    for (Layer *l : layers) if (l->output != nullptr) users[l->output->ptr]++;
+
+    for (Layer *l : vfts) {
+        auto *a = dynamic_cast<LActivation *>(l);
+        if ((a == nullptr) || a->fused || a->inplace || a->isshared || ends.count(a) || (a->parent.size() != 1)) continue;
+        int act = epilogue_act(a);
+        if (act == EPI_NONE) continue;
+
+        // Through the folded batchnorms, to the layer computing them
+        Layer *p = a->parent[0];
+        int chain = 0;
+        bool ok = true;
+        while (true) {
+            auto *bn = dynamic_cast<LBatchNorm *>(p);
+            if (bn == nullptr) break;
+            if ((!bn->folded) || (bn->child.size() != 1) || ends.count(bn)) {
+                ok = false;
+                break;
+            }
+            p = bn->parent[0];
+            chain++;
+        }
+        if ((!ok) || (!has_epilogue(p)) || (p->child.size() != 1) || ends.count(p) || p->isshared) continue;
+        if ((users[p->output->ptr] != 1 + chain) || (!Tensor::sameShape(p->output, a->output))) continue;
+
+        float param = (act == EPI_LEAKY_RELU) ? a->params[0] : 0.0f;
+        auto *conv = dynamic_cast<LConv *>(p);
+        if (conv != nullptr) {
+            conv->cd->act = act;
+            conv->cd->act_param = param;
+        }
+        else {
+            auto *dense = dynamic_cast<LDense *>(p);
+            dense->act = act;
+            dense->act_param = param;
+        }
+
+        // Own delta (if any) given back, the next one is a view of the parent's
+        a->free_delta();
+        a->fused = true;
+        share_output(this, a, p);
+        users[p->output->ptr]++;
+    }
+}
+
+
+// Inference: the batchnorm right after a Conv or Dense layer is folded into
+// its weights and bias, w' = w*s and b' = (b-mean)*s + beta with
+// s = gamma/sqrt(var+eps), so the normalization costs nothing.
+void Net::fold_batchnorm() {
+    set<Layer *> ends(lin.begin(), lin.end());
+    ends.insert(lout.begin(), lout.end());
+    map<float *, int> users;
+    for (Layer *l : layers) if (l->output != nullptr) users[l->output->ptr]++;
+
+    for (Layer *l : vfts) {
+        auto *bn = dynamic_cast<LBatchNorm *>(l);
+        if ((bn == nullptr) || bn->folded || bn->isshared || ends.count(bn) || (bn->parent.size() != 1)) continue;
+        Layer *p = bn->parent[0];
+        if ((!has_epilogue(p)) || (p->child.size() != 1) || ends.count(p) || p->isshared) continue;
+        if ((users[p->output->ptr] != 1) || (users[bn->output->ptr] != 1)) continue;
+
+        int z = bn->mean->size;
+        vector<float> s(z), t(z);
+        for (int j = 0; j < z; j++) {
+            float g = bn->affine ? bn->bn_g->ptr[j] : 1.0f;
+            float beta = bn->affine ? bn->bn_b->ptr[j] : 0.0f;
+            s[j] = g / sqrtf(bn->variance->ptr[j] + bn->epsilon);
+            t[j] = beta - bn->mean->ptr[j] * s[j];
+        }
+
+        auto *conv = dynamic_cast<LConv *>(p);
+        if (conv != nullptr) {
+            // K is {nk, kz, kr, kc}: one block per output channel
+            ConvolDescriptor *cd = conv->cd;
+            long int ksize = cd->K->size / cd->nk;
+            for (int j = 0; j < z; j++) {
+                float *k = cd->K->ptr + j * ksize;
+                for (long int i = 0; i < ksize; i++) k[i] *= s[j];
+                cd->bias->ptr[j] = (cd->use_bias ? cd->bias->ptr[j] * s[j] : 0.0f) + t[j];
+            }
+            cd->use_bias = true;
+            cd->valid_U = false;
+        }
+        else {
+            // W is {in, ndim}: one column per output
+            auto *dense = dynamic_cast<LDense *>(p);
+            if (!dense->use_bias) {
+                dense->bias = Tensor::zeros({dense->ndim}, dense->dev);
+                dense->params.push_back(dense->bias);
+                dense->use_bias = true;
+            }
+            float *w = dense->W->ptr;
+            for (int i = 0; i < dense->W->shape[0]; i++)
+                for (int j = 0; j < z; j++) w[(long int) i * z + j] *= s[j];
+            for (int j = 0; j < z; j++) dense->bias->ptr[j] = dense->bias->ptr[j] * s[j] + t[j];
+        }
+
+        bn->opa->deleteData();
+        bn->folded = true;
+        share_output(this, bn, p);
+        users[p->output->ptr]++;
+        isfolded = true;
+    }
+}
@@ -0,0 +1,385 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.7
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: April 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include "eddl/net/net.h"
+#include "eddl/utils.h"
+#include "eddl/layers/core/layer_core.h"
+
+using namespace std;
+
+
+/////////////////////////////////////////
+//// ACTIVATION MEMORY PLAN
+/////////////////////////////////////////
+// Schedule of a training step: forward of vfts[i] at step i, losses and
+// output deltas at step vfts.size(), backward of vbts[i] at vfts.size()+1+i.
+//
+// Outputs are planned for the forward schedule only (inference): in training
+// every output is still needed by the backward. Deltas live from the first
+// backward that writes them (a child, or the loss) until the backward of their
+// layer, so deltas of different branches and depths share storage.
+//
+// The delta plan is applied with mem_level > 0, where deltas are not kept
+// after the backward anyway: all of them are created once as views of one
+// arena, and cleared when they become live instead of being reallocated.
+//
+// Frozen nets (see freeze()) have no deltas; their outputs are planned for the
+// forward schedule and moved to an arena of their own.
+
+static bool in_arena(float *p, float *arena, long size) {
+    return (arena != nullptr) && (p >= arena) && (p < arena + size);
+}
+
+// Frees the delta of a layer as free_delta does, also for inputs, which keep
+// theirs there (so it can be copied to the net they are fed from)
+static void drop_delta(Layer *l) {
+    if (dynamic_cast<LInput *>(l) != nullptr) {
+        delete l->delta;
+        l->delta = nullptr;
+    }
+    else l->free_delta();
+}
+
+// Deltas can only be placed in an arena of this net when the whole graph
+// belongs to it and no layer keeps deltas across time steps
+static bool shares_deltas(Net *net, set<Layer *> &inside) {
+    if ((net->mem_level == 0) || (net->dev != DEV_CPU) || (net->isrecurrent)) return false;
+    if ((net->snets.size() != 1) || (net->snets[0] != net) || (!net->mnets.empty())) return false;
+    for (Layer *l : net->layers) {
+        if (l->isrecurrent) return false;
+        for (Layer *p : l->parent) if (!inside.count(p)) return false;
+        for (Layer *c : l->child) if (!inside.count(c)) return false;
+    }
+    return true;
+}
+
+// Output buffers of a frozen net that can be moved to the arena, grouped by
+// storage. Inputs, outputs and layers without parents (constants) keep their
+// data; buffers also seen at an offset (partial views) are left alone.
+static vector<vlayer> arena_outputs(Net *net, set<Layer *> &fixed) {
+    map<float *, int> group;
+    vector<vlayer> groups;
+    for (Layer *l : net->vfts) {
+        if ((l->output == nullptr) || (l->output->ptr == nullptr)) continue;
+        auto it = group.find(l->output->ptr);
+        if (it == group.end()) {
+            group[l->output->ptr] = groups.size();
+            groups.push_back({l});
+        }
+        else groups[it->second].push_back(l);
+    }
+
+    vector<bool> movable(groups.size(), true);
+    for (int g = 0; g < groups.size(); g++) {
+        float *p = groups[g][0]->output->ptr;
+        long size = 0;
+        for (Layer *l : groups[g]) {
+            if (fixed.count(l) || l->parent.empty()) movable[g] = false;
+            size = max(size, (long) l->output->size);
+        }
+        for (auto &q : group)
+            if ((q.first != p) && (q.first < p + size) && (p < q.first + groups[q.second][0]->output->size)) {
+                movable[g] = false;
+                movable[q.second] = false;
+            }
+    }
+
+    vector<vlayer> out;
+    for (int g = 0; g < groups.size(); g++)
+        if (movable[g]) out.push_back(groups[g]);
+    return out;
+}
+
+
+void Net::plan_memory() {
+    release_memory_plan();
+    output_plan = MemPlan();
+    delta_plan = MemPlan();
+    if ((dev != DEV_CPU) || isrecurrent) return;
+
+    set<Layer *> inside(layers.begin(), layers.end());
+    set<Layer *> outputs(lout.begin(), lout.end());
+    set<Layer *> ends(lin.begin(), lin.end());
+    ends.insert(lout.begin(), lout.end());
+
+    int F = vfts.size();
+    map<Layer *, int> fpos, bpos;
+    for (int i = 0; i < vfts.size(); i++) fpos[vfts[i]] = i;
+    for (int i = 0; i < vbts.size(); i++) bpos[vbts[i]] = F + 1 + i;
+
+    // Inputs, outputs and layers feeding other nets are kept after the step
+    auto kept = [&](Layer *l) {
+        if (ends.count(l)) return true;
+        for (Layer *c : l->child) if (!inside.count(c)) return true;
+        return false;
+    };
+
+    // Frozen nets only run the forward
+    if (isfrozen) {
+        if (output_groups.empty()) {
+            set<Layer *> fixed;
+            for (Layer *l : layers) if (kept(l)) fixed.insert(l);
+            output_groups = arena_outputs(this, fixed);
+        }
+
+        for (vlayer &g : output_groups) {
+            int start = MEM_KEEP, end = 0;
+            long size = 0;
+            for (Layer *l : g) {
+                start = min(start, fpos[l]);
+                end = max(end, fpos[l]);
+                for (Layer *c : l->child) if (fpos.count(c)) end = max(end, fpos[c]);
+                size = max(size, (long) l->output->size);
+            }
+            output_plan.add(size, start, end);
+        }
+        output_plan.place();
+
+        // Storage of their own (or of their in-place parent) is given back
+        output_arena = get_fmem(max(output_plan.peak, 1L), "Net::plan_memory");
+        set<float *> freed;
+        for (int g = 0; g < output_groups.size(); g++)
+            for (Layer *l : output_groups[g]) {
+                float *old = l->output->ptr;
+                if ((old != nullptr) && (!freed.count(old))) {
+                    free_fmem(old);
+                    freed.insert(old);
+                }
+                l->output->ptr = nullptr;
+                l->output->updateData(output_arena + output_plan.blocks[g].offset);
+            }
+        return;
+    }
+
+    // Outputs. Views (reshape) share the buffer of their parent.
+    map<float *, MemBlock> outs;
+    vector<float *> order;
+    for (Layer *l : vfts) {
+        int end = fpos[l];
+        for (Layer *c : l->child) if (inside.count(c)) end = max(end, fpos[c]);
+        if (kept(l)) end = MEM_KEEP;
+
+        float *p = l->output->ptr;
+        if (!outs.count(p)) {
+            order.push_back(p);
+            outs[p] = {(long) l->output->size, fpos[l], end, 0};
+        } else {
+            MemBlock &b = outs[p];
+            b.size = max(b.size, (long) l->output->size);
+            b.end = max(b.end, end);
+        }
+    }
+    for (float *p : order) output_plan.add(outs[p].size, outs[p].start, outs[p].end);
+    output_plan.place();
+
+    // Deltas are created by the layers themselves (some alias the delta of
+    // their parent), so the buffers are found once by creating all of them
+    if (delta_groups.empty()) {
+        set<Layer *> had;
+        for (Layer *l : layers) if (l->delta != nullptr) had.insert(l);
+        for (Layer *l : vbts) l->mem_delta();
+
+        map<float *, int> group;
+        for (Layer *l : vbts) {
+            if ((l->delta == nullptr) || (l->delta->ptr == nullptr) || (l->output->size == 0)) continue;
+            auto it = group.find(l->delta->ptr);
+            if (it == group.end()) {
+                group[l->delta->ptr] = delta_groups.size();
+                delta_groups.push_back({l});
+                delta_ratio.push_back((double) l->delta->size / l->output->size);
+            }
+            else delta_groups[it->second].push_back(l);
+        }
+
+        for (Layer *l : vbts) if (!had.count(l)) drop_delta(l);
+    }
+
+    for (int g = 0; g < delta_groups.size(); g++) {
+        int start = MEM_KEEP, end = 0;
+        bool keep = false;
+        for (Layer *l : delta_groups[g]) {
+            if (outputs.count(l)) start = min(start, F);
+            for (Layer *c : l->child) if (inside.count(c)) start = min(start, bpos[c]);
+            end = max(end, bpos[l]);
+            keep = keep || kept(l);
+        }
+        if (start == MEM_KEEP) start = end;  // not written by any other layer
+        if (keep) end = MEM_KEEP;
+        long size = lround(delta_ratio[g] * delta_groups[g][0]->output->size);
+        delta_plan.add(size, start, end);
+    }
+    delta_plan.place();
+
+    if (!shares_deltas(this, inside)) return;
+
+    // Apply: the deltas are created in backward order and moved to the arena
+    // right away, so at most one of them lives outside it at a time
+    delta_arena = get_fmem(max(delta_plan.peak, 1L), "Net::plan_memory");
+    memset(delta_arena, 0, max(delta_plan.peak, 1L) * sizeof(float));
+
+    map<Layer *, int> lgroup;
+    for (int g = 0; g < delta_groups.size(); g++)
+        for (Layer *l : delta_groups[g]) lgroup[l] = g;
+
+    for (Layer *l : vbts) {
+        l->mem_delta();
+
+        for (Layer *m : layers) {
+            if ((m->delta == nullptr) || (!lgroup.count(m))) continue;
+            float *old = m->delta->ptr;
+            if (in_arena(old, delta_arena, delta_plan.peak)) continue;
+
+            MemBlock &b = delta_plan.blocks[lgroup[m]];
+            if (m->delta->size > b.size) msg("Delta of " + m->name + " larger than planned", "Net::plan_memory");
+            float *p = delta_arena + b.offset;
+            for (Layer *v : layers)
+                if ((v->delta != nullptr) && (v->delta->ptr == old)) {
+                    v->delta->ptr = nullptr;
+                    v->delta->updateData(p);
+                }
+            free_fmem(old);
+        }
+    }
+
+    delta_zero.assign(vbts.size(), vtensor());
+    for (int g = 0; g < delta_groups.size(); g++) {
+        // Output deltas are written by the loss, or copied from another net
+        bool zero = true;
+        for (Layer *l : delta_groups[g]) if (outputs.count(l)) zero = false;
+        int start = delta_plan.blocks[g].start;
+        if (zero && (start > F) && (delta_groups[g][0]->delta != nullptr)) delta_zero[start - F - 1].push_back(delta_groups[g][0]->delta);
+    }
+}
+
+
+void Net::release_memory_plan() {
+    if (output_arena != nullptr) {
+        // Layers get storage of their own again when they are resized
+        for (Layer *l : layers)
+            if ((l->output != nullptr) && in_arena(l->output->ptr, output_arena, output_plan.peak))
+                l->output->ptr = nullptr;
+        free_fmem(output_arena);
+        output_arena = nullptr;
+    }
+
+    if (delta_arena == nullptr) return;
+
+    // Layers free their deltas as usual, without the storage of the arena
+    for (Layer *l : layers)
+        if ((l->delta != nullptr) && in_arena(l->delta->ptr, delta_arena, delta_plan.peak))
+            l->delta->ptr = nullptr;
+    for (Layer *l : layers) drop_delta(l);
+
+    free_fmem(delta_arena);
+    delta_arena = nullptr;
+    delta_zero.clear();
+}
+
+
+/////////////////////////////////////////
+//// FROZEN NETS
+/////////////////////////////////////////
+// Inference only: gradients, deltas, targets and the optimizer are released,
+// batchnorms are folded into the Conv/Dense layer before them, other
+// elementwise activations overwrite the output of their parent when nothing
+// else reads it, and the rest of the outputs share one arena. The forward runs
+// on the calling thread, without the reset of the training step.
+void Net::freeze() {
+    if (isfrozen) return;
+    if (!isbuild) msg("Net is not build", "Net::freeze");
+    if ((dev != DEV_CPU) || isrecurrent || (snets.size() != 1) || (snets[0] != this) || (!mnets.empty()))
+        msg("Only non-recurrent nets on one CPU computing service can be frozen", "Net::freeze");
+
+    release_memory_plan();
+    delta_groups.clear();
+    delta_ratio.clear();
+
+    for (Layer *l : layers) {
+        drop_delta(l);
+        for (Tensor *g : l->gradients) g->deleteData();
+        for (Tensor *g : l->acc_gradients) g->deleteData();
+        if (l->target != nullptr) {
+            delete l->target;
+            l->target = nullptr;
+        }
+    }
+    delete optimizer;
+    optimizer = nullptr;
+
+    for (Tensor *t : Xs[0]) delete t;
+    for (Tensor *t : Ys[0]) delete t;
+    Xs[0].clear();
+    Ys[0].clear();
+
+    setmode(TSMODE);
+
+    // Batchnorms folded into the weights, activations into the epilogues
+    fold_batchnorm();
+    if (fusion) fuse_layers();
+
+    // In-place activations: the parent feeds only them and neither buffer is
+    // seen by any other layer (views, inputs or outputs of the net). Outputs
+    // keep their own storage, which the arena does not manage
+    set<Layer *> ends(lin.begin(), lin.end());
+    ends.insert(lout.begin(), lout.end());
+    map<float *, int> users;
+    for (Layer *l : layers) if (l->output != nullptr) users[l->output->ptr]++;
+
+    for (Layer *l : vfts) {
+        auto *a = dynamic_cast<LActivation *>(l);
+        if ((a == nullptr) || (a->act == "softmax") || (a->parent.size() != 1) || ends.count(a)) continue;
+        Layer *p = a->parent[0];
+        if ((p->child.size() != 1) || ends.count(p) || p->parent.empty()) continue;
+        if ((users[p->output->ptr] != 1) || (users[a->output->ptr] != 1)) continue;
+        if ((a->input != p->output) || (!Tensor::sameShape(p->output, a->output))) continue;
+
+        users.erase(a->output->ptr);
+        a->output->deleteData();
+        a->output->updateData(p->output->ptr);
+        a->inplace = true;
+    }
+
+    isfrozen = true;
+    output_groups.clear();
+    plan_memory();
+    if (verbosity_level >= 1) cout << memory_summary();
+}
+
+
+string Net::memory_summary() {
+    std::stringstream ss;
+    long fsize = sizeof(float);
+    long otrain = output_plan.naive;
+
+    ss << "---------------------------------------------------------" << endl;
+    ss << "Activation memory, batch " << batch_size << endl;
+    ss << "---------------------------------------------------------" << endl;
+    ss << setw(12) << left << "" << setw(14) << left << "naive" << "planned" << endl;
+    ss << setw(12) << left << "Inference" << setw(14) << left << bytes2human(output_plan.naive * fsize)
+       << bytes2human(output_plan.peak * fsize) << endl;
+    ss << setw(12) << left << "Deltas" << setw(14) << left << bytes2human(delta_plan.naive * fsize)
+       << bytes2human(delta_plan.peak * fsize) << endl;
+    ss << setw(12) << left << "Training" << setw(14) << left << bytes2human((otrain + delta_plan.naive) * fsize)
+       << bytes2human((otrain + delta_plan.peak) * fsize) << endl;
+    if (isfrozen)
+        ss << "Frozen: no deltas, " << output_groups.size() << " outputs share one arena (inputs and outputs apart)" << endl;
+    else
+        ss << "Deltas " << ((delta_arena != nullptr) ? "share one arena" : "not shared (full_mem or multi-device)") << endl;
+    ss << "---------------------------------------------------------" << endl;
+
+    return ss.str();
+}
@@ -455,6 +455,27 @@ return rnet;
 //////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////
 
+void Net::set_rnet_cache(int size, int bucket) {
+  if (size<1) msg("The unrolled nets cache must keep at least one net","Net::set_rnet_cache");
+  if (bucket<1) msg("Invalid sequence length bucket","Net::set_rnet_cache");
+
+  rnet_cache_size=size;
+  rnet_bucket=bucket;
+
+  // Drop the least recently used unrolls that no longer fit
+  while (rnets.size()>rnet_cache_size) {
+    if (rnets.back()==rnet) rnet=nullptr;
+    collect_loss(rnets.back());
+    delete rnets.back();
+    rnets.pop_back();
+  }
+}
+
+int Net::bucket_length(int l) {
+  if (rnet_bucket<=1) return l;
+  return ((l+rnet_bucket-1)/rnet_bucket)*rnet_bucket;
+}
+
 void Net::build_rnet(int inl,int outl) {
   int i, j, k, n;
   int todev;
@@ -463,15 +484,31 @@ void Net::build_rnet(int inl,int outl) {
   else if (cs->local_fpgas.size() > 0) todev = DEV_FPGA;
   else todev = DEV_CPU;
 
-  if ((rnet==nullptr)||(inl!=rnet->lin.size())) {
+  // Look for a previous unroll with the same lengths and move it to the front
+  for(i=0;i<rnets.size();i++)
+    if ((rnets[i]->rinl==inl)&&(rnets[i]->routl==outl)) break;
 
-   if (rnet!=nullptr) delete rnet;
+  if (i<rnets.size()) {
+    rnet=rnets[i];
+    rnets.erase(rnets.begin()+i);
+    rnets.insert(rnets.begin(),rnet);
+  }
+  else {
+   // Evict the least recently used unroll, its errors are kept in the totals
+   if (rnets.size()>=rnet_cache_size) {
+     collect_loss(rnets.back());
+     delete rnets.back();
+     rnets.pop_back();
+   }
 
    // Create an unrolled version on CPU
    if ((isencoder)&&(isdecoder)) rnet=unroll_enc_dec(inl,outl);
    else if (!isdecoder) rnet=unroll_enc(inl,outl);
    else rnet=unroll_dec(inl,outl);
 
+   rnet->rinl=inl;
+   rnet->routl=outl;
+   rnets.insert(rnets.begin(),rnet);
 
    for(i=0;i<rnet->layers.size();i++) {
      rnet->layers[i]->isrecurrent=false;
@@ -482,8 +519,6 @@ void Net::build_rnet(int inl,int outl) {
    rnet->isdecoder=isdecoder;
    rnet->isencoder=isencoder;
 
-   rnet->plot("rmodel.pdf","LR");
-
    vloss lr;
    for(i=0;i<losses.size();i++) lr.push_back(losses[i]->clone());
 
@@ -493,15 +528,9 @@ void Net::build_rnet(int inl,int outl) {
    rnet->name="rnet";
 
    rnet->build(optimizer->share(),lr,mr,cs->share(),false);
-   //cout<<rnet->summary();
    fflush(stdout);
-   rnet->plot("rmodel.pdf","LR");
    rnet->name="rnet";
 
-
-   //getchar();
-   //cout<<rnet->summary();
-
    if (todev!=DEV_CPU) {
      // unroll CS devices and link
      for(i=0;i<rnet->snets.size();i++)
@@ -527,7 +556,6 @@ void Net::build_rnet(int inl,int outl) {
        rnet->snets[i]->isrecurrent=false;
 
        rnet->snets[i]->build(snets[i]->optimizer->share(),lr,mr,false);
-       rnet->snets[i]->plot("rsnet.pdf","LR");
        for(j=0;j<rnet->snets[i]->layers.size();j++) {
              rnet->snets[i]->layers[j]->orig=rnet->layers[j];
              rnet->snets[i]->layers[j]->net=rnet;
@@ -535,14 +563,13 @@ void Net::build_rnet(int inl,int outl) {
       }
     }
 
-   rnet->flog_tr=flog_tr;
-   rnet->flog_ts=flog_ts;
-
    rnet->reset_loss();
    rnet->reset();
    rnet->reset_grads();
 
    fflush(stdout);
-
   }
+
+  rnet->flog_tr=flog_tr;
+  rnet->flog_ts=flog_ts;
 }
@@ -0,0 +1,232 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.7
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: April 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <cstdio>
+#include <string>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+#include "eddl/net/sampler.h"
+#include "eddl/net/net.h"
+#include "eddl/utils.h"
+
+
+////////////////////////////////////
+///// SAMPLER
+////////////////////////////////////
+
+Sampler::Sampler(int n, int batch, bool drop_last, unsigned int seed) : gen(seed) {
+    if (batch < 1) msg("Invalid batch size", "Sampler::Sampler");
+
+    this->n = n;
+    this->batch = batch;
+    this->drop_last = drop_last;
+    this->nclasses = 0;
+}
+
+void Sampler::stratify(Tensor *Y) {
+    if ((Y->ndim != 2) || (Y->shape[0] != n))
+        msg("Stratified sampling needs one-hot targets of shape (samples, classes) or class indices (samples, 1)", "Sampler::stratify");
+
+    Tensor *Yc = Y;
+    if (!Y->isCPU()) {
+        Yc = Y->clone();
+        Yc->toCPU();
+    }
+
+    labels.resize(n);
+    if (Y->shape[1] == 1) {
+        // class indices
+        nclasses = 0;
+        for (int i = 0; i < n; i++) {
+            labels[i] = (int) Yc->ptr[i];
+            if (labels[i] < 0) msg("Negative class index", "Sampler::stratify");
+            nclasses = std::max(nclasses, labels[i] + 1);
+        }
+    }
+    else {
+        nclasses = Y->shape[1];
+        for (int i = 0; i < n; i++) {
+            float *row = Yc->ptr + i * nclasses;
+            labels[i] = (int) (std::max_element(row, row + nclasses) - row);
+        }
+    }
+
+    if (Yc != Y) delete Yc;
+}
+
+int Sampler::num_batches() {
+    if (drop_last) return n / batch;
+    return (n + batch - 1) / batch;
+}
+
+vector<vector<int>> Sampler::epoch() {
+    vector<int> perm(n);
+
+    if (labels.empty()) {
+        std::iota(perm.begin(), perm.end(), 0);
+        std::shuffle(perm.begin(), perm.end(), gen);
+    }
+    else {
+        // Shuffle each class and interleave them by the relative position of
+        // every sample inside its class, so each batch keeps the class ratios
+        vector<vector<int>> byclass(nclasses);
+        for (int i = 0; i < n; i++) byclass[labels[i]].push_back(i);
+
+        std::uniform_real_distribution<double> jitter(0.0, 1.0);
+        vector<pair<double, int>> keys;
+        keys.reserve(n);
+        for (auto &c : byclass) {
+            std::shuffle(c.begin(), c.end(), gen);
+            for (int k = 0; k < c.size(); k++)
+                keys.push_back(make_pair((k + jitter(gen)) / c.size(), c[k]));
+        }
+        std::sort(keys.begin(), keys.end());
+        for (int i = 0; i < n; i++) perm[i] = keys[i].second;
+    }
+
+    vector<vector<int>> batches(num_batches());
+    for (int b = 0; b < batches.size(); b++) {
+        int start = b * batch;
+        int end = std::min(n, start + batch);
+        batches[b].assign(perm.begin() + start, perm.begin() + end);
+
+        // Complete the last batch with the first samples of the (shuffled) epoch
+        for (int k = 0; batches[b].size() < batch; k++) batches[b].push_back(perm[k % n]);
+    }
+    return batches;
+}
+
+
+////////////////////////////////////
+///// BATCH LOADER
+////////////////////////////////////
+
+BatchLoader::BatchLoader(Net *net, const vector<Tensor *> &X, const vector<Tensor *> &Y,
+                         const vector<vector<int>> &batches, int ahead) {
+    if (ahead < 0) msg("Invalid number of batches to prefetch", "BatchLoader::BatchLoader");
+
+    this->net = net;
+    this->X = X;
+    this->Y = Y;
+    this->batches = batches;
+    this->nbatches = batches.size();
+    this->ahead = ahead;
+    gathered = 0;
+    released = 0;
+    stopping = false;
+
+    // One slot being computed plus the ones gathered ahead
+    int comp = net->snets.size();
+    slots.resize(ahead + 1);
+    for (auto &s : slots) {
+        s.xs.resize(comp);
+        s.ys.resize(comp);
+        for (int i = 0; i < comp; i++) {
+            for (auto *t : net->Xs[i]) s.xs[i].push_back(new Tensor(t->shape));
+            for (auto *t : net->Ys[i]) s.ys[i].push_back(new Tensor(t->shape));
+        }
+    }
+
+    pthread_mutex_init(&mutex, nullptr);
+    pthread_cond_init(&cond_ready, nullptr);
+    pthread_cond_init(&cond_free, nullptr);
+
+    if (ahead > 0) {
+        int rc = pthread_create(&thread, nullptr, BatchLoader::loader_main, (void *) this);
+        if (rc) throw std::runtime_error("unable to create loader thread " + std::to_string(rc));
+    }
+}
+
+BatchLoader::~BatchLoader() {
+    if (ahead > 0) {
+        pthread_mutex_lock(&mutex);
+        stopping = true;
+        pthread_cond_broadcast(&cond_free);
+        pthread_mutex_unlock(&mutex);
+
+        pthread_join(thread, nullptr);
+    }
+
+    pthread_cond_destroy(&cond_free);
+    pthread_cond_destroy(&cond_ready);
+    pthread_mutex_destroy(&mutex);
+
+    for (auto &s : slots) {
+        for (auto &v : s.xs) for (auto *t : v) delete t;
+        for (auto &v : s.ys) for (auto *t : v) delete t;
+    }
+}
+
+void *BatchLoader::loader_main(void *t) {
+    ((BatchLoader *) t)->loader_loop();
+    return nullptr;
+}
+
+void BatchLoader::gather(int b) {
+    BatchSlot &s = slots[b % slots.size()];
+    net->gather_batch(X, Y, batches[b], s.xs.data(), s.ys.data());
+}
+
+void BatchLoader::loader_loop() {
+    for (int b = 0; b < nbatches; b++) {
+        // Wait until the slot of batch b has been consumed
+        pthread_mutex_lock(&mutex);
+        while (b >= released + (int) slots.size() && !stopping) {
+            pthread_cond_wait(&cond_free, &mutex);
+        }
+        bool stop = stopping;
+        pthread_mutex_unlock(&mutex);
+        if (stop) return;
+
+        try {
+            gather(b);
+        }
+        catch (...) {
+            pthread_mutex_lock(&mutex);
+            error = std::current_exception();
+            pthread_cond_signal(&cond_ready);
+            pthread_mutex_unlock(&mutex);
+            return;
+        }
+
+        pthread_mutex_lock(&mutex);
+        gathered = b + 1;
+        pthread_cond_signal(&cond_ready);
+        pthread_mutex_unlock(&mutex);
+    }
+}
+
+BatchSlot *BatchLoader::wait(int b) {
+    if ((b < 0) || (b >= nbatches) || (b < released)) msg("Batch out of order", "BatchLoader::wait");
+
+    if (ahead == 0) {
+        gather(b);
+        return &slots[0];
+    }
+
+    pthread_mutex_lock(&mutex);
+    while (gathered <= b && !error) {
+        pthread_cond_wait(&cond_ready, &mutex);
+    }
+    exception_ptr e = error;
+    pthread_mutex_unlock(&mutex);
+
+    if (e) std::rethrow_exception(e);
+
+    return &slots[b % slots.size()];
+}
+
+void BatchLoader::release(int b) {
+    pthread_mutex_lock(&mutex);
+    released = b + 1;
+    pthread_cond_signal(&cond_free);
+    pthread_mutex_unlock(&mutex);
+}
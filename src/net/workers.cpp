@@ -0,0 +1,165 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.7
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: April 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <stdexcept>
+
+#include "eddl/system_info.h"
+#include "eddl/net/workers.h"
+
+#ifdef EDDL_LINUX
+#include <sched.h>
+#endif
+
+struct wdata {
+    WorkerPool *pool;
+    int id;
+};
+
+
+WorkerPool::WorkerPool(int n, bool pin) {
+    if (n < 1) {
+        throw std::runtime_error("WorkerPool needs at least one worker");
+    }
+
+    nworkers = n;
+    pinned = pin;
+    generation = 0;
+    pending = 0;
+    stopping = false;
+    task = nullptr;
+    args = nullptr;
+    ntasks = 0;
+
+    pthread_mutex_init(&mutex, nullptr);
+    pthread_cond_init(&cond_start, nullptr);
+    pthread_cond_init(&cond_done, nullptr);
+
+    // Worker 0 is the caller, so only n-1 threads are spawned
+    for (int i = 1; i < nworkers; i++) {
+        auto *wd = new wdata;
+        wd->pool = this;
+        wd->id = i;
+
+        pthread_t thr;
+        int rc = pthread_create(&thr, nullptr, WorkerPool::worker_main, (void *) wd);
+        if (rc) {
+            delete wd;
+            throw std::runtime_error("unable to create thread " + std::to_string(rc));
+        }
+        threads.push_back(thr);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    pthread_mutex_lock(&mutex);
+    stopping = true;
+    pthread_cond_broadcast(&cond_start);
+    pthread_mutex_unlock(&mutex);
+
+    for (auto &thr : threads) {
+        pthread_join(thr, nullptr);
+    }
+
+    pthread_cond_destroy(&cond_done);
+    pthread_cond_destroy(&cond_start);
+    pthread_mutex_destroy(&mutex);
+}
+
+void *WorkerPool::worker_main(void *t) {
+    auto *wd = (wdata *) t;
+    WorkerPool *pool = wd->pool;
+    int id = wd->id;
+    delete wd;
+
+    pool->worker_loop(id);
+
+    return nullptr;
+}
+
+void WorkerPool::worker_loop(int id) {
+#ifdef EDDL_LINUX
+    if (pinned) {
+        int ncores = std::thread::hardware_concurrency();
+        if (ncores > 0) {
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            CPU_SET(id % ncores, &cpuset);
+            pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+        }
+    }
+#endif
+
+    unsigned long seen = 0;
+    while (true) {
+        pthread_mutex_lock(&mutex);
+        while (generation == seen && !stopping) {
+            pthread_cond_wait(&cond_start, &mutex);
+        }
+        if (stopping) {
+            pthread_mutex_unlock(&mutex);
+            break;
+        }
+        seen = generation;
+        bool active = id < ntasks;
+        pthread_mutex_unlock(&mutex);
+
+        if (!active) continue;
+
+        run_task(id);
+
+        pthread_mutex_lock(&mutex);
+        if (--pending == 0) pthread_cond_signal(&cond_done);
+        pthread_mutex_unlock(&mutex);
+    }
+}
+
+void WorkerPool::run_task(int id) {
+    try {
+        task(args[id]);
+    }
+    catch (...) {
+        pthread_mutex_lock(&mutex);
+        if (!error) error = std::current_exception();
+        pthread_mutex_unlock(&mutex);
+    }
+}
+
+void WorkerPool::run(void *(*F)(void *), void **a, int n) {
+    if (n > nworkers) {
+        throw std::runtime_error("WorkerPool: " + std::to_string(n) + " tasks for " + std::to_string(nworkers) + " workers");
+    }
+    if (n <= 0) return;
+
+    // Publish the new dispatch and wake up the workers that take part in it
+    pthread_mutex_lock(&mutex);
+    task = F;
+    args = a;
+    ntasks = n;
+    pending = n - 1;
+    error = nullptr;
+    generation++;
+    if (pending > 0) pthread_cond_broadcast(&cond_start);
+    pthread_mutex_unlock(&mutex);
+
+    run_task(0);
+
+    // Barrier: wait for the rest
+    pthread_mutex_lock(&mutex);
+    while (pending > 0) {
+        pthread_cond_wait(&cond_done, &mutex);
+    }
+    exception_ptr e = error;
+    error = nullptr;
+    pthread_mutex_unlock(&mutex);
+
+    if (e) std::rethrow_exception(e);
+}
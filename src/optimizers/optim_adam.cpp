@@ -12,6 +12,8 @@
 #include <iostream>
 
 #include "eddl/optimizers/optim.h"
+#include "eddl/tensor/nn/tensor_nn.h"
+#include "eddl/profiler.h"
 
 using namespace std;
 
@@ -29,10 +31,10 @@ Adam::Adam(float lr, float beta_1, float beta_2, float epsilon, float weight_dec
 }
 
 Adam::~Adam() {
+  for (int i = 0; i < mT.size(); i++) delete mT[i];
   mT.clear();
+  for (int i = 0; i < vT.size(); i++) delete vT[i];
   vT.clear();
-  mCap.clear();
-  vCap.clear();
 }
 
 void Adam::change(vector<float> &p) {
@@ -65,10 +67,6 @@ void Adam::setlayers(vlayer l) {
             mT.back()->fill_(0.0);
             vT.push_back(new Tensor(layers[i]->gradients[j]->getShape(), layers[i]->dev));
             vT.back()->fill_(0.0);
-            mCap.push_back(new Tensor(layers[i]->gradients[j]->getShape(), layers[i]->dev));
-            mCap.back()->fill_(0.0);
-            vCap.push_back(new Tensor(layers[i]->gradients[j]->getShape(), layers[i]->dev));
-            vCap.back()->fill_(0.0);
         }
 
 }
@@ -82,23 +80,14 @@ void Adam::applygrads(int batch) {
     int p = 0;
     t++;
     for (int i = 0; i < layers.size(); i++)
-      if (layers[i]->trainable) {
+      if ((layers[i]->trainable) && (layers[i]->get_trainable_params_count() > 0)) {
+        ProfScope prof(layers[i]->name, PROF_UPDATE);
         for (int j = 0; j < layers[i]->get_trainable_params_count(); j++, p++) {
-            Tensor::add(beta_1,mT[p],(1-beta_1),layers[i]->gradients[j],mT[p],0);
-            layers[i]->gradients[j]->sqr_();
-            Tensor::add(beta_2,vT[p],(1-beta_2),layers[i]->gradients[j],vT[p],0);
-
-            Tensor::copy(mT[p],mCap[p]);
-            mCap[p]->div_(1-pow(beta_1,t));
-
-            Tensor::copy(vT[p],vCap[p]);
-            vCap[p]->div_(1-pow(beta_2,t));
-            vCap[p]->add_(epsilon);
-            vCap[p]->sqrt_();
-
-            Tensor::el_div(mCap[p],vCap[p],mCap[p],0);
-
-            Tensor::add(-lr, mCap[p],1.0,layers[i]->params[j], layers[i]->params[j], 0);
+            vector<int> *rows = layers[i]->sparse_rows(j);
+            if (rows != nullptr)
+              tensorNN::adam_update_rows(layers[i]->params[j], layers[i]->gradients[j], mT[p], vT[p], *rows, lr, beta_1, beta_2, epsilon, weight_decay, t);
+            else
+              tensorNN::adam_update(layers[i]->params[j], layers[i]->gradients[j], mT[p], vT[p], lr, beta_1, beta_2, epsilon, weight_decay, t);
         }
     }
     else p+=layers[i]->get_trainable_params_count();
@@ -12,6 +12,8 @@
 #include <iostream>
 
 #include "eddl/optimizers/optim.h"
+#include "eddl/tensor/nn/tensor_nn.h"
+#include "eddl/profiler.h"
 
 using namespace std;
 
@@ -25,8 +27,8 @@ RMSProp::RMSProp(float lr, float rho, float epsilon, float weight_decay) : Optim
 }
 
 RMSProp::~RMSProp() {
+  for (int i = 0; i < gT1.size(); i++) delete gT1[i];
   gT1.clear();
-  gT.clear();
 }
 
 void RMSProp::change(vector<float> &p) {
@@ -59,8 +61,6 @@ void RMSProp::setlayers(vlayer l) {
         for (int j = 0; j < layers[i]->get_trainable_params_count(); j++) {
             gT1.push_back(new Tensor(layers[i]->gradients[j]->getShape(), layers[i]->dev));
             gT1.back()->fill_(0.0);
-            gT.push_back(new Tensor(layers[i]->gradients[j]->getShape(), layers[i]->dev));
-            gT.back()->fill_(0.0);
         }
 
 }
@@ -75,28 +75,10 @@ void RMSProp::applygrads(int batch) {
 
     int p = 0;
     for (int i = 0; i < layers.size(); i++)
-      if (layers[i]->trainable) {
+      if ((layers[i]->trainable) && (layers[i]->get_trainable_params_count() > 0)) {
+        ProfScope prof(layers[i]->name, PROF_UPDATE);
         for (int j = 0; j < layers[i]->get_trainable_params_count(); j++, p++) {
-            Tensor::copy(layers[i]->gradients[j],gT[p]);
-            gT[p]->sqr_();
-            gT[p]->mult_(1.0f-rho);
-
-            gT1[p]->sqr_();
-            gT1[p]->mult_(rho);
-            Tensor::add(1.0,gT1[p],1.0,gT[p],gT[p],0);
-
-            gT[p]->add_(epsilon);
-            gT[p]->sqrt_();
-            Tensor::el_div(layers[i]->gradients[j],gT[p],gT[p],0);
-
-            Tensor::copy(layers[i]->gradients[j],gT1[p]);
-
-            Tensor::add(-lr, gT[p],1.0,layers[i]->params[j], layers[i]->params[j], 0);
-
-      			/*if (layers[i]->acc_gradients.size() > 0) {
-        				Tensor::add(-lr, gT[p],1.0,layers[i]->acc_gradients[j], layers[i]->acc_gradients[j], 0);
-      			}
-            */
+            tensorNN::rmsprop_update(layers[i]->params[j], layers[i]->gradients[j], gT1[p], lr, rho, epsilon, weight_decay);
         }
     }
     else p+=layers[i]->get_trainable_params_count();
@@ -12,6 +12,8 @@
 #include <iostream>
 
 #include "eddl/optimizers/optim.h"
+#include "eddl/tensor/nn/tensor_nn.h"
+#include "eddl/profiler.h"
 
 using namespace std;
 
@@ -25,6 +27,7 @@ SGD::SGD(float lr, float momentum, float weight_decay, bool nesterov) : Optimize
 }
 
 SGD::~SGD() {
+  for (int i = 0; i < mT.size(); i++) delete mT[i];
   mT.clear();
 }
 
@@ -71,10 +74,14 @@ void SGD::applygrads(int batch) {
       clip();
       int p = 0;
       for (int i = 0; i < layers.size(); i++) {
-        if (layers[i]->trainable) {
+        if ((layers[i]->trainable) && (layers[i]->get_trainable_params_count() > 0)) {
+          ProfScope prof(layers[i]->name, PROF_UPDATE);
           for (int j = 0; j < layers[i]->get_trainable_params_count(); j++, p++) {
-            Tensor::add(lr , layers[i]->gradients[j], mu, mT[p], mT[p], 0);
-            Tensor::add(1.0, layers[i]->params[j], -1.0, mT[p], layers[i]->params[j], 0);
+            vector<int> *rows = layers[i]->sparse_rows(j);
+            if (rows != nullptr)
+              tensorNN::sgd_update_rows(layers[i]->params[j], layers[i]->gradients[j], mT[p], *rows, lr, mu, weight_decay, nesterov);
+            else
+              tensorNN::sgd_update(layers[i]->params[j], layers[i]->gradients[j], mT[p], lr, mu, weight_decay, nesterov);
           }
         }
         else p+=layers[i]->get_trainable_params_count();
@@ -0,0 +1,202 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.7
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: April 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+#include "eddl/profiler.h"
+#include "eddl/utils.h"
+#include "eddl/hardware/cpu/cpu_allocator.h"
+
+using namespace std::chrono;
+
+std::atomic<bool> prof_on(false);
+
+// Open scope of a thread
+struct ProfOpen {
+    const char *kernel;  // nullptr for layers
+    string layer;
+    int phase;
+    long long start;
+    unsigned long long bytes;
+};
+
+struct ProfThread {
+    int tid;
+    vector<ProfEvent> events;
+    vector<ProfOpen> open;
+};
+
+// Threads are kept after they end, their events are still read
+static mutex prof_mutex;
+static vector<ProfThread *> prof_threads;
+static steady_clock::time_point prof_origin = steady_clock::now();
+
+static thread_local ProfThread *pcur = nullptr;
+
+static ProfThread *this_thread() {
+    if (pcur == nullptr) {
+        lock_guard<mutex> lock(prof_mutex);
+        pcur = new ProfThread();
+        pcur->tid = prof_threads.size();
+        prof_threads.push_back(pcur);
+    }
+    return pcur;
+}
+
+static long long prof_now() {
+    return duration_cast<nanoseconds>(steady_clock::now() - prof_origin).count();
+}
+
+
+void prof_enable(bool enable) {
+    if (enable) {
+        lock_guard<mutex> lock(prof_mutex);
+        for (ProfThread *t : prof_threads) {
+            t->events.clear();
+            t->open.clear();
+        }
+        prof_origin = steady_clock::now();
+    }
+    prof_on.store(enable);
+}
+
+void prof_begin(const string &layer, int phase) {
+    ProfThread *t = this_thread();
+    t->open.push_back({nullptr, layer, phase, prof_now(), fmem_thread_allocated()});
+}
+
+void prof_kernel_begin(const char *kernel) {
+    ProfThread *t = this_thread();
+    // The kernel belongs to the innermost layer running on this thread
+    string layer;
+    for (int i = (int) t->open.size() - 1; i >= 0; i--)
+        if (t->open[i].kernel == nullptr) {
+            layer = t->open[i].layer;
+            break;
+        }
+    t->open.push_back({kernel, layer, PROF_KERNEL, prof_now(), fmem_thread_allocated()});
+}
+
+// Closes the innermost scope opened with that kernel (nullptr: a layer), and
+// the ones left open inside it (a kernel returning before its end probe)
+static void prof_close(const char *kernel) {
+    ProfThread *t = this_thread();
+    int i = (int) t->open.size() - 1;
+    while ((i >= 0) && (t->open[i].kernel != kernel)) i--;
+    if (i < 0) return;  // opened before the recording started
+
+    ProfOpen &o = t->open[i];
+    ProfEvent e;
+    e.name = (kernel != nullptr) ? string(kernel) : o.layer;
+    e.layer = (kernel != nullptr) ? o.layer : string();
+    e.phase = o.phase;
+    e.tid = t->tid;
+    e.start = o.start;
+    e.dur = prof_now() - o.start;
+    e.bytes = fmem_thread_allocated() - o.bytes;
+    t->events.push_back(e);
+    t->open.resize(i);
+}
+
+void prof_end() {
+    prof_close(nullptr);
+}
+
+void prof_kernel_end(const char *kernel) {
+    prof_close(kernel);
+}
+
+
+vector<ProfEvent> prof_events() {
+    vector<ProfEvent> events;
+    {
+        lock_guard<mutex> lock(prof_mutex);
+        for (ProfThread *t : prof_threads) events.insert(events.end(), t->events.begin(), t->events.end());
+    }
+    stable_sort(events.begin(), events.end(), [](const ProfEvent &a, const ProfEvent &b) {
+        return a.start < b.start;
+    });
+    return events;
+}
+
+map<string, ProfStats> prof_layer_stats() {
+    map<string, ProfStats> stats;
+    for (ProfEvent &e : prof_events()) {
+        if (e.phase == PROF_KERNEL) continue;
+        auto it = stats.find(e.name);
+        if (it == stats.end()) it = stats.insert({e.name, ProfStats{{0, 0, 0}, {0, 0, 0}, 0}}).first;
+        it->second.calls[e.phase]++;
+        it->second.ns[e.phase] += e.dur;
+        it->second.bytes += e.bytes;
+    }
+    return stats;
+}
+
+string prof_kernel_summary() {
+    map<string, pair<long long, long long>> kernels;  // calls, ns
+    for (ProfEvent &e : prof_events()) {
+        if (e.phase != PROF_KERNEL) continue;
+        kernels[e.name].first++;
+        kernels[e.name].second += e.dur;
+    }
+    vector<pair<string, pair<long long, long long>>> rows(kernels.begin(), kernels.end());
+    stable_sort(rows.begin(), rows.end(), [](const pair<string, pair<long long, long long>> &a,
+                                             const pair<string, pair<long long, long long>> &b) {
+        return a.second.second > b.second.second;
+    });
+
+    std::stringstream ss;
+    ss << "---------------------------------------------------------" << endl;
+    ss << setw(30) << left << "kernel" << setw(10) << right << "calls" << setw(14) << "ms" << endl;
+    ss << "---------------------------------------------------------" << endl;
+    for (auto &r : rows)
+        ss << setw(30) << left << r.first << setw(10) << right << r.second.first
+           << setw(14) << fixed << setprecision(3) << r.second.second * 1e-6 << endl;
+    ss << "---------------------------------------------------------" << endl;
+    return ss.str();
+}
+
+
+static string json_escape(const string &s) {
+    string out;
+    for (char c : s) {
+        if ((c == '"') || (c == '\\')) out += '\\';
+        if ((unsigned char) c < 0x20) continue;
+        out += c;
+    }
+    return out;
+}
+
+void prof_save_trace(const string &fname) {
+    static const char *phases[] = {"forward", "backward", "update", "kernel"};
+
+    std::ofstream ofs(fname);
+    if (!ofs.is_open()) msg("Could not write " + fname, "prof_save_trace");
+
+    // Complete events ("X"), times in microseconds
+    ofs << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    bool first = true;
+    ofs << fixed << setprecision(3);
+    for (ProfEvent &e : prof_events()) {
+        ofs << (first ? "\n" : ",\n");
+        first = false;
+        ofs << "{\"name\": \"" << json_escape(e.name) << "\", \"cat\": \"" << phases[e.phase]
+            << "\", \"ph\": \"X\", \"pid\": 0, \"tid\": " << e.tid
+            << ", \"ts\": " << e.start * 1e-3 << ", \"dur\": " << e.dur * 1e-3
+            << ", \"args\": {";
+        if (e.phase == PROF_KERNEL) ofs << "\"layer\": \"" << json_escape(e.layer) << "\", ";
+        ofs << "\"bytes\": " << e.bytes << "}}";
+    }
+    ofs << "\n]}\n";
+}
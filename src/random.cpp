@@ -9,26 +9,125 @@
 #include <cstdio>
 #include <cmath>
 #include <random>
+#include <atomic>
 
 #include "eddl/random.h"
 #include "eddl/utils.h"
 
 #define PI 3.1415926
-#define MAX_RTABLE 100000
-
-static float *RTable=nullptr;
-static int posTable=0;
 
 // Default seed
 static std::random_device rd;  //Will be used to obtain a seed for the random number engine
-static std::mt19937 gen(rd()); //Standard mersenne_twister_engine seeded with rd()
+static uint64_t rand_seed = ((uint64_t) rd() << 32) | rd();
+static std::atomic<uint64_t> rand_counter(0);
+
+
+void set_rand_seed(uint64_t seed) {
+    rand_seed = seed;
+    rand_counter = 0;
+}
+
+uint64_t get_rand_seed() {
+    return rand_seed;
+}
+
+uint64_t reserve_rand(uint64_t n) {
+    // Ranges start at a block boundary so bulk fills use whole blocks
+    return rand_counter.fetch_add((n + 3) & ~(uint64_t) 3);
+}
+
+float uniform_at(uint64_t ctr, float min, float max) {
+    uint32_t r[4];
+    philox4x32(ctr >> 2, rand_seed, r);
+    return min + (max - min) * rand_word_to_float(r[ctr & 3]);
+}
+
+// Whole blocks are generated in parallel (and vectorized); the last
+// n % 4 values come from a partial block
+void fill_uniform(float *p, long int n, float min, float max) {
+    uint64_t base = reserve_rand(n) >> 2;
+    uint64_t key = rand_seed;
+    long int nb = n / 4;
+    float range = max - min;
+
+#if OpenMP_VERSION_MAJOR >= 4
+    #pragma omp parallel for simd
+#else
+    #pragma omp parallel for
+#endif
+    for (long int b = 0; b < nb; b++) {
+        uint32_t r[4];
+        philox4x32(base + b, key, r);
+        for (int k = 0; k < 4; k++) p[b * 4 + k] = min + range * rand_word_to_float(r[k]);
+    }
+    if (nb * 4 < n) {
+        uint32_t r[4];
+        philox4x32(base + nb, key, r);
+        for (long int i = nb * 4; i < n; i++) p[i] = min + range * rand_word_to_float(r[i - nb * 4]);
+    }
+}
+
+void fill_binary(float *p, long int n, float v) {
+    uint64_t base = reserve_rand(n) >> 2;
+    uint64_t key = rand_seed;
+    long int nb = n / 4;
+
+#if OpenMP_VERSION_MAJOR >= 4
+    #pragma omp parallel for simd
+#else
+    #pragma omp parallel for
+#endif
+    for (long int b = 0; b < nb; b++) {
+        uint32_t r[4];
+        philox4x32(base + b, key, r);
+        for (int k = 0; k < 4; k++) p[b * 4 + k] = (rand_word_to_float(r[k]) < v) ? 1.0f : 0.0f;
+    }
+    if (nb * 4 < n) {
+        uint32_t r[4];
+        philox4x32(base + nb, key, r);
+        for (long int i = nb * 4; i < n; i++) p[i] = (rand_word_to_float(r[i - nb * 4]) < v) ? 1.0f : 0.0f;
+    }
+}
+
+// Box-Muller over the two pairs of draws of a block
+static inline void block_normal(uint64_t ctr, uint64_t key, float z[4]) {
+    uint32_t r[4];
+    philox4x32(ctr, key, r);
+    for (int k = 0; k < 4; k += 2) {
+        float u1 = rand_word_to_float(r[k]) + (1.0f / 16777216.0f);  // (0,1]
+        float u2 = rand_word_to_float(r[k + 1]);
+        float rad = std::sqrt(-2.0f * std::log(u1));
+        z[k] = rad * std::cos(2.0f * (float) PI * u2);
+        z[k + 1] = rad * std::sin(2.0f * (float) PI * u2);
+    }
+}
+
+void fill_normal(float *p, long int n, float mean, float sd) {
+    uint64_t base = reserve_rand(n) >> 2;
+    uint64_t key = rand_seed;
+    long int nb = n / 4;
+
+#if OpenMP_VERSION_MAJOR >= 4
+    #pragma omp parallel for simd
+#else
+    #pragma omp parallel for
+#endif
+    for (long int b = 0; b < nb; b++) {
+        float z[4];
+        block_normal(base + b, key, z);
+        for (int k = 0; k < 4; k++) p[b * 4 + k] = mean + sd * z[k];
+    }
+    if (nb * 4 < n) {
+        float z[4];
+        block_normal(base + nb, key, z);
+        for (long int i = nb * 4; i < n; i++) p[i] = mean + sd * z[i - nb * 4];
+    }
+}
 
 
 float uniform(float min, float max) {
-    // rand() may not generate numbers uniformly and is therefore discouraged
-    // Talk: https://channel9.msdn.com/Events/GoingNative/2013/rand-Considered-Harmful
-    std::uniform_real_distribution<float> distr(min, max);
-    return distr(gen);
+    // Thread-safe: every call takes its own counter
+    return uniform_at(reserve_rand(1), min, max);
 }
 
 float signed_uniform() {
@@ -48,21 +147,3 @@ float gaussgen() {
 float slow_randn(float mean, float sd) {
     return (gaussgen() * sd) + mean;
 }
-
-void build_randn_table() {
-    if (RTable == nullptr) {
-        printf("Generating Random Table\n");
-        RTable = get_fmem(MAX_RTABLE, "build_randn_table");
-
-        for (int i = 0; i < MAX_RTABLE; i++)
-            RTable[i] = gaussgen();
-    }
-}
-
-float fast_randn(float mean, float sd, int seed) {
-    build_randn_table();
-    
-    posTable = (posTable + seed) % MAX_RTABLE;
-    if (posTable<0) posTable=-posTable;
-    return (RTable[posTable] * sd) + mean;
-}
@@ -125,6 +125,8 @@ using namespace std;
 	}
 	
 	onnx::ModelProto build_onnx_model( Net *net , bool gradients ) {
+		// The weights of folded layers no longer match the graph
+		if ( net->isfolded ) msg( "Nets with batchnorms folded by freeze() can not be exported", "build_onnx_model" );
 		string producer_name ( "EDDL" ); 
 		string producer_version ( "0.1" ); // ????????????????
 		// Create the empty Model in onnx
@@ -347,7 +349,7 @@ using namespace std;
 		onnx::AttributeProto* conv_dilations = node->add_attribute();
 		conv_dilations->set_name( "dilations" );
 		conv_dilations->set_type( onnx::AttributeProto::INTS );
-		vector<int> vdilations {1, 1}; // ?? Tenemos esto en EDDL
+		vector<int> vdilations {layer->cd->dr, layer->cd->dc};
 		for ( int i : vdilations ) {
 			conv_dilations->add_ints( i );
 		}
@@ -355,7 +357,7 @@ using namespace std;
 		onnx::AttributeProto* conv_group = node->add_attribute();
 		conv_group->set_name( "group" );
 		conv_group->set_type( onnx::AttributeProto::INT );
-		conv_group->set_i( 1 ); // ????????????????????????????????????????????????????
+		conv_group->set_i( layer->cd->groups );
 		// Attr kernel_shape
 		onnx::AttributeProto* conv_kernel_shape = node->add_attribute();
 		conv_kernel_shape->set_name( "kernel_shape" );
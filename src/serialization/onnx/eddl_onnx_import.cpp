@@ -669,6 +669,8 @@ using namespace std;
 						string auto_pad_option = "";
 						bool auto_pad = false;
 						vector<float> *bias;
+						vector<int> dilation_rate = {1, 1};
+						int groups = 1;
 
 						for ( int j = 0; j < node->attribute_size(); j++ ) { //Set the attributes
 							onnx::AttributeProto attribute = node->attribute(j);
@@ -684,11 +686,13 @@ using namespace std;
 								else if(!attribute.s().compare("SAME_UPPER"))
 									auto_pad_option = "same";
 							}
-							else if (!attr_name.compare("dilations")) { //It isn't implemented in eddl
-
+							else if (!attr_name.compare("dilations")) {
+								for( int h = 0; h < attribute.ints_size() && h < 2; h++){
+									dilation_rate[h] = attribute.ints(h);
+								}
 							}
-							else if (!attr_name.compare("group")) { //We don't know if this exists in eddl
-
+							else if (!attr_name.compare("group")) {
+								groups = attribute.i();
 							}
 							else if (!attr_name.compare("kernel_shape")) { //
 								for( int h = 0; h<attribute.ints_size(); h++){
@@ -733,6 +737,9 @@ using namespace std;
 							convol_descriptor = new ConvolDescriptor(kernel_shape, strides, pads);
 						}
 						else convol_descriptor = new ConvolDescriptor(filters, kernel_shape, strides, auto_pad_option, node->input_size() > 2, mem);
+						convol_descriptor->groups = groups;
+						convol_descriptor->dr = dilation_rate[0];
+						convol_descriptor->dc = dilation_rate[1];
 
 						actual_layer = new LConv(parent, convol_descriptor, name, dev, mem);
 
@@ -622,4 +622,27 @@ namespace tensorNN {
 
     }
 
-}
\ No newline at end of file
+    // Bias + activation epilogue
+    void bias_act(Tensor *O, Tensor *bias, int act, float param) {
+        if ((bias != nullptr) && (bias->size != O->shape[1])) msg("Incompatible dims", "Tensor::bias_act");
+
+        O->tsem->lock();
+        if (O->isCPU()) {
+            cpu_bias_act(O, bias, act, param);
+        }
+        else msg("Fused bias and activation only available on CPU", "Tensor::bias_act");
+        O->tsem->unlock();
+    }
+
+    void d_act(Tensor *D, Tensor *O, int act, float param) {
+        if (!Tensor::sameShape(D, O)) msg("Incompatible dims", "Tensor::d_act");
+
+        D->tsem->lock();
+        if (D->isCPU()) {
+            cpu_d_act(D, O, act, param);
+        }
+        else msg("Fused bias and activation only available on CPU", "Tensor::d_act");
+        D->tsem->unlock();
+    }
+
+}
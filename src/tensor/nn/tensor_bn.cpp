@@ -92,4 +92,24 @@ namespace tensorNN {
 #endif
     }
 
-}
\ No newline at end of file
+
+    // Fused NCHW BatchNorm. Other devices go through the permute-based path of LBatchNorm
+    void batchnorm_forward(Tensor *input, Tensor *output, Tensor *opa, Tensor *global_mean, Tensor *global_variance,
+                           Tensor *affine_g, Tensor *affine_b, Tensor *mean, Tensor *variance,
+                           bool trmode, float epsilon, float momentum) {
+        if (input->isCPU()) {
+            cpu_batchnorm_forward(input, output, opa, global_mean, global_variance, affine_g, affine_b,
+                                  mean, variance, trmode, epsilon, momentum);
+        }
+        else msg("Fused BatchNorm only available on CPU", "tensorNN::batchnorm_forward");
+    }
+
+    void batchnorm_backward(Tensor *delta, Tensor *opa, Tensor *pdelta, Tensor *variance, Tensor *affine_g,
+                            Tensor *gaffine_g, Tensor *gaffine_b, Tensor *mdelta, Tensor *mdelta_opa) {
+        if (delta->isCPU()) {
+            cpu_batchnorm_backward(delta, opa, pdelta, variance, affine_g, gaffine_g, gaffine_b, mdelta, mdelta_opa);
+        }
+        else msg("Fused BatchNorm only available on CPU", "tensorNN::batchnorm_backward");
+    }
+
+}
@@ -0,0 +1,37 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.7
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: April 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+#include "eddl/tensor/nn/tensor_nn.h"
+#include "eddl/hardware/cpu/nn/cpu_tensor_nn.h"
+
+
+namespace tensorNN {
+
+    // B = A * mask * scale, drawing a new mask of keep probability (CPU, bit-packed mask)
+    void dropout_forward(Tensor *A, Tensor *B, unsigned int *mask, float keep, float scale) {
+        if (A->device != B->device) msg("Tensors in different devices", "Tensor::dropout_forward");
+        if (A->size != B->size) msg("Incompatible dims", "Tensor::dropout_forward");
+
+        if (A->isCPU()) {
+            cpu_dropout_forward(A, B, mask, keep, scale);
+        }
+        else msg("Bit-packed dropout only available on CPU", "Tensor::dropout_forward");
+    }
+
+    // PD += D * mask * scale
+    void dropout_backward(Tensor *D, Tensor *PD, unsigned int *mask, float scale) {
+        if (D->device != PD->device) msg("Tensors in different devices", "Tensor::dropout_backward");
+        if (D->size != PD->size) msg("Incompatible dims", "Tensor::dropout_backward");
+
+        if (D->isCPU()) {
+            cpu_dropout_backward(D, PD, mask, scale);
+        }
+        else msg("Bit-packed dropout only available on CPU", "Tensor::dropout_backward");
+    }
+
+}
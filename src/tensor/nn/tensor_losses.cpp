@@ -47,4 +47,64 @@ namespace tensorNN {
         C->tsem->unlock();
     }
 
-}
\ No newline at end of file
+
+// Summed cross-entropy of a softmax output Y and, if D is given, the delta
+// wrt the softmax input: D=(Y-T)/batch
+    float softmax_cent(Tensor *T, Tensor *Y, Tensor *D) {
+        if (T->device != Y->device) msg("Tensors in different devices", "Tensor::softmax_cent");
+        if ((!Tensor::sameShape(T, Y)) || ((D != nullptr) && (!Tensor::sameShape(T, D)))) msg("Incompatible dims", "Tensor::softmax_cent");
+        if (T->ndim != 2) msg("softmax_cent only over 2D Tensor (batch x probs)", "Tensor::softmax_cent");
+
+        if (T->isCPU()) {
+            return cpu_softmax_cent(T, Y, D);
+        }
+
+        if (D != nullptr) {
+            Tensor::add(-1.0, T, 1.0, Y, D, 0);
+            D->div_(D->shape[0]);
+        }
+        Tensor *aux = new Tensor(T->getShape(), T->device);
+        cent(T, Y, aux);
+        float f = aux->sum();
+        delete aux;
+
+        return f;
+    }
+
+
+// Cross-entropy of Y against the class indices T (batch x 1) without building the
+// one-hot targets. D, if given, gets the delta wrt the softmax input (softmax=true)
+// or wrt Y. Other devices go through the CPU kernel.
+    float sparse_cent(Tensor *T, Tensor *Y, Tensor *D, bool softmax) {
+        if (T->device != Y->device) msg("Tensors in different devices", "Tensor::sparse_cent");
+        if ((Y->ndim != 2) || (T->ndim != 2) || (T->shape[1] != 1) || (T->shape[0] != Y->shape[0]))
+            msg("sparse_cent needs (batch x probs) outputs and (batch x 1) class indices", "Tensor::sparse_cent");
+        if ((D != nullptr) && (!Tensor::sameShape(Y, D))) msg("Incompatible dims", "Tensor::sparse_cent");
+
+        Tensor *Tc = T, *Yc = Y, *Dc = D;
+        if (!T->isCPU()) {
+            Tc = new Tensor(T->getShape());
+            Yc = new Tensor(Y->getShape());
+            Tensor::copy(T, Tc);
+            Tensor::copy(Y, Yc);
+            if (D != nullptr) Dc = new Tensor(D->getShape());
+        }
+
+        for (int i = 0; i < Tc->shape[0]; i++)
+            if ((Tc->ptr[i] < 0) || (Tc->ptr[i] >= Y->shape[1])) msg("Class index out of range", "Tensor::sparse_cent");
+
+        float f = cpu_sparse_cent(Tc, Yc, Dc, softmax);
+
+        if (Tc != T) {
+            if (D != nullptr) {
+                Tensor::copy(Dc, D);
+                delete Dc;
+            }
+            delete Tc;
+            delete Yc;
+        }
+
+        return f;
+    }
+
+}
@@ -0,0 +1,242 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.7
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: April 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+#include "eddl/tensor/nn/tensor_nn.h"
+#include "eddl/hardware/cpu/nn/cpu_tensor_nn.h"
+
+
+// {n x d} --> {n x 1}, sum of the absolute values of each row
+static void reduced_abs_sum(Tensor *input, Tensor *output) {
+    Tensor *A = input->clone();
+    A->abs_();
+
+    Tensor *ones = new Tensor({input->shape[1], 1}, input->device);
+    ones->fill_(1.0);
+
+    Tensor::mult2D(A, 0, ones, 0, output, 0);
+
+    delete A;
+    delete ones;
+}
+
+// {n x 1} --> {n x d}
+static Tensor *replicate_tensor(Tensor *input, int d) {
+    Tensor *ones = new Tensor({1, d}, input->device);
+    ones->fill_(1.0);
+
+    Tensor *output = new Tensor({input->shape[0], d}, input->device);
+    Tensor::mult2D(input, 0, ones, 0, output, 0);
+
+    delete ones;
+    return output;
+}
+
+// Column block k of the packed gates
+static Tensor *gate(Tensor *G, int k, int u) {
+    Tensor *A = new Tensor({G->shape[0], u}, G->device);
+    Tensor::fill(G, k * u, (k + 1) * u, A, 0, u, 0);
+    return A;
+}
+
+static void set_gate(Tensor *A, Tensor *G, int k, int u) {
+    Tensor::fill(A, 0, u, G, k * u, (k + 1) * u, 0);
+}
+
+// Tensor::fill has no FPGA kernel, the FPGA tensors are staged on the host
+static Tensor *host_copy(Tensor *A) {
+    if (A == nullptr) return nullptr;
+    Tensor *B = new Tensor(A->getShape());
+    Tensor::copy(A, B);
+    return B;
+}
+
+static void host_release(Tensor *A, Tensor *B, bool write) {
+    if (B == nullptr) return;
+    if (write) Tensor::copy(B, A);
+    delete B;
+}
+
+namespace tensorNN {
+
+    // Activates the [i|f|o|c] gates of G in place and computes the new states h, c
+    void lstm_forward(Tensor *X, Tensor *G, Tensor *bias, Tensor *hprev, Tensor *cprev,
+                      Tensor *mask, Tensor *sh, Tensor *h, Tensor *c) {
+        if ((G->shape[0] != h->shape[0]) || (G->shape[1] != 4 * h->shape[1]) || (bias->size != G->shape[1]))
+            msg("Incompatible dims", "Tensor::lstm_forward");
+
+        if (G->isCPU()) {
+            cpu_lstm_forward(X, G, bias, hprev, cprev, mask, sh, h, c);
+            return;
+        }
+        if (G->isGPU()) {
+            lstm_forward_unfused(X, G, bias, hprev, cprev, mask, sh, h, c);
+            return;
+        }
+
+        Tensor *x = host_copy(X), *g = host_copy(G), *b = host_copy(bias);
+        Tensor *hp = host_copy(hprev), *cp = host_copy(cprev), *m = host_copy(mask);
+        Tensor *s = host_copy(sh), *ho = host_copy(h), *co = host_copy(c);
+
+        cpu_lstm_forward(x, g, b, hp, cp, m, s, ho, co);
+
+        host_release(X, x, false); host_release(bias, b, false);
+        host_release(hprev, hp, false); host_release(cprev, cp, false);
+        host_release(G, g, true); host_release(mask, m, true);
+        host_release(sh, s, true); host_release(h, ho, true); host_release(c, co, true);
+    }
+
+    // Delta DG of the gate pre-activations, increments the deltas of the previous states
+    void lstm_backward(Tensor *G, Tensor *cprev, Tensor *sh, Tensor *mask, Tensor *dh, Tensor *dc,
+                       Tensor *DG, Tensor *dhprev, Tensor *dcprev) {
+        if ((!Tensor::sameShape(G, DG)) || (!Tensor::sameShape(dh, dc)) || (G->shape[1] != 4 * dh->shape[1]))
+            msg("Incompatible dims", "Tensor::lstm_backward");
+
+        if (G->isCPU()) {
+            cpu_lstm_backward(G, cprev, sh, mask, dh, dc, DG, dhprev, dcprev);
+            return;
+        }
+        if (G->isGPU()) {
+            lstm_backward_unfused(G, cprev, sh, mask, dh, dc, DG, dhprev, dcprev);
+            return;
+        }
+
+        Tensor *g = host_copy(G), *cp = host_copy(cprev), *s = host_copy(sh), *m = host_copy(mask);
+        Tensor *d1 = host_copy(dh), *d2 = host_copy(dc), *dg = host_copy(DG);
+        Tensor *dhp = host_copy(dhprev), *dcp = host_copy(dcprev);
+
+        cpu_lstm_backward(g, cp, s, m, d1, d2, dg, dhp, dcp);
+
+        host_release(G, g, false); host_release(cprev, cp, false);
+        host_release(sh, s, false); host_release(mask, m, false);
+        host_release(dh, d1, false); host_release(dc, d2, false);
+        host_release(DG, dg, true); host_release(dhprev, dhp, true); host_release(dcprev, dcp, true);
+    }
+
+    // Same as lstm_forward with one tensor operation per step, so the tensors stay on their device
+    void lstm_forward_unfused(Tensor *X, Tensor *G, Tensor *bias, Tensor *hprev, Tensor *cprev,
+                              Tensor *mask, Tensor *sh, Tensor *h, Tensor *c) {
+        int u = h->shape[1];
+
+        Tensor::sum2D_rowwise(G, bias, G);
+        Tensor *in = gate(G, 0, u), *fn = gate(G, 1, u), *on = gate(G, 2, u), *cn = gate(G, 3, u);
+        Sigmoid(in, in);
+        Sigmoid(fn, fn);
+        Sigmoid(on, on);
+        Tanh(cn, cn);
+        set_gate(in, G, 0, u);
+        set_gate(fn, G, 1, u);
+        set_gate(on, G, 2, u);
+        set_gate(cn, G, 3, u);
+
+        Tensor::el_mult(in, cn, c, 0);
+        if (cprev != nullptr) Tensor::el_mult(fn, cprev, c, 1);
+        Tanh(c, sh);
+        Tensor::el_mult(on, sh, h, 0);
+
+        if (mask != nullptr) {
+            Tensor *zeros = new Tensor(mask->getShape(), mask->device);
+            reduced_abs_sum(X, zeros);
+            Tensor::logical_not(zeros, zeros);  // 1 for the all-zero inputs
+            Tensor::logical_not(zeros, mask);
+
+            Tensor *A = replicate_tensor(mask, u);
+            Tensor *Z = replicate_tensor(zeros, u);
+            Tensor::el_mult(A, h, h, 0);
+            Tensor::el_mult(A, c, c, 0);
+            // output=prev output when in=0
+            if (hprev != nullptr) Tensor::el_mult(Z, hprev, h, 1);
+            if (cprev != nullptr) Tensor::el_mult(Z, cprev, c, 1);
+
+            delete A;
+            delete Z;
+            delete zeros;
+        }
+
+        delete in;
+        delete fn;
+        delete on;
+        delete cn;
+    }
+
+    // Same as lstm_backward with one tensor operation per step
+    void lstm_backward_unfused(Tensor *G, Tensor *cprev, Tensor *sh, Tensor *mask, Tensor *dh, Tensor *dc,
+                               Tensor *DG, Tensor *dhprev, Tensor *dcprev) {
+        int u = dh->shape[1];
+        int dev = G->device;
+        vector<int> shape = dh->getShape();
+
+        // Masked samples pass the deltas through, their gates get none
+        Tensor *A = nullptr;
+        Tensor *dhm = dh, *dcm = dc;
+        if (mask != nullptr) {
+            A = replicate_tensor(mask, u);
+            dhm = new Tensor(shape, dev);
+            dcm = new Tensor(shape, dev);
+            Tensor::el_mult(A, dh, dhm, 0);
+            Tensor::el_mult(A, dc, dcm, 0);
+
+            Tensor *zeros = mask->clone();
+            Tensor::logical_not(zeros, zeros);
+            Tensor *Z = replicate_tensor(zeros, u);
+            if (dhprev != nullptr) Tensor::el_mult(Z, dh, dhprev, 1);
+            if (dcprev != nullptr) Tensor::el_mult(Z, dc, dcprev, 1);
+            delete Z;
+            delete zeros;
+        }
+
+        Tensor *in = gate(G, 0, u), *fn = gate(G, 1, u), *on = gate(G, 2, u), *cn = gate(G, 3, u);
+        Tensor *d1 = new Tensor(shape, dev);
+        Tensor *dct = Tensor::zeros(shape, dev);
+        Tensor *dg = Tensor::zeros(shape, dev);
+
+        // delta of state_c
+        Tensor::el_mult(dhm, on, d1, 0);
+        D_Tanh(d1, sh, dct);
+        Tensor::inc(dcm, dct);
+
+        // output gate
+        Tensor::el_mult(dhm, sh, d1, 0);
+        D_Sigmoid(d1, on, dg);
+        set_gate(dg, DG, 2, u);
+
+        // forget gate
+        dg->fill_(0.0);
+        if (cprev != nullptr) {
+            Tensor::el_mult(dct, cprev, d1, 0);
+            D_Sigmoid(d1, fn, dg);
+            Tensor::el_mult(dct, fn, dcprev, 1);
+        }
+        set_gate(dg, DG, 1, u);
+
+        // input gate
+        dg->fill_(0.0);
+        Tensor::el_mult(dct, cn, d1, 0);
+        D_Sigmoid(d1, in, dg);
+        set_gate(dg, DG, 0, u);
+
+        // cell candidate
+        dg->fill_(0.0);
+        Tensor::el_mult(dct, in, d1, 0);
+        D_Tanh(d1, cn, dg);
+        set_gate(dg, DG, 3, u);
+
+        if (mask != nullptr) {
+            delete A;
+            delete dhm;
+            delete dcm;
+        }
+        delete in;
+        delete fn;
+        delete on;
+        delete cn;
+        delete d1;
+        delete dct;
+        delete dg;
+    }
+
+}
@@ -81,4 +81,23 @@ namespace tensorNN {
 
     }
 
+// Hits of the argmax of Y against the class indices T (batch x 1)
+    int sparse_accuracy(Tensor *T, Tensor *Y) {
+        if (T->device != Y->device) msg("Tensors in different devices", "Tensor::sparse_accuracy");
+        if ((Y->ndim != 2) || (T->ndim != 2) || (T->shape[1] != 1) || (T->shape[0] != Y->shape[0]))
+            msg("sparse_accuracy needs (batch x probs) outputs and (batch x 1) class indices", "Tensor::sparse_accuracy");
+
+        if (T->isCPU()) return cpu_sparse_accuracy(T, Y);
+
+        Tensor *Tc = new Tensor(T->getShape());
+        Tensor *Yc = new Tensor(Y->getShape());
+        Tensor::copy(T, Tc);
+        Tensor::copy(Y, Yc);
+        int acc = cpu_sparse_accuracy(Tc, Yc);
+        delete Tc;
+        delete Yc;
+
+        return acc;
+    }
+
 }
@@ -0,0 +1,119 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.7
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: April 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+#include <cmath>
+
+#include "eddl/tensor/nn/tensor_nn.h"
+#include "eddl/hardware/cpu/nn/cpu_tensor_nn.h"
+
+#ifdef cFPGA
+#include "eddl/hardware/fpga/nn/fpga_nn.h"
+#endif
+
+#ifdef cGPU
+#include "eddl/hardware/gpu/gpu_tensor.h"
+#include "eddl/hardware/gpu/gpu_hw.h"
+#include "eddl/hardware/gpu/nn/gpu_tensor_nn.h"
+#endif
+
+namespace tensorNN {
+
+
+// SGD: M = mu*M + lr*G ; P -= M (or P -= mu*M + lr*G with nesterov)
+    void sgd_update(Tensor *P, Tensor *G, Tensor *M, float lr, float mu, float weight_decay, bool nesterov) {
+        if ((P->device != G->device) || (P->device != M->device)) msg("Tensors in different devices", "Tensor::sgd_update");
+        if ((!Tensor::sameShape(P, G)) || (!Tensor::sameShape(P, M))) msg("Incompatible dims", "Tensor::sgd_update");
+
+        if (P->isCPU()) {
+            cpu_sgd_update(P, G, M, lr, mu, weight_decay, nesterov);
+        }
+#ifdef cGPU
+        else if (P->isGPU())
+          {
+          gpu_sgd_update(P, G, M, lr, mu, weight_decay, nesterov);
+          }
+#endif
+#ifdef cFPGA
+        else {
+            fpga_sgd_update(P, G, M, lr, mu, weight_decay, nesterov);
+        }
+#endif
+    }
+
+// Adam: bias corrections are folded into the step size and the scale of V
+    void adam_update(Tensor *P, Tensor *G, Tensor *M, Tensor *V, float lr, float beta_1, float beta_2, float epsilon, float weight_decay, int t) {
+        if ((P->device != G->device) || (P->device != M->device) || (P->device != V->device)) msg("Tensors in different devices", "Tensor::adam_update");
+        if ((!Tensor::sameShape(P, G)) || (!Tensor::sameShape(P, M)) || (!Tensor::sameShape(P, V))) msg("Incompatible dims", "Tensor::adam_update");
+
+        float step = lr / (1.0f - ::powf(beta_1, t));
+        float inv_bc2 = 1.0f / (1.0f - ::powf(beta_2, t));
+
+        if (P->isCPU()) {
+            cpu_adam_update(P, G, M, V, step, beta_1, beta_2, inv_bc2, epsilon, weight_decay);
+        }
+#ifdef cGPU
+        else if (P->isGPU())
+          {
+          gpu_adam_update(P, G, M, V, step, beta_1, beta_2, inv_bc2, epsilon, weight_decay);
+          }
+#endif
+#ifdef cFPGA
+        else {
+            fpga_adam_update(P, G, M, V, step, beta_1, beta_2, inv_bc2, epsilon, weight_decay);
+        }
+#endif
+    }
+
+// RMSProp: G1 keeps the previous gradient
+    void rmsprop_update(Tensor *P, Tensor *G, Tensor *G1, float lr, float rho, float epsilon, float weight_decay) {
+        if ((P->device != G->device) || (P->device != G1->device)) msg("Tensors in different devices", "Tensor::rmsprop_update");
+        if ((!Tensor::sameShape(P, G)) || (!Tensor::sameShape(P, G1))) msg("Incompatible dims", "Tensor::rmsprop_update");
+
+        if (P->isCPU()) {
+            cpu_rmsprop_update(P, G, G1, lr, rho, epsilon, weight_decay);
+        }
+#ifdef cGPU
+        else if (P->isGPU())
+          {
+          gpu_rmsprop_update(P, G, G1, lr, rho, epsilon, weight_decay);
+          }
+#endif
+#ifdef cFPGA
+        else {
+            fpga_rmsprop_update(P, G, G1, lr, rho, epsilon, weight_decay);
+        }
+#endif
+    }
+
+// Row-sparse updates of 2D params (embeddings). Other devices update all the rows
+    void sgd_update_rows(Tensor *P, Tensor *G, Tensor *M, const vector<int> &rows, float lr, float mu, float weight_decay, bool nesterov) {
+        if (!P->isCPU()) {
+            sgd_update(P, G, M, lr, mu, weight_decay, nesterov);
+            return;
+        }
+        if ((P->device != G->device) || (P->device != M->device)) msg("Tensors in different devices", "Tensor::sgd_update_rows");
+        if ((!Tensor::sameShape(P, G)) || (!Tensor::sameShape(P, M))) msg("Incompatible dims", "Tensor::sgd_update_rows");
+
+        cpu_sgd_update_rows(P, G, M, rows, lr, mu, weight_decay, nesterov);
+    }
+
+    void adam_update_rows(Tensor *P, Tensor *G, Tensor *M, Tensor *V, const vector<int> &rows, float lr, float beta_1, float beta_2, float epsilon, float weight_decay, int t) {
+        if (!P->isCPU()) {
+            adam_update(P, G, M, V, lr, beta_1, beta_2, epsilon, weight_decay, t);
+            return;
+        }
+        if ((P->device != G->device) || (P->device != M->device) || (P->device != V->device)) msg("Tensors in different devices", "Tensor::adam_update_rows");
+        if ((!Tensor::sameShape(P, G)) || (!Tensor::sameShape(P, M)) || (!Tensor::sameShape(P, V))) msg("Incompatible dims", "Tensor::adam_update_rows");
+
+        float step = lr / (1.0f - ::powf(beta_1, t));
+        float inv_bc2 = 1.0f / (1.0f - ::powf(beta_2, t));
+
+        cpu_adam_update_rows(P, G, M, V, rows, step, beta_1, beta_2, inv_bc2, epsilon, weight_decay);
+    }
+
+}
@@ -13,6 +13,11 @@
 
 #include "eddl/tensor/tensor.h"
 #include "eddl/utils.h"
+#include "eddl/system_info.h"
+
+#if defined(EDDL_LINUX) || defined(EDDL_UNIX) || defined(EDDL_APPLE)
+#include <sys/mman.h>
+#endif
 
 #ifdef cGPU
 #include "eddl/hardware/gpu/gpu_tensor.h"
@@ -72,6 +77,7 @@ Tensor::Tensor(const vector<int> &shape, float *fptr, int dev){
 
 #ifdef cFPGA
     fpga_ptr = (cl::Buffer *)nullptr;
+    fpga_mirror = nullptr;
 #endif
 
     // Update values
@@ -88,7 +94,17 @@ Tensor::Tensor(const vector<int> &shape, float *fptr, int dev){
 Tensor::Tensor(const vector<int> &shape, int dev):Tensor(shape, nullptr, dev){}
 
 // From shape and Tensor (sharing ptr)
-Tensor::Tensor(const vector<int> &shape, Tensor *T):Tensor(shape,T->ptr, T->device) {}
+Tensor::Tensor(const vector<int> &shape, Tensor *T):Tensor(shape,T->ptr, T->device) {
+#ifdef cFPGA
+    // Alias the FPGA buffer too, together with its coherence state
+    if (T->isFPGA()) {
+        this->fpga_ptr = T->fpga_ptr;
+        this->fpga_mirror = T->fpga_mirror;
+        this->fpga_size = T->fpga_size;
+        this->fpga_tensor_id = T->fpga_tensor_id;
+    }
+#endif
+}
 
 Tensor::Tensor(const vector<float>& data, const vector<int> &shape, int dev) : Tensor(shape, nullptr, DEV_CPU) {
     // 0. Tensor in CPU
@@ -137,7 +153,18 @@ void Tensor::deleteData(){
     // Careful, you can't know is a pointer is allocated
     if(this->ptr != nullptr){
         if (this->isCPU()) {
-            delete[] this->ptr;
+            if (this->mmap_base != nullptr) {
+                // Only delete ptr when it no longer points into the mapping (e.g. after a resize)
+                char *base = (char *)this->mmap_base;
+                bool mapped = ((char *)this->ptr >= base) && ((char *)this->ptr < base + this->mmap_length);
+#if defined(EDDL_LINUX) || defined(EDDL_UNIX) || defined(EDDL_APPLE)
+                munmap(this->mmap_base, this->mmap_length);
+#endif
+                this->mmap_base = nullptr;
+                this->mmap_length = 0;
+                if (!mapped) free_fmem(this->ptr);
+            }
+            else free_fmem(this->ptr);
         }
 #ifdef cGPU
         else if (this->isGPU())
@@ -149,6 +176,8 @@ void Tensor::deleteData(){
         else if (this->isFPGA())
 	{
             fpga_delete_tensor(this->fpga_device, this->fpga_ptr, this->fpga_tensor_id, this->fpga_size);
+            delete this->fpga_mirror;
+            this->fpga_mirror = nullptr;
 	}
 
       // delete FPGA Tensor
@@ -157,7 +186,7 @@ void Tensor::deleteData(){
     }
 }
 
-void Tensor::updateData(float *fptr, void *fptr2){
+void Tensor::updateData(float *fptr, void *fptr2, void *fptr3){
     // TODO: What if the new_pointer is the same?
 
     if (this->isCPU()) {
@@ -204,6 +233,7 @@ void Tensor::updateData(float *fptr, void *fptr2){
           printf("  ([updateData fptr==null] creating tensor size %d; id being assigned %d)\n", this->size, next_fpga_tensor_id);
           #endif
           this->fpga_ptr = fpga_create_tensor(fpga_device, this->size);
+          this->fpga_mirror = new HostMirror();
           this->fpga_size = this->size;
           // we allocate also on cpu so to fluently emulate with cpu
           this->ptr = get_fmem(this->size,"Tensor::updateData");
@@ -225,6 +255,7 @@ void Tensor::updateData(float *fptr, void *fptr2){
             #endif
           this->ptr = fptr;
 	  this->fpga_ptr = (cl::Buffer *)fptr2;
+	  this->fpga_mirror = (HostMirror *)fptr3;
         }
         // For 2 dimensions, map to data to Eigen for efficiency
         // Efficient operations will be done over ptr2, which also points to ptr
@@ -293,7 +324,7 @@ void Tensor::toGPU(int dev){
 
         this->ptr = gpu_ptr;
         gpu_copy_to_gpu(cpu_ptr, this);
-        delete cpu_ptr;
+        free_fmem(cpu_ptr);
     }
     else if (this->isGPU())
     {
@@ -321,6 +352,7 @@ void Tensor::toFPGA(int dev){
         }
 
         this->fpga_ptr = fpga_ptr;
+        this->fpga_mirror = new HostMirror();
         fpga_copy_to_fpga(cpu_ptr, this);
 	// we do not remove the cpu_ptr as is used for cpuemu mode
         //delete cpu_ptr;
@@ -492,7 +524,7 @@ bool Tensor::isSquared(Tensor *A){
 }
 
 // Resizing tensors
-void Tensor::resize(int b, float *fptr, void *fptr2) {
+void Tensor::resize(int b, float *fptr, void *fptr2, void *fptr3) {
     if (b == shape[0]) return;
 
     // Get new shape
@@ -504,6 +536,6 @@ void Tensor::resize(int b, float *fptr, void *fptr2) {
     updateSize();
     updateStrides();
     if (fptr != nullptr) deleteData();  // Potential error
-    updateData(fptr, fptr2);
+    updateData(fptr, fptr2, fptr3);
 }
 
@@ -47,14 +47,81 @@ void Tensor::fill(Tensor* A, float v){
 }
 
 
+// Axes order of moveaxis and swapaxis, with "-1" as alias for the last dimension
+static vector<int> moveaxis_dims(int ndim, int source, int destination){
+    if(source<-1 || destination <-1 || source>=ndim || destination>=ndim){
+        msg("Invalid axis", "Tensor::moveaxis");
+    }
+    if(source == -1){source = ndim-1; }
+    if(destination == -1){destination = ndim-1; }
+
+    // Build axes to permute [1 => 3] => (0,1,2,3) => (0,2,3,1)
+    vector<int> dims;
+    dims.reserve(ndim);
+    for(int i=0; i<ndim;i++){
+        dims.push_back(i);
+    }
+    dims.erase(dims.begin()+source);  // Remove axis
+    dims.insert(dims.begin() + destination, source);  // Insert at final position
+    return dims;
+}
+
+static vector<int> swapaxis_dims(int ndim, int axis1, int axis2){
+    if(axis1<-1 || axis2 <-1 || axis1>=ndim || axis2>=ndim){
+        msg("Invalid axis", "Tensor::swapaxis");
+    }
+    if(axis1 == -1){axis1 = ndim-1; }
+    if(axis2 == -1){axis2 = ndim-1; }
+    if(axis1 == axis2){
+        msg("Invalid axis", "Tensor::swapaxis");
+    }
+
+    // Build axes to permute [0, 3] => (0,1,2,3) => (3,1,2,0)
+    vector<int> dims;
+    for(int i=0; i<ndim;i++){ dims.emplace_back(i); }
+    dims[axis1] = axis2;
+    dims[axis2] = axis1;
+    return dims;
+}
+
+
 void Tensor::permute_(const vector<int>& dims){
     Tensor* temp = Tensor::permute(this, dims);
-    this->deleteData();
-    this->ptr = temp->ptr;
+
+    if (!this->isFPGA() && this->mmap_base == nullptr) {
+        // Take the permuted buffer and let temp release the old one
+        std::swap(this->ptr, temp->ptr);
+        updateShape(temp->shape);
+        updateSize();
+        updateStrides();
+        updateData(this->ptr);  // Due to the Eigen mapping
+    } else {
+        this->reshape_(temp->shape);
+        Tensor::copy(temp, this);
+    }
+    delete temp;
 }
 
 
 Tensor* Tensor::permute(Tensor* A, const vector<int>& dims){
+    // Check values
+    vector<bool> seen(A->ndim, false);
+    if(dims.size() != A->ndim){
+        msg("Dimensions do not match", "Tensor::permute");
+    }
+    for(auto &d : dims){
+        if(d<0 || d>=A->ndim || seen[d]){
+            msg("Invalid permutation", "Tensor::permute");
+        }
+        seen[d] = true;
+    }
+
+    if (A->isCPU()) {
+        auto *new_t = new Tensor(permute_shape(A->shape, dims), A->device);
+        cpu_permute(A, new_t, dims);
+        return new_t;
+    }
+
     // Build descriptor
     auto *sd = new PermuteDescriptor(dims, A->device);
     sd->build(A->shape);
@@ -70,59 +137,22 @@ Tensor* Tensor::permute(Tensor* A, const vector<int>& dims){
 
 
 void Tensor::moveaxis_(int source, int destination){
-    Tensor* temp = Tensor::moveaxis(this, source, destination);
-    this->deleteData();
-    this->ptr = temp->ptr;
+    this->permute_(moveaxis_dims(this->ndim, source, destination));
 }
 
 
 Tensor* Tensor::moveaxis(Tensor* A, int source, int destination){
-    // Check values
-    if(source<-1 || destination <-1){
-        msg("Invalid axis", "Tensor::moveaxis");
-    }
-
-    // User "-1" as alias for the last dimension
-    if(source == -1){source = A->ndim-1; }
-    if(destination == -1){destination = A->ndim-1; }
-
-    // Build axes to permute [1 => 3] => (0,1,2,3) => (0,2,3,1)
-    vector<int> dims;
-    dims.reserve(A->ndim);
-    for(int i=0; i<A->ndim;i++){
-        dims.push_back(i);
-    }
-    dims.erase(dims.begin()+source);  // Remove axis
-    dims.insert(dims.begin() + destination, source);  // Insert at final position
-
-    // Permute tensor
-    Tensor* t2 = Tensor::permute(A, dims);
-    return t2;
+    return Tensor::permute(A, moveaxis_dims(A->ndim, source, destination));
 }
 
 
 void Tensor::swapaxis_(int axis1, int axis2){
-    Tensor* temp = Tensor::swapaxis(this, axis1, axis2);
-    this->deleteData();
-    this->ptr = temp->ptr;
+    this->permute_(swapaxis_dims(this->ndim, axis1, axis2));
 }
 
 
 Tensor* Tensor::swapaxis(Tensor* A, int axis1, int axis2){
-    // Check values
-    if(axis1<-1 || axis2 <-1 || axis1 == axis2){
-        msg("Invalid axis", "Tensor::swapaxis");
-    }
-
-    // Build axes to permute [0, 3] => (0,1,2,3) => (3,1,2,0)
-    vector<int> dims;
-    for(int i=0; i<A->ndim;i++){ dims.emplace_back(i); }
-    dims[axis1] = axis2;
-    dims[axis2] = axis1;
-
-    // Permute tensor
-    Tensor* t2 = Tensor::permute(A, dims);
-    return t2;
+    return Tensor::permute(A, swapaxis_dims(A->ndim, axis1, axis2));
 }
 
 
@@ -84,11 +84,10 @@ int * get_reduction_map(Tensor *A, vector<int> axis)
 }
 
 
-void reduce(Tensor *A, Tensor *B,string mode,vector<int> axis,int* map)
+static void check_reduce(Tensor *A, Tensor *B, const vector<int> &axis)
 {
   int i,j;
 
-
   if (B->ndim!=A->ndim-axis.size())
     msg("dims don't match in reduction","reduce");
 
@@ -101,21 +100,27 @@ void reduce(Tensor *A, Tensor *B,string mode,vector<int> axis,int* map)
       j++;
      }
   }
+}
 
-  if (map==nullptr)
-    map=get_reduction_map(A,axis);
+void reduce(Tensor *A, Tensor *B,string mode,vector<int> axis,int* map)
+{
+  check_reduce(A,B,axis);
+  int m=reduce_mode(mode);
 
   if (A->isCPU()) {
-      cpu_reduce(A,B,mode,map);
+      cpu_reduce(A,B,axis,m);
     }
   #ifdef cGPU
   else if (A->isGPU()) {
+      bool own=(map==nullptr);
+      if (own) map=get_reduction_map(A,axis);
       gpu_reduce(A,B,mode,map);
+      if (own) free(map);
     }
   #endif
   #ifdef cFPGA
   else if (A->isFPGA()) {
-    fpga_reduce(A,B,mode,map);
+    fpga_reduce(A,B,m,axis);
   }
   #endif
 }
@@ -141,7 +146,7 @@ void reduce_min(Tensor *A, Tensor *B,vector<int> axis,int* map)
 void reduce(Tensor *A, Tensor *B,string mode,MapReduceDescriptor *MD)
 {
   if (A->isCPU()) {
-      cpu_reduce(A,B,mode,MD);
+      cpu_reduce(A,B,MD->axis,reduce_mode(mode));
     }
   #ifdef cGPU
   else if (A->isGPU()) {
@@ -150,7 +155,7 @@ void reduce(Tensor *A, Tensor *B,string mode,MapReduceDescriptor *MD)
   #endif
   #ifdef cFPGA
   else if (A->isFPGA()) {
-      fpga_reduce(A,B,mode,MD);
+      fpga_reduce(A,B,reduce_mode(mode),MD->axis);
   }
   #endif
 }
@@ -160,14 +165,14 @@ void reduce_mean(Tensor *A, Tensor *B,MapReduceDescriptor *MD){
   reduce(A,B,"mean",MD);
 }
 void reduce_variance(Tensor *A, Tensor *B,MapReduceDescriptor *MD){
-  reduce(A,B,"mean",MD);
+  reduce(A,B,"variance",MD);
 }
 void reduce_max(Tensor *A, Tensor *B,MapReduceDescriptor *MD){
-  reduce(A,B,"mean",MD);
+  reduce(A,B,"max",MD);
 }
 void reduce_min(Tensor *A, Tensor *B,MapReduceDescriptor *MD)
 {
-  reduce(A,B,"mean",MD);
+  reduce(A,B,"min",MD);
 }
 
 
@@ -177,36 +182,23 @@ void reduce_min(Tensor *A, Tensor *B,MapReduceDescriptor *MD)
 ////////////////////////////////////////////////////////
 void reduce_op(Tensor *A, Tensor *B,string op,vector<int> axis,int* map)
 {
-  int i,j;
-
-
-
-  if (B->ndim!=A->ndim-axis.size())
-    msg("dims don't match in reduction","reduce");
-
-    j=0;
-    for(i=0;i<A->ndim;i++) {
-      bool isFound = find(axis.begin(), axis.end(), i) != axis.end();
-      if (!isFound) {
-        if (B->shape[j]!=A->shape[i])
-         msg("shapes don't match in reduction","reduce");
-        j++;
-       }
-    }
-  if (map==nullptr)
-    map=get_reduction_map(A,axis);
+  check_reduce(A,B,axis);
+  int o=reduce_op_mode(op);
 
   if (A->isCPU()) {
-      cpu_reduce_op(A,B,op,map);
+      cpu_reduce_op(A,B,axis,o);
     }
   #ifdef cGPU
   else if (A->isGPU()) {
+      bool own=(map==nullptr);
+      if (own) map=get_reduction_map(A,axis);
       gpu_reduce_op(A,B,op,map);
+      if (own) free(map);
     }
   #endif
   #ifdef cFPGA
   else if (A->isFPGA()) {
-      fpga_reduce_op(A,B,op,map);
+      fpga_reduce_op(A,B,o,axis);
   }
   #endif
 }
@@ -231,7 +223,7 @@ void reduce_div(Tensor *A, Tensor *B,vector<int> axis,int* map)
  void reduce_op(Tensor *A, Tensor *B,string op, MapReduceDescriptor *MD)
 {
   if (A->isCPU()) {
-    cpu_reduce_op(A,B,op,MD);
+    cpu_reduce_op(A,B,MD->axis,reduce_op_mode(op));
   }
   #ifdef cGPU
   else if (A->isGPU()) {
@@ -240,7 +232,7 @@ void reduce_div(Tensor *A, Tensor *B,vector<int> axis,int* map)
   #endif
   #ifdef cFPGA
     else if (A->isFPGA()) {
-    fpga_reduce_op(A,B,op,MD);
+    fpga_reduce_op(A,B,reduce_op_mode(op),MD->axis);
   }
   #endif
 
@@ -260,8 +252,6 @@ void reduce_div(Tensor *A, Tensor *B,vector<int> axis,int* map)
 }
 
 
-
-////////////
 void reduction(ReduceDescriptor *RD){
 
     if (RD->I->isCPU()) {
@@ -13,6 +13,15 @@
 #include "eddl/hardware/cpu/cpu_tensor.h"
 #include "eddl/utils.h"
 #include "eddl/helpers.h"
+#include "eddl/system_info.h"
+
+#if defined(EDDL_LINUX) || defined(EDDL_UNIX) || defined(EDDL_APPLE)
+#define EDDL_MMAP
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 #ifdef cGPU
 #include "eddl/hardware/gpu/gpu_tensor.h"
@@ -87,7 +96,7 @@ Tensor* Tensor::load_from_bin(std::ifstream &ifs){
     ifs.read(reinterpret_cast<char *>(r_shape.data()), r_ndim * sizeof(int));
 
     // Compute total size
-    int r_size = 1;
+    unsigned long int r_size = 1;
     for(int i=0; i<r_ndim; i++){ r_size *= r_shape[i]; }
 
     // Load content (row-major)
@@ -100,6 +109,52 @@ Tensor* Tensor::load_from_bin(std::ifstream &ifs){
     return t1;
 }
 
+Tensor* Tensor::load_mmap(const string& filename){
+#ifdef EDDL_MMAP
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        msg("File not found. Check the file name and try again.", "Tensor::load_mmap");
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(int)) {
+        close(fd);
+        msg("Invalid bin file", "Tensor::load_mmap");
+    }
+    size_t length = st.st_size;
+
+    // Private mapping: pages are shared with the page cache until written
+    void *base = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);  // The mapping keeps its own reference
+    if (base == MAP_FAILED) {
+        msg("Unable to map " + filename, "Tensor::load_mmap");
+    }
+
+    // Same layout as save2bin: ndim, shape, data (row-major)
+    int r_ndim = *((int *)base);
+    size_t header = sizeof(int) * (1 + (size_t)r_ndim);
+    if ((r_ndim <= 0) || (header > length)) {
+        munmap(base, length);
+        msg("Invalid bin file", "Tensor::load_mmap");
+    }
+
+    vector<int> r_shape((int *)base + 1, (int *)base + 1 + r_ndim);
+    unsigned long int r_size = 1;
+    for(int i=0; i<r_ndim; i++){ r_size *= r_shape[i]; }
+    if (header + r_size * sizeof(float) > length) {
+        munmap(base, length);
+        msg("Truncated bin file", "Tensor::load_mmap");
+    }
+
+    auto *t1 = new Tensor(r_shape, (float *)((char *)base + header), DEV_CPU);
+    t1->mmap_base = base;
+    t1->mmap_length = length;
+    return t1;
+#else
+    return Tensor::load(filename, "bin");
+#endif
+}
+
 Tensor* Tensor::load_from_onnx(std::ifstream &ifs){
     msg("Not implemented", "Tensor::load_from_onnx");
 
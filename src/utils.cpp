@@ -29,6 +29,7 @@
 
 #include "eddl/system_info.h"
 #include "eddl/utils.h"
+#include "eddl/hardware/cpu/cpu_allocator.h"
 
 #ifdef EDDL_LINUX
 #include "sys/mman.h"
@@ -65,37 +66,14 @@ void msg(const string& text, const string& title) {
 
 
 float *get_fmem(unsigned long int size, const string &str){
+    // Blocks come from the caching allocator (cpu_allocator.h), which only
+    // checks the free memory when it has to ask the system for a new block.
     // Careful with memory overcommitment:
     // https://stackoverflow.com/questions/48585079/malloc-on-linux-without-overcommitting
-    // TODO: This function does not work properly (...but it does, at least most of the time -for linux and mac-)
-    float* ptr = nullptr;
-    bool error = false;
+    float* ptr = fmem_alloc(size);
 
-
-    // Check if free memory is bigger than requested
-    unsigned long freemem = get_free_mem();
-    if (size*sizeof(float) > freemem) {
-        error=true;
-    }
-
-    // New vs Malloc *******************
-    // New is the C++ way of doing it
-    // New is type-safe, Malloc is not
-    // New calls your type constructor, Malloc not - Same for destructor
-    // New is an operator, Malloc a function (slower)
-    try{
-        ptr = new float[size];
-        //ptr=(float *)malloc(size*sizeof(float));
-        //ptr=aligned_alloc(64, size*sizeof(float));
-    }
-    catch (std::bad_alloc& badAlloc){
-        error=true;
-    }
-
-    // Check for errors
     // Not enough free memory
-    if (error) {
-        delete ptr;
+    if (ptr == nullptr) {
         throw std::runtime_error("Error allocating " + string(bytes2human(size * sizeof(float))) + " in " + string(str));
     }
 
@@ -103,6 +81,12 @@ float *get_fmem(unsigned long int size, const string &str){
 }
 
 
+void free_fmem(float *ptr){
+    // Tensors also adopt buffers created with new[] (loaders, user pointers)
+    if (ptr != nullptr && !fmem_free(ptr)) delete[] ptr;
+}
+
+
 string bytes2human(unsigned long long int bytes, int decimals){
     vector<string> prefix = {"B", "KB", "MB", "GB", "TB", "PB", "EB", "ZB", "YB"};
     double size = 0;
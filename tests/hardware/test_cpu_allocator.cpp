@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <thread>
+
+#include "eddl/hardware/cpu/cpu_allocator.h"
+#include "eddl/tensor/tensor.h"
+
+using namespace std;
+
+
+TEST(CPUAllocatorTestSuite, aligned_and_cached)
+{
+    // Odd sizes, all aligned
+    for (size_t n : {1, 3, 17, 100, 1000, 12345}) {
+        float *p = fmem_alloc(n);
+        ASSERT_NE(p, nullptr);
+        ASSERT_EQ((uintptr_t) p % FMEM_ALIGN, 0);
+        for (size_t i = 0; i < n; i++) p[i] = (float) i;
+        ASSERT_TRUE(fmem_free(p));
+    }
+
+    // A block of the same class comes back from the cache
+    float *a = fmem_alloc(5000);
+    ASSERT_TRUE(fmem_free(a));
+    FmemStats before = fmem_stats();
+    float *b = fmem_alloc(4900);
+    FmemStats after = fmem_stats();
+    ASSERT_EQ(a, b);
+    ASSERT_EQ(after.hits, before.hits + 1);
+    ASSERT_EQ(after.refills, before.refills);
+    ASSERT_TRUE(fmem_free(b));
+
+    // Tensor storage takes the same path
+    before = fmem_stats();
+    Tensor *t = new Tensor({7, 11});
+    delete t;
+    t = new Tensor({11, 7});
+    after = fmem_stats();
+    ASSERT_GE(after.hits, before.hits + 1);
+    delete t;
+}
+
+
+TEST(CPUAllocatorTestSuite, foreign_pointers)
+{
+    float *p = new float[64];
+    ASSERT_FALSE(fmem_free(p));
+    ASSERT_FALSE(fmem_free(nullptr));
+
+    // Tensors adopting new[] buffers still release them
+    Tensor *t = new Tensor({8, 8}, p, DEV_CPU);
+    delete t;
+}
+
+
+TEST(CPUAllocatorTestSuite, cross_thread_free_and_trim)
+{
+    float *p = nullptr;
+    thread producer([&p]() { p = fmem_alloc(3000); });
+    producer.join();
+    ASSERT_NE(p, nullptr);
+    ASSERT_TRUE(fmem_free(p));
+
+    // Blocks cached by a finished thread go to the shared cache
+    thread worker([]() {
+        float *q = fmem_alloc(70000);
+        fmem_free(q);
+    });
+    worker.join();
+    FmemStats before = fmem_stats();
+    float *r = fmem_alloc(70000);
+    ASSERT_EQ(fmem_stats().hits, before.hits + 1);
+    fmem_free(r);
+
+    fmem_trim();
+    FmemStats st = fmem_stats();
+    ASSERT_EQ(st.bytes_cached, 0);
+    ASSERT_GT(st.releases, 0);
+    ASSERT_LE(st.bytes_in_use, st.peak_bytes_in_use);
+}
@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "eddl/hardware/host_mirror.h"
+
+using namespace std;
+
+
+// Device buffer with its host copy, as an FPGA tensor. An alias shares the
+// buffer, the host copy and the mirror, as a reshape does
+struct MockTensor {
+    MockDeviceMemory *mem;
+    void *buf;
+    float *host;
+    long n;
+    HostMirror *mirror;
+    bool owner;
+
+    MockTensor(MockDeviceMemory *mem, const vector<float> &v) : mem(mem), n(v.size()), owner(true) {
+        host = new float[n]();
+        buf = mem->create(n);
+        mem->write(buf, v.data(), n);
+        mirror = new HostMirror();
+    }
+    explicit MockTensor(MockTensor *T) : mem(T->mem), buf(T->buf), host(T->host), n(T->n), mirror(T->mirror), owner(false) {}
+    ~MockTensor() {
+        if (!owner) return;
+        mem->destroy(buf);
+        delete[] host;
+        delete mirror;
+    }
+
+    long size() { return n; }
+    void host_read() { mirror->host_read(mem, buf, host, size()); }
+    void host_write() { mirror->host_write(host, size()); }
+    void device_read() { mirror->device_read(mem, buf, host, size()); }
+
+    // As fpga_kernel_in / fpga_kernel_out
+    float *kernel_in() { device_read(); return (float *) buf; }
+    float *kernel_out() { device_read(); mirror->device_write(); return (float *) buf; }
+};
+
+// Host fallback of an elementwise op: B = A * k + 1
+static void fallback_op(MockTensor &A, MockTensor &B, float k) {
+    A.host_read();
+    for (int i = 0; i < A.size(); i++) B.host[i] = A.host[i] * k + 1.0f;
+    B.host_write();
+}
+
+// Device kernel: B = A + A (on the device buffers)
+static void device_op(MockTensor &A, MockTensor &B) {
+    float *a = A.kernel_in(), *b = B.kernel_out();
+    for (int i = 0; i < A.size(); i++) b[i] = a[i] + a[i];
+}
+
+
+TEST(HostMirrorTestSuite, fallback_chain_transfers) {
+    MockDeviceMemory mem;
+    MockTensor A(&mem, {1.0f, 2.0f, 3.0f, 4.0f});
+    MockTensor B(&mem, vector<float>(4, 0.0f));
+    MockTensor C(&mem, vector<float>(4, 0.0f));
+    A.mirror->device_write();  // data only on the device
+    mem.reset_counters();
+
+    // Four fallbacks in a row: one read of A, nothing else
+    fallback_op(A, B, 2.0f);
+    fallback_op(B, C, 3.0f);
+    fallback_op(C, B, 0.5f);
+    fallback_op(B, C, 1.0f);
+    ASSERT_EQ(mem.reads, 1);
+    ASSERT_EQ(mem.writes, 0);
+    ASSERT_EQ(C.mirror->state, MIRROR_HOST);
+
+    // A device kernel flushes only the dirty input
+    device_op(C, A);
+    ASSERT_EQ(mem.writes, 1);
+    ASSERT_EQ(mem.bytes_written, 4 * sizeof(float));
+
+    // Reading the result brings it back once
+    float out[4];
+    A.mirror->host_read(&mem, A.buf, A.host, A.size(), out);
+    A.mirror->host_read(&mem, A.buf, A.host, A.size(), out);
+    ASSERT_EQ(mem.reads, 2);
+    for (int i = 0; i < 4; i++) {
+        float x = i + 1.0f;
+        float c = ((x * 2.0f + 1.0f) * 3.0f + 1.0f) * 0.5f + 1.0f + 1.0f;
+        ASSERT_FLOAT_EQ(out[i], 2.0f * c);
+    }
+}
+
+
+TEST(HostMirrorTestSuite, states) {
+    MockDeviceMemory mem;
+    MockTensor A(&mem, {5.0f, 6.0f});
+    mem.reset_counters();
+
+    // Shared data need no transfer in any direction
+    A.host_read();
+    A.device_read();
+    ASSERT_EQ(mem.reads + mem.writes, 0);
+
+    // Writing from another host buffer only touches the host copy
+    float src[2] = {7.0f, 8.0f};
+    A.mirror->host_write(A.host, 2, src);
+    ASSERT_EQ(A.host[1], 8.0f);
+    ASSERT_EQ(mem.writes, 0);
+    A.device_read();
+    ASSERT_EQ(((float *) A.buf)[0], 7.0f);
+    ASSERT_EQ(A.mirror->state, MIRROR_SHARED);
+}
+
+
+TEST(HostMirrorTestSuite, kernel_inputs_stay_shared) {
+    MockDeviceMemory mem;
+    MockTensor A(&mem, {1.0f, 2.0f});
+    MockTensor B(&mem, {0.0f, 0.0f});
+    mem.reset_counters();
+
+    // Only the output has to come back after a kernel
+    device_op(A, B);
+    ASSERT_EQ(A.mirror->state, MIRROR_SHARED);
+    ASSERT_EQ(B.mirror->state, MIRROR_DEVICE);
+    A.host_read();
+    B.host_read();
+    ASSERT_EQ(mem.reads, 1);
+    ASSERT_EQ(B.host[1], 4.0f);
+}
+
+
+TEST(HostMirrorTestSuite, aliases_share_state) {
+    MockDeviceMemory mem;
+    MockTensor A(&mem, {1.0f, 2.0f, 3.0f});
+    MockTensor R(&A);  // reshape of A
+    MockTensor C(&mem, vector<float>(3, 0.0f));
+    A.host_read();
+    mem.reset_counters();
+
+    // A kernel writing through the alias invalidates the host copy of A
+    device_op(C, R);
+    ASSERT_EQ(A.mirror->state, MIRROR_DEVICE);
+    A.host_read();
+    ASSERT_EQ(mem.reads, 1);
+    ASSERT_EQ(A.host[2], 0.0f);
+
+    // A host write through A reaches a kernel reading the alias
+    A.host[0] = 5.0f;
+    A.host_write();
+    device_op(R, C);
+    ASSERT_EQ(mem.writes, 1);
+    ASSERT_EQ(((float *) C.buf)[0], 10.0f);
+}
@@ -1,7 +1,15 @@
 #include <gtest/gtest.h>
 #include <string>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "eddl/tensor/tensor.h"
+#include "eddl/tensor/nn/tensor_nn.h"
 #include "eddl/descriptors/descriptors.h"
+#include "eddl/hardware/cpu/nn/cpu_tensor_nn.h"
+#include "eddl/hardware/cpu/cpu_allocator.h"
 
 
 using namespace std;
@@ -43,3 +51,286 @@ TEST(Convol2DTestSuite, output_size)
         }
     }
 }
+
+
+TEST(Convol2DTestSuite, conv2d_grad_threads)
+{
+    int batch = 5, iz = 2, ir = 6, ic = 5, nk = 3;
+    auto *t_input = Tensor::randn({batch, iz, ir, ic});
+
+    auto *cd = new ConvolDescriptor(nk, {3, 3}, {1, 1}, "same", true);
+    cd->build(t_input);
+    cd->K->rand_normal(0.0f, 1.0f);
+    cd->bias->fill_(0.0f);
+    cd->gK->fill_(0.0f);
+    cd->gbias->fill_(0.0f);
+    cd->ID = Tensor::zeros(cd->I->getShape());
+    cd->D = Tensor::randn(cd->O->getShape());
+
+#ifdef _OPENMP
+    int nth = omp_get_max_threads();
+    omp_set_num_threads(4);
+#endif
+    tensorNN::Conv2D_grad(cd);
+#ifdef _OPENMP
+    omp_set_num_threads(nth);
+#endif
+
+    // Direct computation
+    for (int k = 0; k < nk; k++) {
+        float gb = 0.0f;
+        for (int b = 0; b < batch; b++)
+            for (int r = 0; r < cd->r; r++)
+                for (int c = 0; c < cd->c; c++)
+                    gb += cd->D->ptr[((b * nk + k) * cd->r + r) * cd->c + c];
+        ASSERT_NEAR(cd->gbias->ptr[k], gb, 1e-3f);
+
+        for (int z = 0; z < iz; z++)
+            for (int i = 0; i < 3; i++)
+                for (int j = 0; j < 3; j++) {
+                    float g = 0.0f;
+                    for (int b = 0; b < batch; b++)
+                        for (int r = 0; r < cd->r; r++)
+                            for (int c = 0; c < cd->c; c++) {
+                                int y = r + i - cd->padrt;
+                                int x = c + j - cd->padcl;
+                                if (y < 0 || y >= ir || x < 0 || x >= ic) continue;
+                                g += cd->D->ptr[((b * nk + k) * cd->r + r) * cd->c + c] *
+                                     t_input->ptr[((b * iz + z) * ir + y) * ic + x];
+                            }
+                    ASSERT_NEAR(cd->gK->ptr[((k * iz + z) * 3 + i) * 3 + j], g, 1e-3f);
+                }
+    }
+}
+
+
+TEST(Convol2DTestSuite, conv2d_tiled_workspace)
+{
+    int batch = 2, iz = 3, ir = 9, ic = 7, nk = 4;
+    vector<string> paddings = {"same", "valid"};
+    vector<vector<int>> strides = {{1, 1}, {2, 2}, {2, 1}};
+    long int limit = cpu_get_conv_workspace();
+
+    for (auto &p : paddings)
+    for (auto &st : strides) {
+        auto *t_input = Tensor::randn({batch, iz, ir, ic});
+        auto *cd = new ConvolDescriptor(nk, {3, 3}, st, p, true);
+        cd->build(t_input);
+        cd->K->rand_normal(0.0f, 1.0f);
+        cd->bias->rand_normal(0.0f, 1.0f);
+        cd->gK->fill_(0.0f);
+        cd->gbias->fill_(0.0f);
+        cd->ID = Tensor::zeros(cd->I->getShape());
+        cd->D = Tensor::randn(cd->O->getShape());
+
+        // Workspace smaller than a single output row: tiles of a few positions
+        cpu_set_conv_workspace(4 * sizeof(float) * 3 * 3 * iz);
+        tensorNN::Conv2D(cd);
+        tensorNN::Conv2D_grad(cd);
+        tensorNN::Conv2D_back(cd);
+        cpu_set_conv_workspace(limit);
+
+        for (int b = 0; b < batch; b++)
+        for (int k = 0; k < nk; k++)
+        for (int r = 0; r < cd->r; r++)
+        for (int c = 0; c < cd->c; c++) {
+            float o = cd->bias->ptr[k];
+            float d = cd->D->ptr[((b * nk + k) * cd->r + r) * cd->c + c];
+            for (int z = 0; z < iz; z++)
+            for (int i = 0; i < 3; i++)
+            for (int j = 0; j < 3; j++) {
+                int y = r * cd->sr + i - cd->padrt;
+                int x = c * cd->sc + j - cd->padcl;
+                if (y < 0 || y >= ir || x < 0 || x >= ic) continue;
+                int pi = ((b * iz + z) * ir + y) * ic + x;
+                int pk = ((k * iz + z) * 3 + i) * 3 + j;
+                o += cd->K->ptr[pk] * t_input->ptr[pi];
+                // Undo the contributions to the gradients: they must end at zero
+                cd->gK->ptr[pk] -= d * t_input->ptr[pi];
+                cd->ID->ptr[pi] -= d * cd->K->ptr[pk];
+            }
+            ASSERT_NEAR(cd->O->ptr[((b * nk + k) * cd->r + r) * cd->c + c], o, 1e-3f);
+        }
+
+        for (int i = 0; i < cd->gK->size; i++) ASSERT_NEAR(cd->gK->ptr[i], 0.0f, 1e-3f);
+        for (int i = 0; i < cd->ID->size; i++) ASSERT_NEAR(cd->ID->ptr[i], 0.0f, 1e-3f);
+
+        delete t_input;
+    }
+}
+
+
+TEST(Convol2DTestSuite, conv2d_algorithms)
+{
+    struct shape { int k; string padding; int expected; };
+    vector<shape> shapes = {
+            {1, "same", CONV_ALGO_GEMM1X1},
+            {3, "same", CONV_ALGO_WINOGRAD},
+            {3, "valid", CONV_ALGO_WINOGRAD},
+    };
+
+    for (auto &s : shapes) {
+        auto *t_input = Tensor::randn({3, 8, 7, 9});
+
+        auto *cd = new ConvolDescriptor(10, {s.k, s.k}, {1, 1}, s.padding, true);
+        auto *ref = new ConvolDescriptor(10, {s.k, s.k}, {1, 1}, s.padding, true);
+        cd->build(t_input);
+        ref->build(t_input);
+        ASSERT_EQ(cd->algo, s.expected);
+        ref->algo = CONV_ALGO_IM2COL;
+
+        cd->K->rand_normal(0.0f, 1.0f);
+        cd->bias->rand_normal(0.0f, 1.0f);
+        Tensor::copy(cd->K, ref->K);
+        Tensor::copy(cd->bias, ref->bias);
+        for (auto *d : {cd, ref}) {
+            d->gK->fill_(0.0f);
+            d->gbias->fill_(0.0f);
+            d->ID = Tensor::zeros(d->I->getShape());
+        }
+        cd->D = Tensor::randn(cd->O->getShape());
+        ref->D = cd->D;
+
+        for (auto *d : {cd, ref}) {
+            tensorNN::Conv2D(d);
+            tensorNN::Conv2D_grad(d);
+            tensorNN::Conv2D_back(d);
+        }
+
+        for (int i = 0; i < cd->O->size; i++) ASSERT_NEAR(cd->O->ptr[i], ref->O->ptr[i], 1e-3f);
+        for (int i = 0; i < cd->gK->size; i++) ASSERT_NEAR(cd->gK->ptr[i], ref->gK->ptr[i], 1e-2f);
+        for (int i = 0; i < cd->ID->size; i++) ASSERT_NEAR(cd->ID->ptr[i], ref->ID->ptr[i], 1e-3f);
+
+        delete t_input;
+    }
+}
+
+
+TEST(Convol2DTestSuite, conv2d_grouped_dilated)
+{
+    int batch = 2, iz = 4, ir = 9, ic = 8, nk = 8;
+    vector<int> groups = {1, 2, 4};
+    vector<int> dilations = {1, 2};
+    vector<string> paddings = {"same", "valid"};
+
+    for (int gr : groups)
+    for (int dl : dilations)
+    for (auto &p : paddings) {
+        auto *t_input = Tensor::randn({batch, iz, ir, ic});
+        auto *cd = new ConvolDescriptor(nk, {3, 3}, {1, 2}, p, true, gr, {dl, dl});
+        cd->build(t_input);
+        if (gr == iz) ASSERT_EQ(cd->algo, CONV_ALGO_DEPTHWISE);
+
+        int kz = iz / gr, nkg = nk / gr;
+        ASSERT_EQ(cd->K->shape[1], kz);
+
+        cd->K->rand_normal(0.0f, 1.0f);
+        cd->bias->rand_normal(0.0f, 1.0f);
+        cd->gK->fill_(0.0f);
+        cd->gbias->fill_(0.0f);
+        cd->ID = Tensor::zeros(cd->I->getShape());
+        cd->D = Tensor::randn(cd->O->getShape());
+
+        tensorNN::Conv2D(cd);
+        tensorNN::Conv2D_grad(cd);
+        tensorNN::Conv2D_back(cd);
+
+        for (int b = 0; b < batch; b++)
+        for (int k = 0; k < nk; k++)
+        for (int r = 0; r < cd->r; r++)
+        for (int c = 0; c < cd->c; c++) {
+            float o = cd->bias->ptr[k];
+            float d = cd->D->ptr[((b * nk + k) * cd->r + r) * cd->c + c];
+            for (int z = 0; z < kz; z++)
+            for (int i = 0; i < 3; i++)
+            for (int j = 0; j < 3; j++) {
+                int y = r * cd->sr + i * dl - cd->padrt;
+                int x = c * cd->sc + j * dl - cd->padcl;
+                if (y < 0 || y >= ir || x < 0 || x >= ic) continue;
+                int pi = ((b * iz + (k / nkg) * kz + z) * ir + y) * ic + x;
+                int pk = ((k * kz + z) * 3 + i) * 3 + j;
+                o += cd->K->ptr[pk] * t_input->ptr[pi];
+                cd->gK->ptr[pk] -= d * t_input->ptr[pi];
+                cd->ID->ptr[pi] -= d * cd->K->ptr[pk];
+            }
+            ASSERT_NEAR(cd->O->ptr[((b * nk + k) * cd->r + r) * cd->c + c], o, 1e-3f);
+        }
+
+        for (int i = 0; i < cd->gK->size; i++) ASSERT_NEAR(cd->gK->ptr[i], 0.0f, 1e-3f);
+        for (int i = 0; i < cd->ID->size; i++) ASSERT_NEAR(cd->ID->ptr[i], 0.0f, 1e-3f);
+
+        delete t_input;
+    }
+}
+
+
+TEST(Convol2DTestSuite, descriptor_frees_work_buffers)
+{
+    auto *t_input = Tensor::randn({4, 8, 8, 8});
+    vector<ConvolDescriptor *> cds;
+    for (int i = 0; i < 2; i++) {
+        auto *cd = new ConvolDescriptor(8, {3, 3}, {1, 1}, "same", true);
+        cd->build(t_input);
+        ASSERT_EQ(cd->algo, CONV_ALGO_WINOGRAD);
+        cd->K->rand_normal(0.0f, 1.0f);
+        cd->D = Tensor::randn(cd->O->getShape());
+        cds.push_back(cd);
+    }
+
+#ifdef _OPENMP
+    int nth = omp_get_max_threads();
+    omp_set_num_threads(4);
+#endif
+    // The first one sizes the shared workspace
+    tensorNN::Conv2D(cds[0]);
+    tensorNN::Conv2D_grad(cds[0]);
+    unsigned long long before = fmem_stats().bytes_in_use;
+    tensorNN::Conv2D(cds[1]);
+    tensorNN::Conv2D_grad(cds[1]);
+#ifdef _OPENMP
+    omp_set_num_threads(nth);
+    ASSERT_NE(cds[1]->ptrgKt, nullptr);
+#endif
+    ASSERT_NE(cds[1]->ptrU, nullptr);
+
+    // The tensors belong to the layer: keep them alive
+    vector<Tensor *> tensors = {cds[1]->O, cds[1]->K, cds[1]->bias, cds[1]->gK, cds[1]->gbias, cds[1]->D};
+    delete cds[1];
+    ASSERT_EQ(fmem_stats().bytes_in_use, before);
+
+    for (auto *t : tensors) delete t;
+    delete t_input;
+}
+
+
+TEST(Convol2DTestSuite, winograd_kernels_cached)
+{
+    auto *t_input = Tensor::randn({2, 8, 6, 6});
+    auto *cd = new ConvolDescriptor(8, {3, 3}, {1, 1}, "same", false);
+    cd->build(t_input);
+    ASSERT_EQ(cd->algo, CONV_ALGO_WINOGRAD);
+    cd->K->rand_normal(0.0f, 1.0f);
+
+    tensorNN::Conv2D(cd);
+    Tensor *ref = cd->O->clone();
+
+    // Training: the kernels are transformed again
+    cd->K->mult_(2.0f);
+    tensorNN::Conv2D(cd);
+    for (int i = 0; i < ref->size; i++) ASSERT_NEAR(cd->O->ptr[i], 2.0f * ref->ptr[i], 1e-3f);
+    ASSERT_FALSE(cd->valid_U);
+
+    // Inference: once, until the kernels are invalidated
+    cd->keep_U = true;
+    tensorNN::Conv2D(cd);
+    ASSERT_TRUE(cd->valid_U);
+    cd->K->mult_(0.5f);
+    tensorNN::Conv2D(cd);
+    for (int i = 0; i < ref->size; i++) ASSERT_NEAR(cd->O->ptr[i], 2.0f * ref->ptr[i], 1e-3f);
+    cd->valid_U = false;
+    tensorNN::Conv2D(cd);
+    for (int i = 0; i < ref->size; i++) ASSERT_NEAR(cd->O->ptr[i], ref->ptr[i], 1e-3f);
+
+    delete ref;
+    delete t_input;
+}
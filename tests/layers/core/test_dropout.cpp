@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+
+#include "eddl/tensor/tensor.h"
+#include "eddl/layers/core/layer_core.h"
+
+
+using namespace std;
+
+
+TEST(DropoutTestSuite, bit_packed_mask)
+{
+    vector<int> shape = {7, 45};  // not a multiple of 32
+    Tensor *x = Tensor::randu({7, 45});
+    x->add_(0.5f);  // no zeros
+    Tensor *dy = Tensor::randn(shape);
+
+    auto *in = new LInput(x->clone(), "in", DEV_CPU, 0);
+    in->delta = Tensor::zeros(shape);
+    auto *drop = new LDropout(in, 0.25f, true, "drop", DEV_CPU, 0);
+    ASSERT_EQ(drop->mask, nullptr);
+    drop->delta = dy->clone();
+    drop->mode = TRMODE;
+
+    drop->forward();
+    drop->backward();
+
+    int kept = 0;
+    for (int i = 0; i < x->size; i++) {
+        bool bit = (drop->mask_bits[i / 32] >> (i % 32)) & 1u;
+        kept += bit;
+        ASSERT_EQ(drop->output->ptr[i], bit ? x->ptr[i] : 0.0f);
+        ASSERT_EQ(in->delta->ptr[i], bit ? dy->ptr[i] : 0.0f);
+    }
+    ASSERT_GT(kept, 0.6 * x->size);
+    ASSERT_LT(kept, 0.9 * x->size);
+
+    // Inference weighting
+    drop->mode = TSMODE;
+    drop->forward();
+    for (int i = 0; i < x->size; i++) ASSERT_FLOAT_EQ(drop->output->ptr[i], 0.75f * x->ptr[i]);
+
+    delete x;
+    delete dy;
+}
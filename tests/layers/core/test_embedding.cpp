@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include <cmath>
+
+#include "eddl/apis/eddl.h"
+
+using namespace eddl;
+
+
+static void check_sparse_update(Optimizer *opt)
+{
+    int vocsize = 500, dim = 4;
+    layer in = Input({3});
+    layer e = Embedding(in, vocsize, 3, dim);
+    layer out = Softmax(Dense(e, 2));
+    model net = Model({in}, {out});
+    build(net, opt, {"soft_cross_entropy"}, {"categorical_accuracy"}, CS_CPU(1), true);
+
+    Tensor *x = new Tensor({4, 3});
+    float words[] = {3, 7, 3, 10, 499, 7, 3, 3, 3, 42, 7, 10};
+    for (int i = 0; i < 12; i++) x->ptr[i] = words[i];
+    Tensor *y = Tensor::zeros({4, 2});
+    for (int i = 0; i < 4; i++) y->ptr[i * 2 + (i % 2)] = 1.0f;
+
+    auto *emb = (LEmbedding *) net->snets[0]->layers[1];
+    for (int step = 0; step < 3; step++) {
+        Tensor *E0 = emb->E->clone();
+        train_batch(net, {x}, {y});
+
+        // Only the looked up rows move, once per step
+        vector<int> *rows = emb->sparse_rows(0);
+        ASSERT_NE(rows, nullptr);
+        ASSERT_EQ(rows->size(), 5);
+        for (int r = 0; r < vocsize; r++) {
+            bool used = (r == 3) || (r == 7) || (r == 10) || (r == 42) || (r == 499);
+            bool moved = false;
+            for (int j = 0; j < dim; j++) moved |= (E0->ptr[r * dim + j] != emb->E->ptr[r * dim + j]);
+            ASSERT_EQ(moved, used);
+        }
+        delete E0;
+    }
+
+    // Sparse zeroing leaves the whole table clean
+    net->snets[0]->do_reset_grads();
+    Tensor *a = emb->gE->clone();
+    a->abs_();
+    ASSERT_EQ(a->sum(), 0.0f);
+    ASSERT_EQ(emb->sparse_rows(0)->size(), 0);
+
+    delete a;
+    delete x;
+    delete y;
+    delete net;
+}
+
+
+TEST(EmbeddingTestSuite, sparse_sgd)
+{
+    check_sparse_update(sgd(0.1f, 0.9f));
+}
+
+
+TEST(EmbeddingTestSuite, sparse_adam)
+{
+    check_sparse_update(adam(0.01f));
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <cmath>
+
+#include "eddl/tensor/tensor.h"
+#include "eddl/layers/core/layer_core.h"
+#include "eddl/layers/normalization/layer_normalization.h"
+
+
+using namespace std;
+
+
+// Naive NCHW batchnorm: statistics, normalized values and input gradient
+static void bn_reference(Tensor *x, Tensor *dy, float *g, float *b, float eps,
+                         vector<double> &mean, vector<double> &var, Tensor *y, Tensor *dx)
+{
+    int n = x->shape[0], z = x->shape[1];
+    int rc = x->size / (n * z);
+    double N = (double) n * rc;
+    mean.assign(z, 0.0);
+    var.assign(z, 0.0);
+
+    for (int j = 0; j < z; j++) {
+        for (int i = 0; i < n; i++)
+            for (int k = 0; k < rc; k++) mean[j] += x->ptr[(i * z + j) * rc + k];
+        mean[j] /= N;
+        for (int i = 0; i < n; i++)
+            for (int k = 0; k < rc; k++) {
+                double d = x->ptr[(i * z + j) * rc + k] - mean[j];
+                var[j] += d * d;
+            }
+        var[j] /= N;
+
+        double sd = sqrt(var[j] + eps), md = 0.0, mdh = 0.0;
+        for (int i = 0; i < n; i++)
+            for (int k = 0; k < rc; k++) {
+                int p = (i * z + j) * rc + k;
+                double h = (x->ptr[p] - mean[j]) / sd;
+                y->ptr[p] = g[j] * h + b[j];
+                md += dy->ptr[p];
+                mdh += dy->ptr[p] * h;
+            }
+        md /= N;
+        mdh /= N;
+        for (int i = 0; i < n; i++)
+            for (int k = 0; k < rc; k++) {
+                int p = (i * z + j) * rc + k;
+                double h = (x->ptr[p] - mean[j]) / sd;
+                dx->ptr[p] = g[j] * (dy->ptr[p] - md - h * mdh) / sd;
+            }
+    }
+}
+
+
+static void check_batchnorm(const vector<int> &shape)
+{
+    Tensor *x = Tensor::randn(shape);
+    x->mult_(3.0f);
+    x->add_(5.0f);  // offset to exercise the one-pass variance
+    Tensor *dy = Tensor::randn(shape);
+
+    auto *in = new LInput(x->clone(), "in", DEV_CPU, 0);
+    in->delta = Tensor::zeros(shape);
+    auto *bn = new LBatchNorm(in, 0.9f, 1e-5f, true, "bn", DEV_CPU, 0);
+    bn->initialize();
+    int z = shape[1];
+    for (int j = 0; j < z; j++) {
+        bn->bn_g->ptr[j] = 0.5f + j;
+        bn->bn_b->ptr[j] = -1.0f + 0.25f * j;
+    }
+    bn->gbn_g->fill_(0.0f);
+    bn->gbn_b->fill_(0.0f);
+    bn->delta = dy->clone();
+    bn->mode = TRMODE;
+
+    bn->forward();
+    bn->backward();
+
+    Tensor *y = Tensor::zeros(shape);
+    Tensor *dx = Tensor::zeros(shape);
+    vector<double> mean, var;
+    bn_reference(x, dy, bn->bn_g->ptr, bn->bn_b->ptr, 1e-5f, mean, var, y, dx);
+
+    ASSERT_TRUE(Tensor::equivalent(bn->output, y, 1e-4f, 1e-4f));
+    ASSERT_TRUE(Tensor::equivalent(in->delta, dx, 1e-4f, 1e-4f));
+    for (int j = 0; j < z; j++) {
+        ASSERT_NEAR(bn->mean->ptr[j], 0.1 * mean[j], 1e-4);
+        ASSERT_NEAR(bn->variance->ptr[j], 0.9 + 0.1 * var[j], 1e-3);
+    }
+
+    // Inference uses the running statistics
+    bn->mode = TSMODE;
+    bn->forward();
+    for (int p = 0; p < x->size; p++) {
+        int j = (p / (x->size / (shape[0] * z))) % z;
+        float h = (x->ptr[p] - bn->mean->ptr[j]) / sqrtf(bn->variance->ptr[j] + 1e-5f);
+        ASSERT_NEAR(bn->output->ptr[p], bn->bn_g->ptr[j] * h + bn->bn_b->ptr[j], 1e-4);
+    }
+
+    delete x;
+    delete dy;
+    delete y;
+    delete dx;
+}
+
+
+TEST(BatchNormTestSuite, fused_cpu_conv)
+{
+    check_batchnorm({4, 3, 5, 7});
+}
+
+
+TEST(BatchNormTestSuite, fused_cpu_dense)
+{
+    check_batchnorm({9, 70});
+}
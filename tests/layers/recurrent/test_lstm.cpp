@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+#include <cmath>
+
+#include "eddl/apis/eddl.h"
+#include "eddl/layers/recurrent/layer_recurrent.h"
+
+using namespace eddl;
+
+
+// L = sum(h * Rh) + sum(c * Rc) of one LSTM cell
+static double cell_loss(Tensor *X, Tensor *Z, Tensor *bias, Tensor *hprev, Tensor *cprev,
+                        Tensor *mask, Tensor *Rh, Tensor *Rc) {
+    int b = Z->shape[0], u = Z->shape[1] / 4;
+    Tensor *g = Z->clone();
+    Tensor *sh = new Tensor({b, u});
+    Tensor *h = new Tensor({b, u});
+    Tensor *c = new Tensor({b, u});
+    tensorNN::lstm_forward(X, g, bias, hprev, cprev, mask, sh, h, c);
+
+    double l = 0.0;
+    for (int i = 0; i < h->size; i++) l += h->ptr[i] * Rh->ptr[i] + c->ptr[i] * Rc->ptr[i];
+
+    delete g;
+    delete sh;
+    delete h;
+    delete c;
+    return l;
+}
+
+
+TEST(LSTMTestSuite, fused_gates_gradient)
+{
+    int b = 3, u = 4, d = 2;
+    Tensor *X = Tensor::randn({b, d});
+    for (int k = 0; k < d; k++) X->ptr[2 * d + k] = 0.0f;  // last sample masked
+    Tensor *Z = Tensor::randn({b, 4 * u});
+    Tensor *bias = Tensor::randn({4 * u});
+    Tensor *hprev = Tensor::randn({b, u});
+    Tensor *cprev = Tensor::randn({b, u});
+    Tensor *mask = new Tensor({b, 1});
+    Tensor *Rh = Tensor::randn({b, u});
+    Tensor *Rc = Tensor::randn({b, u});
+
+    Tensor *g = Z->clone();
+    Tensor *sh = new Tensor({b, u});
+    Tensor *h = new Tensor({b, u});
+    Tensor *c = new Tensor({b, u});
+    tensorNN::lstm_forward(X, g, bias, hprev, cprev, mask, sh, h, c);
+    ASSERT_EQ(mask->ptr[2], 0.0f);
+    for (int j = 0; j < u; j++) {
+        ASSERT_EQ(h->ptr[2 * u + j], hprev->ptr[2 * u + j]);
+        ASSERT_EQ(c->ptr[2 * u + j], cprev->ptr[2 * u + j]);
+    }
+
+    Tensor *dg = new Tensor({b, 4 * u});
+    Tensor *dhprev = Tensor::zeros({b, u});
+    Tensor *dcprev = Tensor::zeros({b, u});
+    tensorNN::lstm_backward(g, cprev, sh, mask, Rh, Rc, dg, dhprev, dcprev);
+
+    // Masked samples pass the deltas through
+    for (int j = 0; j < u; j++) {
+        ASSERT_EQ(dhprev->ptr[2 * u + j], Rh->ptr[2 * u + j]);
+        ASSERT_EQ(dcprev->ptr[2 * u + j], Rc->ptr[2 * u + j]);
+    }
+
+    float eps = 1e-2f;
+    for (int i = 0; i < Z->size; i++) {
+        float z = Z->ptr[i];
+        Z->ptr[i] = z + eps;
+        double lp = cell_loss(X, Z, bias, hprev, cprev, mask, Rh, Rc);
+        Z->ptr[i] = z - eps;
+        double lm = cell_loss(X, Z, bias, hprev, cprev, mask, Rh, Rc);
+        Z->ptr[i] = z;
+        ASSERT_NEAR(dg->ptr[i], (lp - lm) / (2 * eps), 2e-3);
+    }
+    for (int i = 0; i < 2 * u; i++) {
+        float v = cprev->ptr[i];
+        cprev->ptr[i] = v + eps;
+        double lp = cell_loss(X, Z, bias, hprev, cprev, mask, Rh, Rc);
+        cprev->ptr[i] = v - eps;
+        double lm = cell_loss(X, Z, bias, hprev, cprev, mask, Rh, Rc);
+        cprev->ptr[i] = v;
+        ASSERT_NEAR(dcprev->ptr[i], (lp - lm) / (2 * eps), 2e-3);
+    }
+
+    for (Tensor *t : {X, Z, bias, hprev, cprev, mask, Rh, Rc, g, sh, h, c, dg, dhprev, dcprev}) delete t;
+}
+
+
+TEST(LSTMTestSuite, unrolled_forward)
+{
+    int b = 2, steps = 5, d = 3, u = 4;
+    layer in = Input({d});
+    layer l = LSTM(in, u);
+    model net = Model({in}, {l});
+    build(net, sgd(0.01f), {"mse"}, {"mse"}, CS_CPU(1), true);
+
+    Tensor *x = Tensor::randn({b, steps, d});
+    forward(net, {x});
+
+    auto *lstm = (LLSTM *) l;
+    ASSERT_EQ(lstm->Wx->shape, vector<int>({d, 4 * u}));
+    Tensor *Wx = lstm->Wx, *Wh = lstm->Wh, *bias = lstm->bias;
+
+    // Reference recurrence, gates [i|f|o|c]
+    vector<float> h(b * u, 0.0f), c(b * u, 0.0f);
+    for (int t = 0; t < steps; t++) {
+        vector<float> hn(b * u), cn(b * u);
+        for (int r = 0; r < b; r++)
+            for (int j = 0; j < u; j++) {
+                float z[4];
+                for (int k = 0; k < 4; k++) {
+                    int col = k * u + j;
+                    z[k] = bias->ptr[col];
+                    for (int q = 0; q < d; q++) z[k] += x->ptr[(r * steps + t) * d + q] * Wx->ptr[q * 4 * u + col];
+                    if (t > 0) for (int q = 0; q < u; q++) z[k] += h[r * u + q] * Wh->ptr[q * 4 * u + col];
+                }
+                float ig = 1.0f / (1.0f + std::exp(-z[0]));
+                float fg = 1.0f / (1.0f + std::exp(-z[1]));
+                float og = 1.0f / (1.0f + std::exp(-z[2]));
+                float ng = std::tanh(z[3]);
+                cn[r * u + j] = ig * ng + ((t > 0) ? fg * c[r * u + j] : 0.0f);
+                hn[r * u + j] = og * std::tanh(cn[r * u + j]);
+            }
+        h = hn;
+        c = cn;
+    }
+
+    Tensor *out = net->rnet->snets[0]->lout[0]->output;
+    ASSERT_EQ(out->shape, vector<int>({b, u}));
+    for (int i = 0; i < b * u; i++) ASSERT_NEAR(out->ptr[i], h[i], 1e-4f);
+
+    delete x;
+    delete net;
+}
+
+
+// The tensor operations run by the GPU give the same cell as the fused kernel
+TEST(LSTMTestSuite, unfused_matches_fused)
+{
+    int b = 3, u = 4, d = 2;
+    Tensor *X = Tensor::randn({b, d});
+    for (int k = 0; k < d; k++) X->ptr[d + k] = 0.0f;  // second sample masked
+    Tensor *Z = Tensor::randn({b, 4 * u});
+    Tensor *bias = Tensor::randn({4 * u});
+    Tensor *hprev = Tensor::randn({b, u});
+    Tensor *cprev = Tensor::randn({b, u});
+    Tensor *dh = Tensor::randn({b, u});
+    Tensor *dc = Tensor::randn({b, u});
+
+    for (bool first : {false, true}) {
+        Tensor *hp = first ? nullptr : hprev, *cp = first ? nullptr : cprev;
+        Tensor *g[2], *h[2], *c[2], *sh[2], *mask[2], *dg[2], *dhp[2], *dcp[2];
+        for (int k = 0; k < 2; k++) {
+            g[k] = Z->clone();
+            h[k] = new Tensor({b, u});
+            c[k] = new Tensor({b, u});
+            sh[k] = new Tensor({b, u});
+            mask[k] = new Tensor({b, 1});
+            dg[k] = new Tensor({b, 4 * u});
+            dhp[k] = Tensor::zeros({b, u});
+            dcp[k] = Tensor::zeros({b, u});
+        }
+
+        tensorNN::lstm_forward(X, g[0], bias, hp, cp, mask[0], sh[0], h[0], c[0]);
+        tensorNN::lstm_forward_unfused(X, g[1], bias, hp, cp, mask[1], sh[1], h[1], c[1]);
+        ASSERT_TRUE(Tensor::equivalent(h[0], h[1], 1e-5f));
+        ASSERT_TRUE(Tensor::equivalent(c[0], c[1], 1e-5f));
+        ASSERT_TRUE(Tensor::equivalent(mask[0], mask[1], 1e-5f));
+
+        tensorNN::lstm_backward(g[0], cp, sh[0], mask[0], dh, dc, dg[0], first ? nullptr : dhp[0], first ? nullptr : dcp[0]);
+        tensorNN::lstm_backward_unfused(g[1], cp, sh[1], mask[1], dh, dc, dg[1], first ? nullptr : dhp[1], first ? nullptr : dcp[1]);
+        ASSERT_TRUE(Tensor::equivalent(dg[0], dg[1], 1e-5f));
+        ASSERT_TRUE(Tensor::equivalent(dhp[0], dhp[1], 1e-5f));
+        ASSERT_TRUE(Tensor::equivalent(dcp[0], dcp[1], 1e-5f));
+
+        for (int k = 0; k < 2; k++)
+            for (Tensor *t : {g[k], h[k], c[k], sh[k], mask[k], dg[k], dhp[k], dcp[k]}) delete t;
+    }
+
+    for (Tensor *t : {X, Z, bias, hprev, cprev, dh, dc}) delete t;
+}
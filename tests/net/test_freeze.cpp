@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+
+#include "eddl/apis/eddl.h"
+
+using namespace eddl;
+
+
+static model conv_net() {
+    layer in = Input({2, 8, 8});
+    layer l = ReLu(BatchNormalization(Conv(in, 4, {3, 3})));
+    layer r = Conv(ReLu(Conv(l, 4, {3, 3})), 4, {3, 3});
+    l = MaxPool(Add({l, r}), {2, 2});
+    l = Sigmoid(ReLu(Dense(Reshape(l, {-1}), 16)));
+    layer out = Softmax(Dense(l, 3));
+    model net = Model({in}, {out});
+    build(net, adam(0.01f), {"soft_cross_entropy"}, {"categorical_accuracy"}, CS_CPU(1), true);
+    return net;
+}
+
+TEST(FreezeTestSuite, frozen_forward_matches)
+{
+    model net = conv_net();
+    int batch = 6;
+    Tensor *x = Tensor::randn({batch, 2, 8, 8});
+    Tensor *y = Tensor::zeros({batch, 3});
+    for (int i = 0; i < batch; i++) y->ptr[i * 3 + i % 3] = 1.0f;
+
+    // Trained for a few steps, so the deltas and moments exist
+    for (int it = 0; it < 3; it++) train_batch(net, {x}, {y});
+    set_mode(net, TSMODE);
+    forward(net, {x});
+    Tensor *ref = net->lout[0]->output->clone();
+
+    freeze(net);
+    ASSERT_TRUE(net->isfrozen);
+    ASSERT_EQ(net->optimizer, nullptr);
+    ASSERT_NE(net->output_arena, nullptr);
+    ASSERT_LT(net->output_plan.peak, net->output_plan.naive);
+    int inplace = 0;
+    for (Layer *l : net->layers) {
+        ASSERT_EQ(l->delta, nullptr);
+        ASSERT_EQ(l->target, nullptr);
+        for (Tensor *g : l->gradients) ASSERT_EQ(g->ptr, nullptr);
+        if ((l->parent.size() == 1) && (l->output->ptr == l->parent[0]->output->ptr)) inplace++;
+    }
+    ASSERT_GE(inplace, 3);  // two ReLu of the chains and the Sigmoid (the Reshape is a view)
+
+    forward(net, {x});
+    ASSERT_TRUE(Tensor::equivalent(ref, net->lout[0]->output, 1e-5f));
+
+    // Another batch size re-plans the arena
+    Tensor *x3 = Tensor::zeros({3, 2, 8, 8});
+    for (int i = 0; i < x3->size; i++) x3->ptr[i] = x->ptr[i];
+    forward(net, {x3});
+    ASSERT_NE(net->output_arena, nullptr);
+    for (int i = 0; i < 3 * 3; i++) ASSERT_NEAR(net->lout[0]->output->ptr[i], ref->ptr[i], 1e-5f);
+
+    // Chunked predict goes through the same path
+    vtensor p = predict(net, {x});
+    ASSERT_TRUE(Tensor::equivalent(ref, p[0], 1e-5f));
+
+    ASSERT_ANY_THROW(train_batch(net, {x}, {y}));
+
+    for (Tensor *t : p) delete t;
+    delete x3;
+    delete ref;
+    delete x;
+    delete y;
+    delete net;
+}
+
+
+TEST(FreezeTestSuite, build_without_losses)
+{
+    layer in = Input({10});
+    layer out = Softmax(Dense(ReLu(Dense(in, 20)), 4));
+    model net = Model({in}, {out});
+    build(net, nullptr, CS_CPU(1), true);
+    freeze(net);
+
+    Tensor *x = Tensor::randn({5, 10});
+    forward(net, {x});
+    Tensor *o = net->lout[0]->output;
+    for (int i = 0; i < 5; i++) {
+        float s = 0.0f;
+        for (int j = 0; j < 4; j++) s += o->ptr[i * 4 + j];
+        ASSERT_NEAR(s, 1.0f, 1e-5f);
+    }
+
+    delete x;
+    delete net;
+}
+
+
+TEST(FreezeTestSuite, winograd_kernels_follow_weights)
+{
+    vector<model> nets;
+    for (int i = 0; i < 2; i++) {
+        layer in = Input({8, 6, 6});
+        layer out = Conv(in, 8, {3, 3});
+        model net = Model({in}, {out});
+        build(net, sgd(0.1f), {"mse"}, {"mse"}, CS_CPU(1), true);
+        ASSERT_EQ(((LConv *) net->layers[1])->cd->algo, CONV_ALGO_WINOGRAD);
+        nets.push_back(net);
+    }
+    model a = nets[0], b = nets[1];
+    Tensor *x = Tensor::randn({2, 8, 6, 6});
+    Tensor *y = Tensor::randn({2, 8, 6, 6});
+
+    // Loaded weights replace the cached transform
+    set_mode(a, TSMODE);
+    forward(a, {x});
+    save(b, "winograd_b.bin");
+    load(a, "winograd_b.bin");
+    set_mode(b, TSMODE);
+    forward(a, {x});
+    forward(b, {x});
+    ASSERT_TRUE(Tensor::equivalent(a->lout[0]->output, b->lout[0]->output, 1e-5f));
+
+    // So do the weights of a training step
+    train_batch(a, {x}, {y});
+    set_mode(a, TSMODE);
+    forward(a, {x});
+    save(a, "winograd_a.bin");
+    load(b, "winograd_a.bin");
+    forward(b, {x});
+    ASSERT_TRUE(Tensor::equivalent(a->lout[0]->output, b->lout[0]->output, 1e-5f));
+
+    std::remove("winograd_a.bin");
+    std::remove("winograd_b.bin");
+    delete x;
+    delete y;
+    delete a;
+    delete b;
+}
+
+
+TEST(FreezeTestSuite, output_activation_resized)
+{
+    layer in = Input({10});
+    layer out = Sigmoid(Dense(Softplus(Dense(in, 20)), 4));
+    model net = Model({in}, {out});
+    build(net, nullptr, CS_CPU(1), true);
+
+    Tensor *x = Tensor::randn({37, 10});
+    set_mode(net, TSMODE);
+    forward(net, {x});
+    Tensor *ref = net->lout[0]->output->clone();
+    net->resize(5);
+
+    // The output activation keeps its own buffer, the hidden one does not
+    freeze(net);
+    ASSERT_NE(out->output->ptr, out->parent[0]->output->ptr);
+    Layer *hidden = out->parent[0]->parent[0];
+    ASSERT_EQ(hidden->output->ptr, hidden->parent[0]->output->ptr);
+
+    // predict resizes the net for the remainder chunk
+    vtensor y = predict(net, {x}, 8);
+    ASSERT_TRUE(Tensor::equivalent(ref, y[0], 1e-5f));
+    ASSERT_NE(out->output->ptr, out->parent[0]->output->ptr);
+    ASSERT_EQ(hidden->output->ptr, hidden->parent[0]->output->ptr);
+
+    delete y[0];
+    delete ref;
+    delete x;
+    delete net;
+}
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include "eddl/apis/eddl.h"
+#include "eddl/layers/core/layer_core.h"
+#include "eddl/layers/normalization/layer_normalization.h"
+
+using namespace eddl;
+
+
+static model act_net(bool fusion) {
+    layer in = Input({2, 8, 8});
+    layer l = ReLu(Conv(in, 4, {3, 3}));                         // im2col
+    l = LeakyReLu(Conv(l, 8, {1, 1}, {1, 1}, "none"), 0.1f);     // 1x1
+    l = Tanh(Conv(l, 8, {3, 3}, {1, 1}, "same", false, 8));     // depthwise, no bias
+    l = Reshape(Sigmoid(Conv(l, 8, {3, 3})), {-1});             // winograd
+    l = Tanh(Dense(l, 16, false));
+    layer out = Softmax(Dense(ReLu(Dense(l, 12)), 3));
+    model net = Model({in}, {out});
+    net->fusion = fusion;
+    build(net, sgd(0.05f), {"soft_cross_entropy"}, {"categorical_accuracy"}, CS_CPU(1, "low_mem"), true);
+    return net;
+}
+
+TEST(FusionTestSuite, fused_training_matches)
+{
+    model ref = act_net(false);
+    model net = act_net(true);
+    for (int i = 0; i < ref->layers.size(); i++)
+        for (int k = 0; k < ref->layers[i]->params.size(); k++)
+            Tensor::copy(ref->layers[i]->params[k], net->layers[i]->params[k]);
+
+    int fused = 0;
+    for (Layer *l : net->layers) {
+        auto *a = dynamic_cast<LActivation *>(l);
+        if ((a != nullptr) && a->fused) fused++;
+    }
+    ASSERT_EQ(fused, 6);  // all but the softmax
+
+    int batch = 5;
+    Tensor *x = Tensor::randn({batch, 2, 8, 8});
+    Tensor *y = Tensor::zeros({batch, 3});
+    for (int i = 0; i < batch; i++) y->ptr[i * 3 + i % 3] = 1.0f;
+
+    for (int it = 0; it < 3; it++) {
+        train_batch(ref, {x}, {y});
+        train_batch(net, {x}, {y});
+    }
+    for (int i = 0; i < ref->layers.size(); i++) {
+        // Conv and Dense outputs hold the activation computed by them
+        auto *a = dynamic_cast<LActivation *>(net->layers[i]->child.empty() ? nullptr : net->layers[i]->child[0]);
+        if ((a == nullptr) || (!a->fused))
+            ASSERT_TRUE(Tensor::equivalent(ref->layers[i]->output, net->layers[i]->output, 1e-5f));
+        for (int k = 0; k < ref->layers[i]->params.size(); k++)
+            ASSERT_TRUE(Tensor::equivalent(ref->layers[i]->params[k], net->layers[i]->params[k], 1e-4f));
+    }
+
+    // Fused layers follow their parent to another batch size
+    Tensor *x2 = Tensor::zeros({2, 2, 8, 8});
+    for (int i = 0; i < x2->size; i++) x2->ptr[i] = x->ptr[i];
+    set_mode(ref, TSMODE);
+    set_mode(net, TSMODE);
+    forward(ref, {x2});
+    forward(net, {x2});
+    ASSERT_TRUE(Tensor::equivalent(ref->lout[0]->output, net->lout[0]->output, 1e-5f));
+
+    delete x2;
+    delete x;
+    delete y;
+    delete ref;
+    delete net;
+}
+
+
+TEST(FusionTestSuite, frozen_batchnorm_folded)
+{
+    layer in = Input({3, 8, 8});
+    layer l = ReLu(BatchNormalization(Conv(in, 4, {3, 3})));
+    l = BatchNormalization(Conv(l, 4, {3, 3}, {1, 1}, "same", false), 0.9f, 0.001f, false);
+    l = Reshape(MaxPool(l, {2, 2}), {-1});
+    l = ReLu(BatchNormalization(Dense(l, 10, false)));
+    layer out = Softmax(Dense(l, 3));
+    model net = Model({in}, {out});
+    build(net, sgd(0.01f), {"soft_cross_entropy"}, {"categorical_accuracy"}, CS_CPU(1), true);
+
+    int batch = 6;
+    Tensor *x = Tensor::randn({batch, 3, 8, 8});
+    Tensor *y = Tensor::zeros({batch, 3});
+    for (int i = 0; i < batch; i++) y->ptr[i * 3 + i % 3] = 1.0f;
+
+    // Statistics and affine parameters away from the identity
+    for (int it = 0; it < 5; it++) train_batch(net, {x}, {y});
+    set_mode(net, TSMODE);
+    forward(net, {x});
+    Tensor *ref = net->lout[0]->output->clone();
+
+    freeze(net);
+    ASSERT_TRUE(net->isfolded);
+    int folded = 0, fused = 0;
+    for (Layer *l : net->layers) {
+        auto *bn = dynamic_cast<LBatchNorm *>(l);
+        auto *a = dynamic_cast<LActivation *>(l);
+        if ((bn != nullptr) && bn->folded) folded++;
+        if ((a != nullptr) && a->fused) fused++;
+    }
+    ASSERT_EQ(folded, 3);
+    ASSERT_EQ(fused, 2);
+
+    forward(net, {x});
+    ASSERT_TRUE(Tensor::equivalent(ref, net->lout[0]->output, 1e-4f));
+
+    vtensor p = predict(net, {x});
+    ASSERT_TRUE(Tensor::equivalent(ref, p[0], 1e-4f));
+    ASSERT_ANY_THROW(save(net, "folded.bin"));
+
+    for (Tensor *t : p) delete t;
+    delete ref;
+    delete x;
+    delete y;
+    delete net;
+}
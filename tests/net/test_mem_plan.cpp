@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#include "eddl/apis/eddl.h"
+#include "eddl/net/mem_plan.h"
+
+using namespace eddl;
+
+
+TEST(MemPlanTestSuite, placement)
+{
+    MemPlan p;
+    p.add(1000, 0, 1);
+    p.add(1000, 2, 3);
+    p.add(500, 1, 2);
+    p.add(300, 0, MEM_KEEP);
+    p.place();
+    ASSERT_EQ(p.naive, 2800);
+    ASSERT_LT(p.peak, p.naive);
+
+    // Buffers alive at the same time never overlap
+    for (int i = 0; i < p.blocks.size(); i++)
+        for (int j = i + 1; j < p.blocks.size(); j++) {
+            MemBlock &a = p.blocks[i], &b = p.blocks[j];
+            if ((a.start <= b.end) && (b.start <= a.end))
+                ASSERT_TRUE((a.offset + a.size <= b.offset) || (b.offset + b.size <= a.offset));
+            ASSERT_LE(a.offset + a.size, p.peak);
+        }
+}
+
+
+static model residual_net(const string &mem) {
+    layer in = Input({12});
+    layer l = ReLu(Dense(in, 32));
+    layer r = ReLu(Dense(l, 32));
+    r = Add({l, Dense(r, 32)});
+    r = Reshape(r, {4, 8});
+    r = Reshape(r, {32});
+    layer out = Softmax(Dense(ReLu(r), 5));
+    model net = Model({in}, {out});
+    build(net, sgd(0.05f), {"soft_cross_entropy"}, {"categorical_accuracy"}, CS_CPU(1, mem), true);
+    return net;
+}
+
+TEST(MemPlanTestSuite, shared_deltas_train_as_full_mem)
+{
+    model full = residual_net("full_mem");
+    model mid = residual_net("mid_mem");
+    for (int i = 0; i < full->layers.size(); i++)
+        for (int k = 0; k < full->layers[i]->params.size(); k++)
+            Tensor::copy(full->layers[i]->params[k], mid->layers[i]->params[k]);
+
+    int batch = 8;
+    Tensor *x = Tensor::randn({batch, 12});
+    Tensor *y = Tensor::zeros({batch, 5});
+    for (int i = 0; i < batch; i++) y->ptr[i * 5 + i % 5] = 1.0f;
+
+    for (int it = 0; it < 3; it++) {
+        train_batch(full, {x}, {y});
+        train_batch(mid, {x}, {y});
+    }
+
+    // The plan follows the batch and is applied only when deltas are not kept
+    ASSERT_EQ(full->delta_arena, nullptr);
+    ASSERT_NE(mid->delta_arena, nullptr);
+    ASSERT_EQ(mid->delta_plan.naive, full->delta_plan.naive);
+    ASSERT_LT(mid->delta_plan.peak, mid->delta_plan.naive);
+    ASSERT_LT(mid->output_plan.peak, mid->output_plan.naive);
+    ASSERT_EQ(mid->delta_plan.naive % batch, 0);
+
+    for (int i = 0; i < full->layers.size(); i++)
+        for (int k = 0; k < full->layers[i]->params.size(); k++)
+            ASSERT_TRUE(Tensor::equivalent(full->layers[i]->params[k], mid->layers[i]->params[k], 1e-5f));
+
+    // Back to its own storage after a batch change
+    mid->resize(batch / 2);
+    ASSERT_NE(mid->delta_arena, nullptr);
+    ASSERT_EQ(mid->delta_plan.naive, full->delta_plan.naive / 2);
+
+    delete x;
+    delete y;
+    delete full;
+    delete mid;
+}
+
+
+static model conv_net(const string &mem) {
+    layer in = Input({2, 8, 8});
+    layer l = ReLu(BatchNormalization(Conv(in, 4, {3, 3})));
+    layer r = Conv(ReLu(Conv(l, 4, {3, 3})), 4, {3, 3});
+    l = MaxPool(Add({l, r}), {2, 2});
+    layer out = Softmax(Dense(Reshape(l, {-1}), 3));
+    model net = Model({in}, {out});
+    build(net, sgd(0.05f), {"soft_cross_entropy"}, {"categorical_accuracy"}, CS_CPU(1, mem), true);
+    return net;
+}
+
+TEST(MemPlanTestSuite, conv_net_low_mem)
+{
+    model full = conv_net("full_mem");
+    model low = conv_net("low_mem");
+    for (int i = 0; i < full->layers.size(); i++)
+        for (int k = 0; k < full->layers[i]->params.size(); k++)
+            Tensor::copy(full->layers[i]->params[k], low->layers[i]->params[k]);
+
+    int batch = 4;
+    Tensor *x = Tensor::randn({batch, 2, 8, 8});
+    Tensor *y = Tensor::zeros({batch, 3});
+    for (int i = 0; i < batch; i++) y->ptr[i * 3 + i % 3] = 1.0f;
+
+    for (int it = 0; it < 3; it++) {
+        train_batch(full, {x}, {y});
+        train_batch(low, {x}, {y});
+    }
+    ASSERT_NE(low->delta_arena, nullptr);
+    ASSERT_LT(low->delta_plan.peak, low->delta_plan.naive);
+
+    for (int i = 0; i < full->layers.size(); i++)
+        for (int k = 0; k < full->layers[i]->params.size(); k++)
+            ASSERT_TRUE(Tensor::equivalent(full->layers[i]->params[k], low->layers[i]->params[k], 1e-4f));
+
+    delete x;
+    delete y;
+    delete full;
+    delete low;
+}
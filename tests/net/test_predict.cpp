@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include "eddl/apis/eddl.h"
+#include "eddl/profiler.h"
+
+using namespace eddl;
+
+
+struct chunks {
+    vector<int> starts;
+    vector<int> sizes;
+};
+
+void record_chunk(int start, vtensor &out, void *arg) {
+    auto *c = (chunks *) arg;
+    c->starts.push_back(start);
+    c->sizes.push_back(out[0]->shape[0]);
+}
+
+
+TEST(PredictTestSuite, chunked_predict)
+{
+    layer in = Input({6});
+    layer l = ReLu(Dense(in, 16));
+    layer out = Softmax(Dense(l, 3));
+    model net = Model({in}, {out});
+
+    build(net, sgd(0.01f), {"soft_cross_entropy"}, {"categorical_accuracy"}, CS_CPU(1), true);
+    net->resize(8);
+
+    Tensor *x = Tensor::randn({21, 6});
+
+    // Reference: the whole input at once
+    forward(net, {x});
+    Tensor *ref = net->lout[0]->output->clone();
+    net->resize(8);
+
+    vtensor y = predict(net, {x});
+    ASSERT_EQ(y[0]->shape[0], 21);
+    ASSERT_TRUE(Tensor::equivalent(y[0], ref, 1e-5f));
+
+    // The net keeps its batch size
+    ASSERT_EQ(net->batch_size, 8);
+
+    // Streaming form, remainder batch included
+    chunks c;
+    predict(net, {x}, 8, record_chunk, &c);
+    ASSERT_EQ(c.starts, vector<int>({0, 8, 16}));
+    ASSERT_EQ(c.sizes, vector<int>({8, 8, 5}));
+
+    delete x;
+    delete ref;
+    delete y[0];
+    delete net;
+}
+
+
+TEST(PredictTestSuite, predict_after_build)
+{
+    layer in = Input({6});
+    layer out = Softmax(Dense(ReLu(Dense(in, 16)), 3));
+    model net = Model({in}, {out});
+    build(net, sgd(0.01f), {"soft_cross_entropy"}, {"categorical_accuracy"}, CS_CPU(1), true);
+    ASSERT_EQ(net->batch_size, 1);
+
+    int n = PREDICT_BATCH + 44;
+    Tensor *x = Tensor::randn({n, 6});
+
+    // Default chunk, not the batch of 1 of a new net
+    set_profiling(true);
+    vtensor y = predict(net, {x});
+    set_profiling(false);
+    ASSERT_EQ(prof_layer_stats()[net->lout[0]->name].calls[PROF_FORWARD], 2);
+    ASSERT_EQ(net->batch_size, 1);
+
+    // Given chunk
+    set_profiling(true);
+    vtensor y2 = predict(net, {x}, 100);
+    set_profiling(false);
+    ASSERT_EQ(prof_layer_stats()[net->lout[0]->name].calls[PROF_FORWARD], 3);
+
+    forward(net, {x});
+    ASSERT_TRUE(Tensor::equivalent(y[0], net->lout[0]->output, 1e-5f));
+    ASSERT_TRUE(Tensor::equivalent(y2[0], net->lout[0]->output, 1e-5f));
+
+    delete x;
+    delete y[0];
+    delete y2[0];
+    delete net;
+}
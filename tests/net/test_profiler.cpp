@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "eddl/apis/eddl.h"
+#include "eddl/profiler.h"
+
+using namespace eddl;
+
+
+static model small_net() {
+    layer in = Input({2, 6, 6});
+    layer l = ReLu(Conv(in, 4, {3, 3}));
+    layer out = Softmax(Dense(Reshape(l, {-1}), 3));
+    model net = Model({in}, {out});
+    build(net, sgd(0.01f), {"soft_cross_entropy"}, {"categorical_accuracy"}, CS_CPU(1), true);
+    return net;
+}
+
+TEST(ProfilerTestSuite, layer_and_kernel_events)
+{
+    model net = small_net();
+    Tensor *x = Tensor::randn({4, 2, 6, 6});
+    Tensor *y = Tensor::zeros({4, 3});
+    for (int i = 0; i < 4; i++) y->ptr[i * 3 + i % 3] = 1.0f;
+
+    // Nothing is recorded while disabled
+    set_profiling(false);
+    train_batch(net, {x}, {y});
+    set_profiling(true);
+    set_profiling(false);
+    ASSERT_TRUE(prof_events().empty());
+
+    set_profiling(true);
+    train_batch(net, {x}, {y});
+    train_batch(net, {x}, {y});
+    set_profiling(false);
+
+    map<string, ProfStats> stats = prof_layer_stats();
+    for (Layer *l : net->vfts) {
+        ASSERT_EQ(stats[l->name].calls[PROF_FORWARD], 2);
+        ASSERT_EQ(stats[l->name].calls[PROF_BACKWARD], 2);
+    }
+    for (Layer *l : net->layers) {
+        bool trainable = l->trainable && (l->get_trainable_params_count() > 0);
+        ASSERT_EQ(stats[l->name].calls[PROF_UPDATE], trainable ? 2 : 0);
+    }
+
+    // Kernels run inside the layer that called them
+    vector<ProfEvent> events = prof_events();
+    int conv = 0;
+    for (ProfEvent &e : events) {
+        if ((e.phase != PROF_KERNEL) || (e.name != "conv2d")) continue;
+        conv++;
+        ASSERT_EQ(e.layer, net->vfts[1]->name);
+        bool inside = false;
+        for (ProfEvent &p : events)
+            if ((p.phase == PROF_FORWARD) && (p.name == e.layer) && (p.tid == e.tid) &&
+                (p.start <= e.start) && (e.start + e.dur <= p.start + p.dur))
+                inside = true;
+        ASSERT_TRUE(inside);
+    }
+    ASSERT_EQ(conv, 2);
+
+    string table = net->profile_summary();
+    for (Layer *l : net->vfts) ASSERT_NE(table.find(l->name), string::npos);
+
+    delete x;
+    delete y;
+    delete net;
+}
+
+
+TEST(ProfilerTestSuite, threads_and_trace)
+{
+    set_profiling(true);
+    int nth = 4, n = 200;
+    vector<thread> threads;
+    for (int t = 0; t < nth; t++)
+        threads.push_back(thread([n, t]() {
+            string name = "layer" + to_string(t);
+            for (int i = 0; i < n; i++) {
+                ProfScope scope(name, PROF_FORWARD);
+                prof_kernel_begin("kernel");
+                prof_kernel_end("kernel");
+            }
+        }));
+    for (thread &t : threads) t.join();
+    set_profiling(false);
+
+    vector<ProfEvent> events = prof_events();
+    ASSERT_EQ(events.size(), 2 * nth * n);
+    map<string, ProfStats> stats = prof_layer_stats();
+    for (int t = 0; t < nth; t++) ASSERT_EQ(stats["layer" + to_string(t)].calls[PROF_FORWARD], n);
+    for (ProfEvent &e : events) {
+        if (e.phase == PROF_KERNEL) ASSERT_EQ(e.layer.substr(0, 5), "layer");
+        ASSERT_GE(e.dur, 0);
+    }
+
+    save_profile("profile_trace.json");
+    std::ifstream ifs("profile_trace.json");
+    std::stringstream buf;
+    buf << ifs.rdbuf();
+    string json = buf.str();
+    int complete = 0;
+    for (size_t p = json.find("\"ph\": \"X\""); p != string::npos; p = json.find("\"ph\": \"X\"", p + 1)) complete++;
+    ASSERT_EQ(complete, events.size());
+    ASSERT_EQ(json.substr(0, 1), "{");
+    remove("profile_trace.json");
+}
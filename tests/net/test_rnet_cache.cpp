@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+
+#include "eddl/apis/eddl.h"
+
+using namespace eddl;
+
+
+model rnn_model() {
+    layer in = Input({4});
+    layer l = LSTM(in, 8);
+    layer out = Softmax(Dense(l, 3));
+    model net = Model({in}, {out});
+
+    build(net, sgd(0.01f), {"soft_cross_entropy"}, {"categorical_accuracy"}, CS_CPU(1), true);
+    return net;
+}
+
+void forward_length(model net, int length) {
+    Tensor *x = Tensor::randn({2, length, 4});
+    forward(net, {x});
+    delete x;
+}
+
+
+TEST(RNetCacheTestSuite, reuse_and_evict)
+{
+    model net = rnn_model();
+    set_rnet_cache(net, 2);
+
+    forward_length(net, 5);
+    Net *r5 = net->rnet;
+    ASSERT_EQ(r5->rinl, 5);
+
+    forward_length(net, 6);
+    ASSERT_EQ(net->rnets.size(), 2);
+
+    // Same length: no new unroll
+    forward_length(net, 5);
+    ASSERT_EQ(net->rnet, r5);
+    ASSERT_EQ(net->rnets.size(), 2);
+
+    // The least recently used unroll (length 6) is evicted
+    forward_length(net, 7);
+    ASSERT_EQ(net->rnets.size(), 2);
+    ASSERT_EQ(net->rnets[0]->rinl, 7);
+    ASSERT_EQ(net->rnets[1], r5);
+
+    delete net;
+}
+
+
+TEST(RNetCacheTestSuite, length_buckets)
+{
+    model net = rnn_model();
+    set_rnet_cache(net, 4, 4);
+
+    forward_length(net, 5);
+    Net *r8 = net->rnet;
+    ASSERT_EQ(r8->rinl, 8);
+
+    // Every length of the bucket shares the same unroll
+    forward_length(net, 7);
+    forward_length(net, 8);
+    ASSERT_EQ(net->rnet, r8);
+    ASSERT_EQ(net->rnets.size(), 1);
+
+    forward_length(net, 3);
+    ASSERT_EQ(net->rnet->rinl, 4);
+    ASSERT_EQ(net->rnets.size(), 2);
+
+    delete net;
+}
+
+
+TEST(RNetCacheTestSuite, loss_over_lengths)
+{
+    model net = rnn_model();
+    set_rnet_cache(net, 1);
+
+    reset_loss(net);
+    float last = 0.0f;
+    int lengths[] = {5, 6, 5};
+    for (int i = 0; i < 3; i++) {
+        Tensor *x = Tensor::randn({2, lengths[i], 4});
+        Tensor *y = Tensor::zeros({2, 3});
+        y->ptr[0] = y->ptr[4] = 1.0f;
+        zeroGrads(net);
+        forward(net, {x});
+        backward(net, {y});
+        update(net);
+        delete x;
+        delete y;
+
+        // The losses of the previous unrolls (evicted or not) are kept
+        print_loss(net, i + 1);
+        ASSERT_EQ(net->inferenced_samples, 2 * (i + 1));
+        ASSERT_GT(net->total_loss[0], last);
+        last = net->total_loss[0];
+    }
+    printf("\n");
+
+    delete net;
+}
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+
+#include "eddl/apis/eddl.h"
+#include "eddl/net/sampler.h"
+
+using namespace eddl;
+
+
+TEST(SamplerTestSuite, epoch_without_replacement)
+{
+    Sampler s(23, 5, false, 1);
+    ASSERT_EQ(s.num_batches(), 5);
+
+    vector<vector<int>> b = s.epoch();
+    ASSERT_EQ(b.size(), 5);
+    ASSERT_EQ(b[4].size(), 5);  // 3 remaining samples + 2 repeated
+
+    vector<int> all;
+    for (auto &v : b) all.insert(all.end(), v.begin(), v.end());
+    std::sort(all.begin(), all.end());
+    all.erase(std::unique(all.begin(), all.end()), all.end());
+    ASSERT_EQ(all.size(), 23);
+    for (int i = 0; i < 23; i++) ASSERT_EQ(all[i], i);
+
+    // A new order every epoch
+    ASSERT_NE(s.epoch()[0], b[0]);
+
+    Sampler d(23, 5, true, 1);
+    ASSERT_EQ(d.epoch().size(), 4);
+}
+
+
+TEST(SamplerTestSuite, stratified_batches)
+{
+    // 3/4 of class 0 and 1/4 of class 1, sorted by class
+    Tensor *y = Tensor::zeros({40, 2});
+    for (int i = 0; i < 40; i++) y->ptr[i * 2 + (i < 30 ? 0 : 1)] = 1.0f;
+
+    Sampler s(40, 8, true, 3);
+    s.stratify(y);
+    for (auto &b : s.epoch()) {
+        int ones = 0;
+        for (int k : b) ones += (k >= 30);
+        ASSERT_EQ(ones, 2);
+    }
+
+    delete y;
+}
+
+
+TEST(SamplerTestSuite, prefetched_fit)
+{
+    layer in = Input({4});
+    layer out = Softmax(Dense(ReLu(Dense(in, 8)), 2));
+    model net = Model({in}, {out});
+    build(net, sgd(0.01f), {"soft_cross_entropy"}, {"categorical_accuracy"}, CS_CPU(1), true);
+
+    Tensor *x = Tensor::randn({30, 4});
+    Tensor *y = Tensor::zeros({30, 2});
+    for (int i = 0; i < 30; i++) y->ptr[i * 2 + (i % 2)] = 1.0f;
+
+    // Loader batches hold the same rows as a synchronous gather
+    net->resize(8);
+    vector<vector<int>> batches = {{3, 1, 4, 1, 5, 9, 2, 6}};
+    BatchLoader loader(net, {x}, {y}, batches, 2);
+    BatchSlot *slot = loader.wait(0);
+    net->gather_batch({x}, {y}, batches[0], net->Xs, net->Ys);
+    ASSERT_TRUE(Tensor::equivalent(slot->xs[0][0], net->Xs[0][0], 0.0f, 0.0f));
+    ASSERT_TRUE(Tensor::equivalent(slot->ys[0][0], net->Ys[0][0], 0.0f, 0.0f));
+    loader.release(0);
+
+    // Remainder batch included
+    set_sampling(net, true, false, 2);
+    fit(net, {x}, {y}, 8, 2);
+    ASSERT_EQ(net->batch_size, 8);
+
+    set_sampling(net, false, true, 0);
+    fit(net, {x}, {y}, 8, 1);
+
+    delete x;
+    delete y;
+}
@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+#include <cmath>
+
+#include "eddl/apis/eddl.h"
+
+using namespace eddl;
+
+
+TEST(SoftmaxCentTestSuite, fused_loss_and_delta)
+{
+    layer in = Input({10});
+    layer l = Dense(in, 514);
+    layer out = Softmax(l);
+    model net = Model({in}, {out});
+    build(net, sgd(0.01f), {"soft_cross_entropy"}, {"categorical_accuracy"}, CS_CPU(1), true);
+    ASSERT_TRUE(net->snets[0]->softmax_cent[0]);
+
+    int batch = 6;
+    Tensor *x = Tensor::randn({batch, 10});
+    x->mult_(4.0f);
+    Tensor *y = Tensor::zeros({batch, 514});
+    for (int i = 0; i < batch; i++) y->ptr[i * 514 + (i * 37) % 514] = 1.0f;
+
+    net->resize(batch);
+    forward(net, {x});
+    Net *sn = net->snets[0];
+    Tensor *prob = sn->lout[0]->output;
+    sn->lout[0]->check_target(y->shape);
+    Tensor::copy(y, sn->lout[0]->target);
+
+    // Rows of the softmax sum up to one
+    for (int i = 0; i < batch; i++) {
+        double s = 0.0;
+        for (int j = 0; j < 514; j++) s += prob->ptr[i * 514 + j];
+        ASSERT_NEAR(s, 1.0, 1e-4);
+    }
+
+    // Same value as the separate loss
+    float ref = sn->losses[0]->value(y, prob);
+    sn->do_compute_loss();
+    ASSERT_NEAR(sn->fiterr[0], ref, 1e-3 * std::fabs(ref));
+
+    // The delta comes with the loss and is not recomputed
+    Tensor *d = Tensor::zeros({batch, 514});
+    Tensor::add(-1.0f, y, 1.0f, prob, d, 0);
+    d->div_(batch);
+    ASSERT_TRUE(Tensor::equivalent(sn->lout[0]->delta, d, 1e-6f));
+    sn->lout[0]->delta->fill_(0.0f);
+    sn->do_delta();
+    ASSERT_EQ(sn->lout[0]->delta->sum(), 0.0f);
+
+    // Without a previous loss the delta is computed as usual
+    sn->do_forward();
+    sn->do_delta();
+    ASSERT_TRUE(Tensor::equivalent(sn->lout[0]->delta, d, 1e-6f));
+
+    delete x;
+    delete y;
+    delete d;
+    delete net;
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <cmath>
+
+#include "eddl/apis/eddl.h"
+#include "eddl/losses/loss.h"
+#include "eddl/metrics/metric.h"
+
+using namespace eddl;
+
+
+static Tensor *onehot_rows(Tensor *idx, int classes) {
+    Tensor *t = Tensor::zeros({idx->shape[0], classes});
+    for (int i = 0; i < idx->shape[0]; i++) t->ptr[i * classes + (int) idx->ptr[i]] = 1.0f;
+    return t;
+}
+
+
+TEST(SparseLossesTestSuite, same_as_one_hot)
+{
+    int batch = 7, classes = 11;
+    Tensor *logits = Tensor::randn({batch, classes});
+    Tensor *y = Tensor::zeros({batch, classes});
+    tensorNN::Softmax(logits, y);
+    Tensor *idx = Tensor::zeros({batch, 1});
+    for (int i = 0; i < batch; i++) idx->ptr[i] = (float) ((i * 5) % classes);
+    Tensor *t = onehot_rows(idx, classes);
+
+    // Softmax version: value and delta wrt the logits
+    LSoftCrossEntropy soft;
+    LSparseSoftCrossEntropy ssoft;
+    ASSERT_EQ(ssoft.target_shape({batch, classes}), vector<int>({batch, 1}));
+    Tensor *d = Tensor::zeros({batch, classes});
+    Tensor *sd = Tensor::zeros({batch, classes});
+    float v = soft.value_delta(t, y, d);
+    float sv = ssoft.value_delta(idx, y, sd);
+    ASSERT_NEAR(sv, v, 1e-4f * std::fabs(v));
+    ASSERT_TRUE(Tensor::equivalent(sd, d, 1e-6f));
+    ASSERT_NEAR(ssoft.value(idx, y), v, 1e-4f * std::fabs(v));
+
+    // Plain cross-entropy, delta wrt the probabilities
+    LCrossEntropy cent;
+    LSparseCrossEntropy scent;
+    Tensor *yc = y->clone();
+    cent.delta(t, yc, d);  // adds eps to yc
+    scent.delta(idx, y, sd);
+    ASSERT_TRUE(Tensor::equivalent(sd, d, 1e-3f, 1e-4f));
+    v = cent.value(t, y);
+    ASSERT_NEAR(scent.value(idx, y), v, 1e-4f * std::fabs(v));
+
+    // Accuracy
+    MCategoricalAccuracy acc;
+    MSparseCategoricalAccuracy sacc;
+    ASSERT_EQ(sacc.value(idx, y), acc.value(t, y));
+
+    // Out of range indices are rejected
+    idx->ptr[0] = (float) classes;
+    ASSERT_ANY_THROW(ssoft.value(idx, y));
+
+    delete logits;
+    delete y;
+    delete yc;
+    delete idx;
+    delete t;
+    delete d;
+    delete sd;
+}
+
+
+TEST(SparseLossesTestSuite, train_with_class_indices)
+{
+    int batch = 12, classes = 9;
+
+    layer in1 = Input({5});
+    layer d1 = Dense(in1, classes);
+    model net1 = Model({in1}, {Softmax(d1)});
+    build(net1, sgd(0.1f), {"soft_cross_entropy"}, {"categorical_accuracy"}, CS_CPU(1), true);
+
+    layer in2 = Input({5});
+    layer d2 = Dense(in2, classes);
+    model net2 = Model({in2}, {Softmax(d2)});
+    build(net2, sgd(0.1f), {"sparse_soft_cross_entropy"}, {"sparse_categorical_accuracy"}, CS_CPU(1), true);
+    ASSERT_TRUE(net2->snets[0]->softmax_cent[0]);
+
+    for (int p = 0; p < 2; p++) copyParam(d1, d2, p);
+
+    Tensor *x = Tensor::randn({batch, 5});
+    Tensor *idx = Tensor::zeros({batch, 1});
+    for (int i = 0; i < batch; i++) idx->ptr[i] = (float) ((i * 4) % classes);
+    Tensor *t = onehot_rows(idx, classes);
+
+    // Targets and loader buffers hold one index per sample
+    net2->resize(batch);
+    net1->resize(batch);
+    ASSERT_EQ(net2->Ys[0][0]->shape, vector<int>({batch, 1}));
+
+    vind sind(batch);
+    for (int i = 0; i < batch; i++) sind[i] = i;
+    for (int it = 0; it < 3; it++) {
+        net1->train_batch({x}, {t}, sind);
+        net2->train_batch({x}, {idx}, sind);
+        Net *s1 = net1->snets[0], *s2 = net2->snets[0];
+        ASSERT_NEAR(s2->fiterr[0], s1->fiterr[0], 1e-4f * std::fabs(s1->fiterr[0]));
+        ASSERT_EQ(s2->fiterr[1], s1->fiterr[1]);
+    }
+
+    ASSERT_TRUE(Tensor::equivalent(getParam(d2, 0), getParam(d1, 0), 1e-5f));
+
+    // Stratified sampling also takes class indices
+    set_sampling(net2, true, true, 0);
+    fit(net2, {x}, {idx}, batch, 1);
+
+    delete x;
+    delete idx;
+    delete t;
+    delete net1;
+    delete net2;
+}
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+#include "eddl/net/workers.h"
+
+
+struct wtest {
+    int id;
+    int value;
+};
+
+void *set_value(void *t) {
+    auto *w = (wtest *) t;
+    w->value += w->id + 1;
+    return nullptr;
+}
+
+void *throw_error(void *t) {
+    auto *w = (wtest *) t;
+    if (w->id == 1) throw std::runtime_error("task error");
+    return nullptr;
+}
+
+
+TEST(WorkerPoolTestSuite, run_all_tasks)
+{
+    WorkerPool pool(4);
+    wtest w[4];
+    void *args[4];
+    for (int i = 0; i < 4; i++) { w[i].id = i; w[i].value = 0; args[i] = &w[i]; }
+
+    // Repeated dispatches on the same workers
+    for (int k = 0; k < 100; k++) pool.run(set_value, args, 4);
+    for (int i = 0; i < 4; i++) ASSERT_EQ(w[i].value, 100 * (i + 1));
+
+    // Fewer tasks than workers
+    pool.run(set_value, args, 2);
+    ASSERT_EQ(w[0].value, 101);
+    ASSERT_EQ(w[1].value, 202);
+    ASSERT_EQ(w[2].value, 300);
+    ASSERT_EQ(w[3].value, 400);
+}
+
+
+TEST(WorkerPoolTestSuite, rethrow_task_exception)
+{
+    WorkerPool pool(2);
+    wtest w[2];
+    void *args[2];
+    for (int i = 0; i < 2; i++) { w[i].id = i; w[i].value = 0; args[i] = &w[i]; }
+
+    ASSERT_THROW(pool.run(throw_error, args, 2), std::runtime_error);
+
+    // The pool is still usable afterwards
+    pool.run(set_value, args, 2);
+    ASSERT_EQ(w[1].value, 2);
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include <cmath>
+
+#include "eddl/tensor/tensor.h"
+#include "eddl/tensor/nn/tensor_nn.h"
+
+
+// Reference values are computed element by element with the textbook formulas
+
+TEST(OptimizerUpdateTestSuite, sgd_momentum_nesterov)
+{
+    float lr = 0.1f, mu = 0.9f;
+    auto *p = new Tensor({4}, new float[4]{1.0f, -2.0f, 0.5f, 3.0f}, DEV_CPU);
+    auto *g = new Tensor({4}, new float[4]{0.2f, -0.1f, 0.0f, 1.0f}, DEV_CPU);
+    auto *m = new Tensor({4}, new float[4]{0.1f, 0.1f, -0.3f, 0.0f}, DEV_CPU);
+    auto *p_ref = p->clone();
+    auto *m_ref = m->clone();
+
+    tensorNN::sgd_update(p, g, m, lr, mu, 0.0f, true);
+
+    for (int i = 0; i < 4; i++) {
+        float mi = mu * m_ref->ptr[i] + lr * g->ptr[i];
+        float pi = p_ref->ptr[i] - (mu * mi + lr * g->ptr[i]);
+        ASSERT_NEAR(m->ptr[i], mi, 1e-6f);
+        ASSERT_NEAR(p->ptr[i], pi, 1e-6f);
+    }
+
+    // The gradient is not modified
+    ASSERT_FLOAT_EQ(g->ptr[3], 1.0f);
+}
+
+
+TEST(OptimizerUpdateTestSuite, adam_bias_correction)
+{
+    float lr = 0.01f, b1 = 0.9f, b2 = 0.999f, eps = 1e-8f;
+    auto *p = new Tensor({3}, new float[3]{1.0f, -1.0f, 0.25f}, DEV_CPU);
+    auto *g = new Tensor({3}, new float[3]{0.5f, -0.2f, 0.01f}, DEV_CPU);
+    auto *m = Tensor::zeros({3});
+    auto *v = Tensor::zeros({3});
+
+    float pr[3] = {1.0f, -1.0f, 0.25f};
+    float mr[3] = {0, 0, 0};
+    float vr[3] = {0, 0, 0};
+
+    for (int t = 1; t <= 3; t++) {
+        tensorNN::adam_update(p, g, m, v, lr, b1, b2, eps, 0.0f, t);
+
+        for (int i = 0; i < 3; i++) {
+            mr[i] = b1 * mr[i] + (1 - b1) * g->ptr[i];
+            vr[i] = b2 * vr[i] + (1 - b2) * g->ptr[i] * g->ptr[i];
+            float mhat = mr[i] / (1 - ::powf(b1, t));
+            float vhat = vr[i] / (1 - ::powf(b2, t));
+            pr[i] -= lr * mhat / ::sqrtf(vhat + eps);
+        }
+    }
+
+    for (int i = 0; i < 3; i++) {
+        ASSERT_NEAR(p->ptr[i], pr[i], 1e-5f);
+        ASSERT_NEAR(m->ptr[i], mr[i], 1e-6f);
+        ASSERT_NEAR(v->ptr[i], vr[i], 1e-6f);
+    }
+}
+
+
+TEST(OptimizerUpdateTestSuite, rmsprop)
+{
+    float lr = 0.01f, rho = 0.9f, eps = 1e-8f;
+    auto *p = new Tensor({2}, new float[2]{1.0f, 2.0f}, DEV_CPU);
+    auto *g = new Tensor({2}, new float[2]{0.3f, -0.4f}, DEV_CPU);
+    auto *g1 = new Tensor({2}, new float[2]{0.1f, 0.2f}, DEV_CPU);
+
+    tensorNN::rmsprop_update(p, g, g1, lr, rho, eps, 0.0f);
+
+    float ms0 = (1 - rho) * 0.09f + rho * 0.01f;
+    float ms1 = (1 - rho) * 0.16f + rho * 0.04f;
+    ASSERT_NEAR(p->ptr[0], 1.0f - lr * 0.3f / ::sqrtf(ms0 + eps), 1e-6f);
+    ASSERT_NEAR(p->ptr[1], 2.0f + lr * 0.4f / ::sqrtf(ms1 + eps), 1e-6f);
+    ASSERT_FLOAT_EQ(g1->ptr[0], 0.3f);
+    ASSERT_FLOAT_EQ(g1->ptr[1], -0.4f);
+}
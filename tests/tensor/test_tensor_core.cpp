@@ -88,3 +88,80 @@ TEST(TensorTestSuite, tensor_math_argsort) {
 }
 
 
+
+
+// Reference permute, element by element
+static Tensor *naive_permute(Tensor *A, const vector<int> &dims) {
+    vector<int> oshape;
+    for (int d : dims) oshape.push_back(A->shape[d]);
+    Tensor *B = new Tensor(oshape);
+    vector<int> idx(A->ndim);
+    for (int i = 0; i < A->size; i++) {
+        int r = i;
+        for (int k = A->ndim - 1; k >= 0; k--) { idx[k] = r % A->shape[k]; r /= A->shape[k]; }
+        int o = 0;
+        for (int k = 0; k < dims.size(); k++) o = o * oshape[k] + idx[dims[k]];
+        B->ptr[o] = A->ptr[i];
+    }
+    return B;
+}
+
+
+TEST(TensorTestSuite, tensor_permute) {
+    vector<pair<vector<int>, vector<int>>> cases = {
+            {{19, 37}, {1, 0}},
+            {{64, 72}, {1, 0}},
+            {{5, 7, 3}, {1, 0, 2}},
+            {{4, 1, 9, 11}, {0, 3, 2, 1}},
+            {{3, 4, 5, 6}, {2, 3, 0, 1}},
+            {{3, 4, 5, 6}, {3, 1, 0, 2}},
+            {{2, 3, 17, 13}, {0, 2, 1, 3}},
+            {{1, 1, 5}, {2, 1, 0}},
+            {{6, 5, 4}, {0, 1, 2}},
+    };
+
+    for (auto &c : cases) {
+        Tensor *A = Tensor::randn(c.first);
+        Tensor *ref = naive_permute(A, c.second);
+
+        Tensor *B = Tensor::permute(A, c.second);
+        ASSERT_EQ(B->shape, ref->shape);
+        ASSERT_TRUE(Tensor::equivalent(B, ref, 0.0f, 0.0f));
+
+        // In-place variant replaces shape, strides and data
+        A->permute_(c.second);
+        ASSERT_EQ(A->shape, ref->shape);
+        ASSERT_EQ(A->stride, ref->stride);
+        ASSERT_TRUE(Tensor::equivalent(A, ref, 0.0f, 0.0f));
+
+        delete A;
+        delete B;
+        delete ref;
+    }
+
+    ASSERT_ANY_THROW(Tensor::permute(Tensor::zeros({2, 3}), {0, 0}));
+}
+
+
+TEST(TensorTestSuite, tensor_moveaxis_swapaxis) {
+    Tensor *A = Tensor::randn({2, 3, 4, 5});
+
+    Tensor *ref = naive_permute(A, {0, 2, 3, 1});
+    Tensor *B = A->clone();
+    B->moveaxis_(1, -1);
+    ASSERT_EQ(B->shape, vector<int>({2, 4, 5, 3}));
+    ASSERT_TRUE(Tensor::equivalent(B, ref, 0.0f, 0.0f));
+    delete B;
+    delete ref;
+
+    ref = naive_permute(A, {3, 1, 2, 0});
+    B = Tensor::swapaxis(A, 0, -1);
+    ASSERT_TRUE(Tensor::equivalent(B, ref, 0.0f, 0.0f));
+    A->swapaxis_(-1, 0);
+    ASSERT_EQ(A->shape, vector<int>({5, 3, 4, 2}));
+    ASSERT_TRUE(Tensor::equivalent(A, ref, 0.0f, 0.0f));
+
+    delete A;
+    delete B;
+    delete ref;
+}
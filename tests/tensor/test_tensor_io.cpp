@@ -336,4 +336,36 @@ TEST(TensorTestSuite, tensor_io_bin)
     if(hasFailed) { cout << "Error deleting file: " << fname << endl; }
 
     ASSERT_TRUE(Tensor::equivalent(t_iris, t_load, 10e-5));
-}
\ No newline at end of file
+}
+
+TEST(TensorTestSuite, tensor_io_bin_mmap)
+{
+    // Generate random name
+    int rdn_name = dist6(mt);
+    string fname = "iris_" + to_string(rdn_name) + ".bin";
+
+    // Save file
+    t_iris->save(fname);
+
+    // Map saved file
+    Tensor* t_load = Tensor::load_mmap(fname);
+
+    // The mapping outlives the file name
+    int hasFailed = std::remove(fname.c_str());
+    if(hasFailed) { cout << "Error deleting file: " << fname << endl; }
+
+    ASSERT_TRUE(Tensor::equivalent(t_iris, t_load, 10e-5));
+
+    // Batches are gathered straight from the mapping
+    Tensor* t_batch = new Tensor({3, 4}, DEV_CPU);
+    Tensor::select(t_load, t_batch, {149, 0, 75}, 0, 3);
+    ASSERT_FLOAT_EQ(t_batch->ptr[0], 5.90f);
+    ASSERT_FLOAT_EQ(t_batch->ptr[4], 5.10f);
+
+    // Private writes
+    t_load->mult_(2.0f);
+    ASSERT_FLOAT_EQ(t_load->ptr[0], 10.20f);
+
+    delete t_batch;
+    delete t_load;
+}
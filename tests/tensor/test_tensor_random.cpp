@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include <cmath>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "eddl/tensor/tensor.h"
+#include "eddl/random.h"
+#include "eddl/apis/eddl.h"
+
+using namespace std;
+
+
+TEST(TensorTestSuite, random_reproducible)
+{
+    set_rand_seed(1234);
+    Tensor *a = Tensor::randn({1001});
+    Tensor *u = Tensor::randu({77});
+
+    // Same seed, same values, whatever the number of threads
+#ifdef _OPENMP
+    int th = omp_get_max_threads();
+    omp_set_num_threads(3);
+#endif
+    set_rand_seed(1234);
+    Tensor *b = Tensor::randn({1001});
+    Tensor *v = Tensor::randu({77});
+#ifdef _OPENMP
+    omp_set_num_threads(th);
+#endif
+    ASSERT_TRUE(Tensor::equivalent(a, b, 0.0f, 0.0f));
+    ASSERT_TRUE(Tensor::equivalent(u, v, 0.0f, 0.0f));
+
+    // Bulk and scalar draws agree on the counters
+    set_rand_seed(7);
+    uint64_t ctr = reserve_rand(0);
+    Tensor *w = Tensor::randu({10});
+    for (int i = 0; i < 10; i++) ASSERT_EQ(w->ptr[i], uniform_at(ctr + i));
+
+    // A new stream after the seed
+    Tensor *c = Tensor::randn({1001});
+    ASSERT_FALSE(Tensor::equivalent(a, c, 1e-3f, 0.0f));
+
+    delete a; delete b; delete c;
+    delete u; delete v; delete w;
+}
+
+
+TEST(TensorTestSuite, random_distributions)
+{
+    set_rand_seed(99);
+    int n = 200000;
+
+    Tensor *g = Tensor::randn({n});
+    double m = 0.0, s = 0.0;
+    for (int i = 0; i < n; i++) m += g->ptr[i];
+    m /= n;
+    for (int i = 0; i < n; i++) s += (g->ptr[i] - m) * (g->ptr[i] - m);
+    s = std::sqrt(s / n);
+    ASSERT_NEAR(m, 0.0, 0.01);
+    ASSERT_NEAR(s, 1.0, 0.01);
+
+    Tensor *u = Tensor::randu({n});
+    ASSERT_GE(u->min(), 0.0f);
+    ASSERT_LT(u->max(), 1.0f);
+    ASSERT_NEAR(u->sum() / n, 0.5, 0.01);
+
+    Tensor *d = new Tensor({n});
+    d->rand_binary(0.3f);
+    ASSERT_NEAR(d->sum() / n, 0.3, 0.01);
+
+    delete g;
+    delete u;
+    delete d;
+}
+
+
+TEST(TensorTestSuite, random_seeded_build)
+{
+    vector<float> w[2];
+    for (int k = 0; k < 2; k++) {
+        eddl::layer in = eddl::Input({5});
+        eddl::layer out = eddl::Dense(in, 4);
+        eddl::model net = eddl::Model({in}, {out});
+        eddl::compserv cs = eddl::CS_CPU(1);
+        cs->seed = 42;
+        eddl::build(net, eddl::sgd(0.01f), {"mse"}, {"mse"}, cs, true);
+
+        Tensor *p = net->snets[0]->layers[1]->params[0];
+        w[k].assign(p->ptr, p->ptr + p->size);
+        delete net;
+    }
+    ASSERT_EQ(w[0], w[1]);
+}
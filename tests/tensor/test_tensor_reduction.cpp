@@ -472,4 +472,112 @@ TEST(TensorTestSuite, tensor_math_reduction_median) {
 
     ASSERT_TRUE(Tensor::equivalent(t_cpu_median, t_gpu_median, 10e-4));
 #endif
-}
\ No newline at end of file
+}
+
+// Reference reduction: mode 0 mean, 1 sum, 2 max, 3 min, 4 variance
+static vector<float> naive_reduce(Tensor *A, const vector<int> &axis, int mode) {
+    vector<int> keep;
+    for (int i = 0; i < A->ndim; i++)
+        if (find(axis.begin(), axis.end(), i) == axis.end()) keep.push_back(i);
+    int nout = 1;
+    for (int k : keep) nout *= A->shape[k];
+
+    vector<vector<double>> groups(nout);
+    for (int i = 0; i < A->size; i++) {
+        int o = 0;
+        for (int k : keep) o = o * A->shape[k] + (i / A->stride[k]) % A->shape[k];
+        groups[o].push_back(A->ptr[i]);
+    }
+
+    vector<float> r;
+    for (auto &g : groups) {
+        double s = 0.0, mx = g[0], mn = g[0];
+        for (double v : g) { s += v; mx = std::max(mx, v); mn = std::min(mn, v); }
+        double m = s / g.size(), var = 0.0;
+        for (double v : g) var += (v - m) * (v - m);
+        double res[5] = {m, s, mx, mn, var / g.size()};
+        r.push_back((float) res[mode]);
+    }
+    return r;
+}
+
+
+TEST(TensorTestSuite, tensor_reduce_axis_patterns) {
+    vector<pair<vector<int>, vector<int>>> cases = {
+            {{6, 300}, {1}},        // inner
+            {{300, 6}, {0}},        // outer
+            {{4, 5, 3, 7}, {1, 3}}, // strided
+            {{4, 5, 3, 7}, {0, 2}},
+            {{3, 1, 11, 2}, {1, 2}},
+            {{2, 9, 13}, {0, 1}},
+    };
+
+    for (auto &c : cases) {
+        Tensor *A = Tensor::randn(c.first);
+        vector<int> oshape;
+        for (int i = 0; i < A->ndim; i++)
+            if (find(c.second.begin(), c.second.end(), i) == c.second.end()) oshape.push_back(A->shape[i]);
+        Tensor *B = new Tensor(oshape);
+
+        vector<string> modes = {"mean", "sum", "max", "min", "variance"};
+        for (int m = 0; m < modes.size(); m++) {
+            reduce(A, B, modes[m], c.second);
+            vector<float> ref = naive_reduce(A, c.second, m);
+            for (int i = 0; i < B->size; i++) ASSERT_NEAR(B->ptr[i], ref[i], 1e-4f * (1.0f + std::fabs(ref[i])));
+        }
+
+        // Accumulation ops
+        vector<float> ref = naive_reduce(A, c.second, 1);
+        B->fill_(1.0f);
+        reduce_diff(A, B, c.second);
+        for (int i = 0; i < B->size; i++) ASSERT_NEAR(B->ptr[i], 1.0f - ref[i], 1e-4f * (1.0f + std::fabs(ref[i])));
+
+        delete A;
+        delete B;
+    }
+
+    ASSERT_ANY_THROW(reduce(Tensor::zeros({2, 3}), Tensor::zeros({2}), "median", {1}));
+}
+
+
+TEST(TensorTestSuite, tensor_reduction_descriptor_keepdims) {
+    Tensor *A = Tensor::randn({3, 4, 5});
+    for (bool keepdims : {false, true}) {
+        for (string mode : {"mean", "sum", "max", "min"}) {
+            auto *RD = new ReduceDescriptor(A, {1}, mode, keepdims);
+            int m = RD->m;
+            reduction(RD);
+
+            vector<float> ref = naive_reduce(A, {1}, m);
+            for (int b = 0; b < 3; b++)
+                for (int j = 0; j < 4; j++)
+                    for (int k = 0; k < 5; k++) {
+                        int o = b * 5 + k;
+                        float v = keepdims ? RD->O->ptr[(b * 4 + j) * 5 + k] : RD->O->ptr[o];
+                        ASSERT_NEAR(v, ref[o], 1e-5f);
+                    }
+
+            // Backward: every input gets the delta of its output
+            RD->D = Tensor::ones(RD->O->shape);
+            RD->ID = Tensor::zeros(A->shape);
+            reduction_back(RD);
+            float total = 0.0f;
+            for (int i = 0; i < A->size; i++) total += RD->ID->ptr[i];
+            float expect = (m == REDUCE_SUM) ? A->size : 15.0f;
+            if (keepdims) expect *= 4.0f;
+            ASSERT_NEAR(total, expect, 1e-4f);
+            if (m >= REDUCE_MAX)
+                for (int o = 0; o < 15; o++) {
+                    int idx = keepdims ? (int) RD->S->ptr[(o / 5) * 20 + o % 5] : (int) RD->S->ptr[o];
+                    ASSERT_EQ(A->ptr[idx], ref[o]);
+                }
+
+            delete RD->D;
+            delete RD->ID;
+            delete RD->O;
+            delete RD->S;
+            delete RD;
+        }
+    }
+    delete A;
+}